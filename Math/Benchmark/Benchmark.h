@@ -0,0 +1,236 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#if defined(_MSC_VER) && !defined(__clang__)
+	#include <intrin.h>
+#endif
+
+namespace math
+{
+	namespace benchmark
+	{
+		// What a benchmark function sees: run the measured work iterations times, each iteration processing items elements.
+		struct State
+		{
+			size_t iterations = 1;
+			size_t items = 1;
+		};
+
+		using Function = void (*)(State&);
+
+		// Keeps value alive and opaque: the compiler must assume it is read and modified here.
+		template<typename T>
+		inline void do_not_optimize(T& value)
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			static volatile const void* sink;
+			sink = &value;
+			_ReadWriteBarrier();
+#else
+			asm volatile("" : "+m"(value) : : "memory");
+#endif
+		}
+		inline void clobber_memory()
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			_ReadWriteBarrier();
+#else
+			asm volatile("" : : : "memory");
+#endif
+		}
+
+		template<typename T>
+		static constexpr const char* type_name()
+		{
+			if constexpr (std::is_same_v<T, int>)
+				return "int";
+			else if constexpr (std::is_same_v<T, float>)
+				return "float";
+			else if constexpr (std::is_same_v<T, double>)
+				return "double";
+			else if constexpr (std::is_same_v<T, long double>)
+				return "long double";
+			else
+				return "?";
+		}
+
+		// Latency: one operation per iteration on operands that are reloaded and escaped around it, so nothing is hoisted.
+		// Op is constructed from an element index and called without arguments.
+		template<typename Op>
+		static void latency(State& state)
+		{
+			Op op(0);
+			for (size_t i = 0; i < state.iterations; ++i)
+			{
+				do_not_optimize(op);
+				auto result = op();
+				do_not_optimize(result);
+			}
+		}
+		// Throughput: the operation over N independent elements per iteration, reported per element.
+		template<typename Op, size_t N = 1024>
+		static void throughput(State& state)
+		{
+			using result_type = decltype(std::declval<Op&>()());
+			std::vector<Op> ops;
+			ops.reserve(N);
+			for (size_t i = 0; i < N; ++i)
+				ops.emplace_back(i);
+			const std::unique_ptr<result_type[]> results(new result_type[N]);
+			state.items = N;
+			for (size_t i = 0; i < state.iterations; ++i)
+			{
+				clobber_memory();
+				for (size_t j = 0; j < N; ++j)
+					results[j] = ops[j]();
+				clobber_memory();
+			}
+		}
+
+		// Runs every registered function long enough to time it and reports ns per iteration on stdout.
+		// --filter=text runs only benchmarks whose name contains text, --min_time=seconds sets the time per benchmark and
+		// --json=path also writes the results in Google Benchmark's JSON layout, so its compare tooling can diff two runs.
+		class Registry
+		{
+		public:
+			void add(std::string name, Function function) { cases.push_back({ std::move(name), function }); }
+
+			int run(int argc, char** argv) const
+			{
+				std::string_view filter;
+				std::string_view json;
+				double min_time = 0.1;
+				for (int i = 1; i < argc; ++i)
+				{
+					const std::string_view argument = argv[i];
+					if (argument.starts_with("--filter="))
+						filter = argument.substr(9);
+					else if (argument.starts_with("--json="))
+						json = argument.substr(7);
+					else if (argument.starts_with("--min_time="))
+						min_time = std::strtod(argv[i] + 11, nullptr);
+					else
+					{
+						std::fprintf(stderr, "usage: %s [--filter=text] [--min_time=seconds] [--json=path]\n", argv[0]);
+						return 1;
+					}
+				}
+
+				std::vector<Result> results;
+				std::printf("%-56s %14s %14s %12s %16s\n", "Benchmark", "Time", "CPU", "Iterations", "Items/s");
+				for (const Case& benchmark : cases)
+				{
+					if (benchmark.name.find(filter) == std::string::npos)
+						continue;
+					const Result result = measure(benchmark, min_time);
+					std::printf("%-56s %11.2f ns %11.2f ns %12zu %16.4g\n", result.name.c_str(), result.real_time, result.cpu_time, result.iterations, result.items_per_second);
+					std::fflush(stdout);
+					results.push_back(result);
+				}
+
+				if (!json.empty() && !write_json(std::string(json), argv[0], results))
+				{
+					std::fprintf(stderr, "could not write %s\n", std::string(json).c_str());
+					return 1;
+				}
+				return 0;
+			}
+
+		private:
+			struct Case
+			{
+				std::string name;
+				Function function;
+			};
+			struct Result
+			{
+				std::string name;
+				size_t iterations;
+				double real_time;
+				double cpu_time;
+				double items_per_second;
+			};
+
+			// Grows the iteration count until one run takes min_time, then reports that run.
+			// A first call with no iterations is not timed, so fixtures built lazily on first use are not counted.
+			static Result measure(const Case& benchmark, double min_time)
+			{
+				State state{ 0 };
+				benchmark.function(state);
+				state.iterations = 1;
+				while (true)
+				{
+					const std::clock_t cpu_start = std::clock();
+					const auto start = std::chrono::steady_clock::now();
+					benchmark.function(state);
+					const double real = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+					const double cpu = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+					if (real >= min_time || state.iterations >= size_t(1) << 40)
+					{
+						const double iterations = double(state.iterations);
+						return { benchmark.name, state.iterations, real * 1e9 / iterations, cpu * 1e9 / iterations, iterations * double(state.items) / real };
+					}
+					const double factor = real > 0 ? std::clamp(min_time * 1.4 / real, 2.0, 10.0) : 10.0;
+					state.iterations = size_t(double(state.iterations) * factor);
+				}
+			}
+
+			static bool write_json(const std::string& path, const char* executable, const std::vector<Result>& results)
+			{
+				const std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "w"), &std::fclose);
+				if (!file)
+					return false;
+
+				char date[32];
+				const std::time_t now = std::time(nullptr);
+				std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+#if defined(NDEBUG)
+				constexpr const char* build = "release";
+#else
+				constexpr const char* build = "debug";
+#endif
+				std::fprintf(file.get(), "{\n  \"context\": {\n    \"date\": \"%s\",\n    \"executable\": \"%s\",\n    \"num_cpus\": %u,\n    \"library_build_type\": \"%s\"\n  },\n  \"benchmarks\": [",
+					date, escape(executable).c_str(), std::thread::hardware_concurrency(), build);
+				for (size_t i = 0; i < results.size(); ++i)
+				{
+					const Result& result = results[i];
+					const std::string name = escape(result.name.c_str());
+					std::fprintf(file.get(), "%s\n    {\n      \"name\": \"%s\",\n      \"run_name\": \"%s\",\n      \"run_type\": \"iteration\",\n      \"iterations\": %zu,\n      \"real_time\": %.6g,\n      \"cpu_time\": %.6g,\n      \"time_unit\": \"ns\",\n      \"items_per_second\": %.6g\n    }",
+						i ? "," : "", name.c_str(), name.c_str(), result.iterations, result.real_time, result.cpu_time, result.items_per_second);
+				}
+				std::fprintf(file.get(), "\n  ]\n}\n");
+				return std::ferror(file.get()) == 0;
+			}
+
+			static std::string escape(const char* text)
+			{
+				std::string out;
+				for (; *text; ++text)
+				{
+					if (*text == '"' || *text == '\\')
+						out += '\\';
+					out += *text;
+				}
+				return out;
+			}
+
+			std::vector<Case> cases;
+		};
+
+		void register_tuple_benchmarks(Registry& registry);
+		void register_angle_benchmarks(Registry& registry);
+		void register_spatial_benchmarks(Registry& registry);
+		void register_expression_benchmarks(Registry& registry);
+		void register_storage_benchmarks(Registry& registry);
+	}
+}
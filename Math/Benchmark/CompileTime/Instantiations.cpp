@@ -0,0 +1,45 @@
+// Compile-time benchmark: instantiates the tuple and vector operations for every dimension from 2 to 16 and five
+// component types, as a TU using many combinations does. Build the math_compile_time target with MATH_TIME_TRACE on
+// to get -ftime-trace (Clang) or -ftime-report (GCC) output; the number of distinct template functions it emits is
+// what the per-component recursion multiplied, e.g. nm -C Instantiations.cpp.o | grep -c "math::detail::".
+#include <cstdint>
+#include <utility>
+#include "Vector.h"
+#include "Point.h"
+#include "TupleOperations.h"
+
+namespace math
+{
+	namespace compile_time
+	{
+		template<size_t D, typename T>
+		T exercise(const Vector<D, T>& a, const Vector<D, T>& b, const Point<D, T>& p, const Point<D, T>& q)
+		{
+			Vector<D, T> v = a + b - a * T(2) + b / T(3);
+			v += a;
+			v -= b;
+			v *= T(2);
+			v /= T(4);
+			v = fma(v, a, b);
+			v = fma(v, T(3), a);
+			const Point<D, double> converted = tuple_cast<Point<D, double>>(p);
+			T result = dot(v, a) + a.magnitude_sq() + distance_sq(p, q) + static_cast<T>(converted.template get_component<0>());
+			if constexpr (std::is_floating_point_v<T>)
+				result += v.normalised().length() + distance(p, q);
+			return result + static_cast<T>(a == b) + static_cast<T>(p != q);
+		}
+
+		template<typename T, size_t... D>
+		T exercise_dimensions(std::index_sequence<D...>)
+		{
+			return (exercise<D + 2, T>(Vector<D + 2, T>(T(1)), Vector<D + 2, T>(T(2)), Point<D + 2, T>(T(3)), Point<D + 2, T>(T(4))) + ...);
+		}
+	}
+}
+
+double instantiate_all()
+{
+	using namespace math::compile_time;
+	using dimensions = std::make_index_sequence<15>;
+	return exercise_dimensions<float>(dimensions()) + exercise_dimensions<double>(dimensions()) + exercise_dimensions<int32_t>(dimensions()) + exercise_dimensions<int16_t>(dimensions()) + exercise_dimensions<long double>(dimensions());
+}
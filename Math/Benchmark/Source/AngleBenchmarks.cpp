@@ -0,0 +1,102 @@
+#include "Benchmark.h"
+#include "Angle.h"
+#include <vector>
+
+namespace math
+{
+	namespace benchmark
+	{
+		namespace
+		{
+			template<template<typename> typename From, template<typename> typename To, typename T>
+			struct AngleConversion
+			{
+				From<T> angle;
+				AngleConversion(size_t i) : angle(static_cast<T>(i % 360)) {}
+				T operator() () const { return To<T>(angle).native(); }
+			};
+
+			template<template<typename> typename From, template<typename> typename To, typename T>
+			void add(Registry& registry, const char* name)
+			{
+				// Radians only exists for floating point types.
+				if constexpr (requires { typename From<T>; typename To<T>; })
+				{
+					const std::string prefix = std::string("angle_conversion/") + name + '/' + type_name<T>();
+					registry.add(prefix + "/latency", &latency<AngleConversion<From, To, T>>);
+					registry.add(prefix + "/throughput", &throughput<AngleConversion<From, To, T>>);
+				}
+			}
+			// Headings spread over several turns either way.
+			template<size_t N>
+			std::vector<Degrees<float>> headings()
+			{
+				std::vector<Degrees<float>> headings;
+				headings.reserve(N);
+				for (size_t i = 0; i < N; ++i)
+					headings.emplace_back(static_cast<float>(i * 7919 % 4001) - 2000.0f);
+				return headings;
+			}
+			template<size_t N>
+			void angle_cast_span(State& state)
+			{
+				const std::vector<Degrees<float>> degrees = headings<N>();
+				std::vector<Radians<float>> radians(N);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					angle_cast(std::span<const Degrees<float>>(degrees), std::span<Radians<float>>(radians));
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void angle_cast_loop(State& state)
+			{
+				const std::vector<Degrees<float>> degrees = headings<N>();
+				std::vector<Radians<float>> radians(N);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					for (size_t j = 0; j < N; ++j)
+						radians[j] = Radians<float>(degrees[j]);
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void wrap_signed_span(State& state)
+			{
+				const std::vector<Degrees<float>> degrees = headings<N>();
+				std::vector<Degrees<float>> wrapped(N);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					wrap_signed(std::span<const Degrees<float>>(degrees), std::span<Degrees<float>>(wrapped));
+					clobber_memory();
+				}
+				state.items = N;
+			}
+
+			template<template<typename> typename From, template<typename> typename To>
+			void add_types(Registry& registry, const char* name)
+			{
+				add<From, To, int>(registry, name);
+				add<From, To, float>(registry, name);
+				add<From, To, double>(registry, name);
+				add<From, To, long double>(registry, name);
+			}
+		}
+
+		void register_angle_benchmarks(Registry& registry)
+		{
+			add_types<Radians, Degrees>(registry, "radians_to_degrees");
+			add_types<Radians, PiFactor>(registry, "radians_to_pi_factor");
+			add_types<Degrees, Radians>(registry, "degrees_to_radians");
+			add_types<Degrees, PiFactor>(registry, "degrees_to_pi_factor");
+			add_types<PiFactor, Radians>(registry, "pi_factor_to_radians");
+			add_types<PiFactor, Degrees>(registry, "pi_factor_to_degrees");
+
+			registry.add("angle_cast/degrees_to_radians/span/4096", &angle_cast_span<4096>);
+			registry.add("angle_cast/degrees_to_radians/loop/4096", &angle_cast_loop<4096>);
+			registry.add("wrap_signed/degrees/span/4096", &wrap_signed_span<4096>);
+		}
+	}
+}
@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+#include "Expression.h"
+
+namespace math
+{
+	namespace benchmark
+	{
+		namespace
+		{
+			// One explicit Euler step, x += v dt + a dt^2 / 2, over N points in SoA layout.
+			template<size_t N>
+			struct Integrator
+			{
+				CoordinatesSoA<3, float> positions{ N, Coordinates<3, float>(1.0f, 2.0f, 3.0f) };
+				CoordinatesSoA<3, float> velocities{ N, Coordinates<3, float>(0.5f, -0.25f, 0.125f) };
+				CoordinatesSoA<3, float> accelerations{ N, Coordinates<3, float>(0.0f, -9.81f, 0.0f) };
+				static constexpr float dt = 1.0f / 60.0f;
+			};
+
+			template<size_t N>
+			void integrate_eager(State& state)
+			{
+				Integrator<N> system;
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					system.positions = system.positions + system.velocities * system.dt + system.accelerations * (system.dt * system.dt / 2);
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void integrate_lazy(State& state)
+			{
+				Integrator<N> system;
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					assign(system.positions, lazy(system.positions) + lazy(system.velocities) * system.dt + lazy(system.accelerations) * (system.dt * system.dt / 2));
+					clobber_memory();
+				}
+				state.items = N;
+			}
+
+			template<size_t N>
+			void add(Registry& registry)
+			{
+				const std::string size = '/' + std::to_string(N);
+				registry.add("integrate_eager" + size, &integrate_eager<N>);
+				registry.add("integrate_lazy" + size, &integrate_lazy<N>);
+			}
+		}
+
+		// Temporaries against one fused pass for the same arithmetic.
+		void register_expression_benchmarks(Registry& registry)
+		{
+			add<1024>(registry);
+			add<1048576>(registry);
+		}
+	}
+}
@@ -0,0 +1,14 @@
+#include "Benchmark.h"
+
+using namespace math::benchmark;
+
+int main(int argc, char** argv)
+{
+	Registry registry;
+	register_tuple_benchmarks(registry);
+	register_angle_benchmarks(registry);
+	register_spatial_benchmarks(registry);
+	register_expression_benchmarks(registry);
+	register_storage_benchmarks(registry);
+	return registry.run(argc, argv);
+}
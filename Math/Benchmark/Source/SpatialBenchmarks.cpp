@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <random>
+#include "Benchmark.h"
+#include "KdTree.h"
+#include "AABB.h"
+#include "Triangle.h"
+#include "Sphere.h"
+#include "Bulk.h"
+#include "DynamicVector.h"
+
+namespace math
+{
+	namespace benchmark
+	{
+		namespace
+		{
+			constexpr size_t queries = 256;
+
+			template<size_t N>
+			const std::vector<Point<3, float>>& cloud()
+			{
+				static const std::vector<Point<3, float>> points = []
+				{
+					std::mt19937 generator(N);
+					std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+					std::vector<Point<3, float>> points;
+					points.reserve(N);
+					for (size_t i = 0; i < N; ++i)
+						points.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+					return points;
+				}();
+				return points;
+			}
+			const std::vector<Point<3, float>>& query_points()
+			{
+				return cloud<queries>();
+			}
+
+			template<size_t N>
+			void kd_tree_build(State& state)
+			{
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					KdTree<3, float> tree{ std::span<const Point<3, float>>(cloud<N>()) };
+					do_not_optimize(tree);
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void kd_tree_nearest(State& state)
+			{
+				static const KdTree<3, float> tree{ std::span<const Point<3, float>>(cloud<N>()) };
+				for (size_t i = 0; i < state.iterations; ++i)
+					for (const Point<3, float>& query : query_points())
+					{
+						auto nearest = tree.nearest(query);
+						do_not_optimize(nearest);
+					}
+				state.items = queries;
+			}
+			template<size_t N>
+			void brute_force_nearest(State& state)
+			{
+				const std::vector<Point<3, float>>& points = cloud<N>();
+				for (size_t i = 0; i < state.iterations; ++i)
+					for (const Point<3, float>& query : query_points())
+					{
+						float best = std::numeric_limits<float>::max();
+						for (const Point<3, float>& point : points)
+						{
+							const float distance = distance_sq(point, query);
+							best = distance < best ? distance : best;
+						}
+						do_not_optimize(best);
+					}
+				state.items = queries;
+			}
+
+			// Unit boxes cornered at the cloud points.
+			template<size_t N>
+			const std::vector<AABB<3, float>>& boxes()
+			{
+				static const std::vector<AABB<3, float>> boxes = []
+				{
+					std::vector<AABB<3, float>> boxes;
+					boxes.reserve(N);
+					for (const Point<3, float>& point : cloud<N>())
+						boxes.emplace_back(point, Point<3, float>(point.get_component<0>() + 1.0f, point.get_component<1>() + 1.0f, point.get_component<2>() + 1.0f));
+					return boxes;
+				}();
+				return boxes;
+			}
+			template<size_t N>
+			void aabb_overlapping(State& state)
+			{
+				const AABB<3, float> box(Point<3, float>(-10.0f, -10.0f, -10.0f), Point<3, float>(10.0f, 10.0f, 10.0f));
+				std::vector<size_t> hits;
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					hits.clear();
+					overlapping(std::span<const AABB<3, float>>(boxes<N>()), box, hits);
+					do_not_optimize(hits);
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void aabb_overlapping_scalar(State& state)
+			{
+				const AABB<3, float> box(Point<3, float>(-10.0f, -10.0f, -10.0f), Point<3, float>(10.0f, 10.0f, 10.0f));
+				std::vector<size_t> hits;
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					hits.clear();
+					for (size_t b = 0; b < N; ++b)
+						if (boxes<N>()[b].overlaps(box))
+							hits.push_back(b);
+					do_not_optimize(hits);
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void aabb_intersecting(State& state)
+			{
+				const Point<3, float> origin(-100.0f, -50.0f, -25.0f);
+				const Vector<3, float> inverse_direction(1.0f / 200.0f, 1.0f / 100.0f, 1.0f / 50.0f);
+				std::vector<size_t> hits;
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					hits.clear();
+					intersecting(std::span<const AABB<3, float>>(boxes<N>()), origin, inverse_direction, 0.0f, 1.0f, hits);
+					do_not_optimize(hits);
+				}
+				state.items = N;
+			}
+
+			// A fan of rays down the z axis against a field of small triangles and spheres in front of them.
+			constexpr size_t rays = 1024;
+			const std::vector<Ray<3, float>>& ray_fan()
+			{
+				static const std::vector<Ray<3, float>> fan = []
+				{
+					std::vector<Ray<3, float>> fan;
+					fan.reserve(rays);
+					for (size_t i = 0; i < rays; ++i)
+						fan.emplace_back(Point<3, float>(0.0f, 0.0f, -200.0f), Vector<3, float>(static_cast<float>(i % 32) / 32 - 0.5f, static_cast<float>(i / 32) / 32 - 0.5f, 1.0f));
+					return fan;
+				}();
+				return fan;
+			}
+			const std::vector<Triangle<float>>& triangles()
+			{
+				static const std::vector<Triangle<float>> triangles = []
+				{
+					std::vector<Triangle<float>> triangles;
+					for (const Point<3, float>& point : cloud<64>())
+						triangles.emplace_back(point, Point<3, float>(point.get_component<0>() + 10.0f, point.get_component<1>(), point.get_component<2>()), Point<3, float>(point.get_component<0>(), point.get_component<1>() + 10.0f, point.get_component<2>()));
+					return triangles;
+				}();
+				return triangles;
+			}
+			const std::vector<Sphere<3, float>>& spheres()
+			{
+				static const std::vector<Sphere<3, float>> spheres = []
+				{
+					std::vector<Sphere<3, float>> spheres;
+					for (const Point<3, float>& point : cloud<64>())
+						spheres.emplace_back(point, 5.0f);
+					return spheres;
+				}();
+				return spheres;
+			}
+
+			// Closest hit of every ray against every shape, one ray at a time or a packet of N at a time.
+			template<typename S>
+			void trace_rays(State& state, const std::vector<S>& shapes)
+			{
+				for (size_t i = 0; i < state.iterations; ++i)
+					for (const Ray<3, float>& ray : ray_fan())
+					{
+						float distance = std::numeric_limits<float>::infinity();
+						for (const S& shape : shapes)
+							intersect(ray, shape, distance);
+						do_not_optimize(distance);
+					}
+				state.items = rays * shapes.size();
+			}
+			template<size_t N, typename S>
+			void trace_packets(State& state, const std::vector<S>& shapes)
+			{
+				std::vector<RayPacket<3, float, N>> packets;
+				for (size_t first = 0; first < rays; first += N)
+					packets.emplace_back(std::span<const Ray<3, float>>(ray_fan()).subspan(first, N));
+				for (size_t i = 0; i < state.iterations; ++i)
+					for (const RayPacket<3, float, N>& packet : packets)
+					{
+						float distance[N];
+						for (float& lane : distance)
+							lane = std::numeric_limits<float>::infinity();
+						for (const S& shape : shapes)
+							intersect(packet, shape, distance);
+						do_not_optimize(distance);
+					}
+				state.items = rays * shapes.size();
+			}
+			void ray_triangle(State& state) { trace_rays(state, triangles()); }
+			template<size_t N>
+			void ray_triangle_packet(State& state) { trace_packets<N>(state, triangles()); }
+			void ray_sphere(State& state) { trace_rays(state, spheres()); }
+			template<size_t N>
+			void ray_sphere_packet(State& state) { trace_packets<N>(state, spheres()); }
+
+			template<Accumulation A, size_t N>
+			void centroid(State& state)
+			{
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					auto center = bulk::centroid<A>(std::span<const Point<3, float>>(cloud<N>()));
+					do_not_optimize(center);
+				}
+				state.items = N;
+			}
+			// The cloud in double, summed naively: what the float accumulation modes compete with.
+			template<size_t N>
+			void centroid_double(State& state)
+			{
+				static const std::vector<Point<3, double>> points = []
+				{
+					std::vector<Point<3, double>> points;
+					points.reserve(N);
+					for (const Point<3, float>& point : cloud<N>())
+						points.emplace_back(point.get_component<0>(), point.get_component<1>(), point.get_component<2>());
+					return points;
+				}();
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					auto center = bulk::centroid(std::span<const Point<3, double>>(points));
+					do_not_optimize(center);
+				}
+				state.items = N;
+			}
+
+			// N embeddings of 768 components, searched with one query: the batched row kernels against a dot per row.
+			constexpr size_t embedding_size = 768;
+
+			template<size_t N>
+			const std::vector<float>& embeddings()
+			{
+				static const std::vector<float> rows = []
+				{
+					std::mt19937 generator(N);
+					std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+					std::vector<float> rows(N * embedding_size);
+					for (float& component : rows)
+						component = distribution(generator);
+					return rows;
+				}();
+				return rows;
+			}
+			DynamicVector<float> embedding_query()
+			{
+				DynamicVector<float> query(embedding_size);
+				for (size_t i = 0; i < embedding_size; ++i)
+					query[i] = static_cast<float>(i % 13) / 13.0f - 0.5f;
+				return query;
+			}
+			template<size_t N, void (*Rows)(std::span<const float>, const DynamicVector<float>&, std::span<float>)>
+			void similarity(State& state)
+			{
+				const std::vector<float>& rows = embeddings<N>();
+				const DynamicVector<float> query = embedding_query();
+				std::vector<float> scores(N);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					Rows(std::span<const float>(rows), query, std::span<float>(scores));
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void similarity_per_row(State& state)
+			{
+				const std::vector<float>& rows = embeddings<N>();
+				const DynamicVector<float> query = embedding_query();
+				std::vector<float> scores(N);
+				DynamicVector<float> row(embedding_size);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					for (size_t r = 0; r < N; ++r)
+					{
+						std::copy_n(rows.data() + r * embedding_size, embedding_size, row.data());
+						scores[r] = dot(row, query);
+					}
+					clobber_memory();
+				}
+				state.items = N;
+			}
+
+			template<size_t N>
+			void add(Registry& registry)
+			{
+				const std::string size = '/' + std::to_string(N);
+				registry.add("kd_tree_build" + size, &kd_tree_build<N>);
+				registry.add("kd_tree_nearest" + size, &kd_tree_nearest<N>);
+				registry.add("brute_force_nearest" + size, &brute_force_nearest<N>);
+				registry.add("aabb_overlapping" + size, &aabb_overlapping<N>);
+				registry.add("aabb_overlapping_scalar" + size, &aabb_overlapping_scalar<N>);
+				registry.add("aabb_intersecting" + size, &aabb_intersecting<N>);
+				registry.add("centroid/naive" + size, &centroid<Accumulation::naive, N>);
+				registry.add("centroid/pairwise" + size, &centroid<Accumulation::pairwise, N>);
+				registry.add("centroid/compensated" + size, &centroid<Accumulation::compensated, N>);
+				registry.add("centroid/widened" + size, &centroid<Accumulation::widened, N>);
+				registry.add("centroid/double" + size, &centroid_double<N>);
+			}
+		}
+
+		// Nearest neighbour over Point<3, float> clouds: the k-d tree against the linear scan it replaces;
+		// broad-phase box tests over the same clouds, batched against one box at a time; and closest-hit ray casts,
+		// one ray at a time against packets; centroids of the clouds under each accumulation mode; and similarity search
+		// of one query against rows of embeddings.
+		void register_spatial_benchmarks(Registry& registry)
+		{
+			add<1000>(registry);
+			add<100000>(registry);
+
+			registry.add("ray_triangle", &ray_triangle);
+			registry.add("ray_triangle_packet/4", &ray_triangle_packet<4>);
+			registry.add("ray_triangle_packet/8", &ray_triangle_packet<8>);
+			registry.add("ray_triangle_packet/16", &ray_triangle_packet<16>);
+			registry.add("ray_sphere", &ray_sphere);
+			registry.add("ray_sphere_packet/4", &ray_sphere_packet<4>);
+			registry.add("ray_sphere_packet/8", &ray_sphere_packet<8>);
+			registry.add("ray_sphere_packet/16", &ray_sphere_packet<16>);
+
+			registry.add("dot_rows/768/10000", &similarity<10000, &dot_rows<float>>);
+			registry.add("distance_sq_rows/768/10000", &similarity<10000, &distance_sq_rows<float>>);
+			registry.add("cosine_similarity_rows/768/10000", &similarity<10000, &cosine_similarity_rows<float>>);
+			registry.add("dot_per_row/768/10000", &similarity_per_row<10000>);
+		}
+	}
+}
@@ -0,0 +1,250 @@
+#include "Benchmark.h"
+#include "Half.h"
+#include "Fixed.h"
+#include "Octahedral.h"
+#include "Vector.h"
+#include "Point.h"
+#include "TupleFile.h"
+#include "Text.h"
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace math
+{
+	namespace benchmark
+	{
+		namespace
+		{
+			template<typename U, size_t N>
+			struct Normals
+			{
+				std::vector<Vector<3, float>> normals;
+				std::vector<Vector<3, U>> packed;
+				std::vector<Vector<3, float>> unpacked;
+				Normals() : packed(N), unpacked(N)
+				{
+					normals.reserve(N);
+					for (size_t i = 0; i < N; ++i)
+						normals.emplace_back(static_cast<float>(i % 7) / 7, static_cast<float>(i % 5) / 5, static_cast<float>(i % 3) / 3);
+				}
+			};
+
+			template<typename U, size_t N>
+			void pack_normals(State& state)
+			{
+				Normals<U, N> data;
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					pack(std::span<const Vector<3, float>>(data.normals), std::span<Vector<3, U>>(data.packed));
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<typename U, size_t N>
+			void unpack_normals(State& state)
+			{
+				Normals<U, N> data;
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					unpack(std::span<const Vector<3, U>>(data.packed), std::span<Vector<3, float>>(data.unpacked));
+					clobber_memory();
+				}
+				state.items = N;
+			}
+
+			template<size_t Bits, Precision P, size_t N>
+			void encode_normals(State& state)
+			{
+				Normals<float, N> data;
+				std::vector<Octahedral<Bits>> encoded(N);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					encode<P>(std::span<const Vector<3, float>>(data.normals), std::span<Octahedral<Bits>>(encoded));
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<size_t Bits, size_t N>
+			void decode_normals(State& state)
+			{
+				Normals<float, N> data;
+				std::vector<Octahedral<Bits>> encoded(N);
+				encode(std::span<const Vector<3, float>>(data.normals), std::span<Octahedral<Bits>>(encoded));
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					decode(std::span<const Octahedral<Bits>>(encoded), std::span<Vector<3, float>>(data.unpacked));
+					clobber_memory();
+				}
+				state.items = N;
+			}
+
+			// Points are trivially copyable: copies are memmove and growing a vector moves the storage as bytes.
+			template<typename U, size_t N>
+			void copy_tuples(State& state)
+			{
+				std::vector<U> source(N, U(1)), destination(N);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					std::copy(source.begin(), source.end(), destination.begin());
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<typename U, size_t N>
+			void grow_tuples(State& state)
+			{
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					std::vector<U> tuples;
+					for (size_t j = 0; j < N; ++j)
+						tuples.push_back(U(static_cast<typename U::value_type>(j)));
+					do_not_optimize(tuples);
+				}
+				state.items = N;
+			}
+
+			// Writing a point cloud to a tuple file, and opening it again: mapping is independent of the size of the file.
+			template<TupleLayout L, size_t N>
+			void write_points(State& state)
+			{
+				const std::vector<Point<3, float>> points(N, Point<3, float>(1));
+				const std::filesystem::path path = std::filesystem::temp_directory_path() / "math_benchmark.mtup";
+				for (size_t i = 0; i < state.iterations; ++i)
+					write_tuple_file(path, points, L);
+				std::filesystem::remove(path);
+				state.items = N;
+			}
+			template<TupleLayout L, size_t N>
+			void map_points(State& state)
+			{
+				const std::vector<Point<3, float>> points(N, Point<3, float>(1));
+				const std::filesystem::path path = std::filesystem::temp_directory_path() / "math_benchmark.mtup";
+				write_tuple_file(path, points, L);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					TupleFileReader<3, float> reader(path);
+					size_t size = reader.size();
+					do_not_optimize(size);
+				}
+				std::filesystem::remove(path);
+				state.items = N;
+			}
+
+			// Whitespace-separated point data, one "x y z" line per point, as ingested from text files.
+			template<size_t N>
+			std::string point_text()
+			{
+				std::string text;
+				char buffer[64];
+				for (size_t i = 0; i < N; ++i)
+				{
+					const Point<3, float> point(static_cast<float>(i % 1000) * 0.125f, static_cast<float>(i % 777) * -1.5f, static_cast<float>(i) * 0.001f);
+					const std::to_chars_result result = to_chars(buffer, buffer + sizeof(buffer), point);
+					text.append(buffer, result.ptr);
+					text.push_back('\n');
+				}
+				return text;
+			}
+			template<size_t N>
+			void parse_points(State& state)
+			{
+				const std::string text = point_text<N>();
+				std::vector<Point<3, float>> points(N);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					tuples_from_chars(text.data(), text.data() + text.size(), std::span<Point<3, float>>(points));
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void parse_points_soa(State& state)
+			{
+				const std::string text = point_text<N>();
+				CoordinatesSoA<3, float> points;
+				points.reserve(N);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					points.clear();
+					tuples_from_chars(text.data(), text.data() + text.size(), points);
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void parse_points_istream(State& state)
+			{
+				const std::string text = point_text<N>();
+				std::vector<Point<3, float>> points(N);
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					std::istringstream stream(text);
+					for (Point<3, float>& point : points)
+						stream >> point.x >> point.y >> point.z;
+					clobber_memory();
+				}
+				state.items = N;
+			}
+			template<size_t N>
+			void format_points(State& state)
+			{
+				const std::string text = point_text<N>();
+				std::vector<Point<3, float>> points(N);
+				tuples_from_chars(text.data(), text.data() + text.size(), std::span<Point<3, float>>(points));
+				std::string out(text.size(), '\0');
+				for (size_t i = 0; i < state.iterations; ++i)
+				{
+					char* first = out.data();
+					char* const last = out.data() + out.size();
+					for (const Point<3, float>& point : points)
+					{
+						first = to_chars(first, last, point).ptr;
+						*first++ = '\n';
+					}
+					clobber_memory();
+				}
+				state.items = N;
+			}
+
+			template<size_t Bits>
+			void add_octahedral(Registry& registry)
+			{
+				const std::string type = "oct" + std::to_string(2 * Bits);
+				registry.add("encode/" + type + "/exact/1048576", &encode_normals<Bits, Precision::exact, 1048576>);
+				registry.add("encode/" + type + "/fast/1048576", &encode_normals<Bits, Precision::fast, 1048576>);
+				registry.add("decode/" + type + "/1048576", &decode_normals<Bits, 1048576>);
+			}
+
+			template<typename U>
+			void add(Registry& registry, const std::string& type)
+			{
+				registry.add("pack/" + type + "/1048576", &pack_normals<U, 1048576>);
+				registry.add("unpack/" + type + "/1048576", &unpack_normals<U, 1048576>);
+			}
+		}
+
+		// Converting float normals to and from the compact component types and the octahedral encodings, and copying
+		// and growing arrays of tuples, storing them in tuple files and reading and writing them as text.
+		void register_storage_benchmarks(Registry& registry)
+		{
+			add<Half>(registry, "half");
+			add<Fixed<2, 14>>(registry, "fixed_2_14");
+			add_octahedral<8>(registry);
+			add_octahedral<16>(registry);
+			registry.add("copy/point3f/1048576", &copy_tuples<Point<3, float>, 1048576>);
+			registry.add("copy/vector4d/1048576", &copy_tuples<Vector<4, double>, 1048576>);
+			registry.add("grow/point3f/1048576", &grow_tuples<Point<3, float>, 1048576>);
+			registry.add("grow/vector4d/1048576", &grow_tuples<Vector<4, double>, 1048576>);
+			registry.add("text/parse/point3f/1048576", &parse_points<1048576>);
+			registry.add("text/parse_soa/point3f/1048576", &parse_points_soa<1048576>);
+			registry.add("text/parse_istream/point3f/1048576", &parse_points_istream<1048576>);
+			registry.add("text/format/point3f/1048576", &format_points<1048576>);
+			registry.add("tuple_file/write/aos/point3f/1048576", &write_points<TupleLayout::aos, 1048576>);
+			registry.add("tuple_file/write/soa/point3f/1048576", &write_points<TupleLayout::soa, 1048576>);
+			registry.add("tuple_file/map/aos/point3f/1048576", &map_points<TupleLayout::aos, 1048576>);
+			registry.add("tuple_file/map/soa/point3f/1048576", &map_points<TupleLayout::soa, 1048576>);
+		}
+	}
+}
@@ -0,0 +1,239 @@
+#include "Benchmark.h"
+#include "Vector.h"
+#include "Point.h"
+#include "Angle.h"
+
+namespace math
+{
+	namespace benchmark
+	{
+		namespace
+		{
+			// Small non-zero components that differ per element and per component.
+			template<Tuple U, size_t C = 0>
+			void fill(U& tuple, size_t index)
+			{
+				tuple.template get_component<C>() = static_cast<typename U::value_type>((index * U::dimensions + C) % 7 + 1);
+				if constexpr (C < U::dimensions - 1)
+					fill<U, C + 1>(tuple, index);
+			}
+			template<Tuple U>
+			U make(size_t index)
+			{
+				U tuple;
+				fill(tuple, index);
+				return tuple;
+			}
+
+			template<size_t D, typename T>
+			struct TupleAdd
+			{
+				static constexpr const char* name = "tuple_add";
+				Coordinates<D, T> a, b;
+				TupleAdd(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i + 1)) {}
+				Coordinates<D, T> operator() () const { return a + b; }
+			};
+			template<size_t D, typename T>
+			struct TupleSubtract
+			{
+				static constexpr const char* name = "tuple_subtract";
+				Coordinates<D, T> a, b;
+				TupleSubtract(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i + 1)) {}
+				Coordinates<D, T> operator() () const { return a - b; }
+			};
+			template<size_t D, typename T>
+			struct TupleAddAssign
+			{
+				static constexpr const char* name = "tuple_add_assign";
+				Coordinates<D, T> a, b;
+				TupleAddAssign(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i + 1)) {}
+				Coordinates<D, T> operator() () { return a += b; }
+			};
+			template<size_t D, typename T>
+			struct TupleSubtractAssign
+			{
+				static constexpr const char* name = "tuple_subtract_assign";
+				Coordinates<D, T> a, b;
+				TupleSubtractAssign(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i + 1)) {}
+				Coordinates<D, T> operator() () { return a -= b; }
+			};
+			template<size_t D, typename T>
+			struct TupleScale
+			{
+				static constexpr const char* name = "tuple_scale";
+				Coordinates<D, T> a;
+				T scalar;
+				TupleScale(size_t i) : a(make<Coordinates<D, T>>(i)), scalar(static_cast<T>(i % 3 + 1)) {}
+				Coordinates<D, T> operator() () const { return a * scalar; }
+			};
+			template<size_t D, typename T>
+			struct TupleDivide
+			{
+				static constexpr const char* name = "tuple_divide";
+				Coordinates<D, T> a;
+				T scalar;
+				TupleDivide(size_t i) : a(make<Coordinates<D, T>>(i)), scalar(static_cast<T>(i % 3 + 1)) {}
+				Coordinates<D, T> operator() () const { return a / scalar; }
+			};
+			template<size_t D, typename T>
+			struct TupleFma
+			{
+				static constexpr const char* name = "tuple_fma";
+				Coordinates<D, T> a, b, c;
+				TupleFma(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i + 1)), c(make<Coordinates<D, T>>(i + 2)) {}
+				Coordinates<D, T> operator() () const { return fma(a, b, c); }
+			};
+			template<size_t D, typename T>
+			struct TupleAxpy
+			{
+				static constexpr const char* name = "tuple_axpy";
+				Coordinates<D, T> x, y;
+				T alpha;
+				TupleAxpy(size_t i) : x(make<Coordinates<D, T>>(i)), y(make<Coordinates<D, T>>(i + 1)), alpha(static_cast<T>(i % 3 + 1)) {}
+				Coordinates<D, T> operator() () const { return axpy(alpha, x, y); }
+			};
+			template<size_t D, typename T>
+			struct TupleEquals
+			{
+				static constexpr const char* name = "tuple_equals";
+				Coordinates<D, T> a, b;
+				TupleEquals(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i % 2 ? i : i + 1)) {}
+				int operator() () const { return a == b; }
+			};
+			template<size_t D, typename T>
+			struct CoordinatesCopy
+			{
+				static constexpr const char* name = "coordinates_copy";
+				Coordinates<D, T> a;
+				CoordinatesCopy(size_t i) : a(make<Coordinates<D, T>>(i)) {}
+				Coordinates<D, T> operator() () const
+				{
+					Coordinates<D, T> copy(a);
+					return copy;
+				}
+			};
+			template<size_t D, typename T>
+			struct CoordinatesMove
+			{
+				static constexpr const char* name = "coordinates_move";
+				Coordinates<D, T> a;
+				CoordinatesMove(size_t i) : a(make<Coordinates<D, T>>(i)) {}
+				Coordinates<D, T> operator() ()
+				{
+					Coordinates<D, T> moved(std::move(a));
+					a = std::move(moved);
+					return a;
+				}
+			};
+			template<size_t D, typename T>
+			struct VectorMagnitude
+			{
+				static constexpr const char* name = "vector_magnitude";
+				VectorBase<D, T> a;
+				VectorMagnitude(size_t i) : a(make<Coordinates<D, T>>(i)) {}
+				T operator() () const { return a.magnitude(); }
+			};
+			template<size_t D, typename T>
+			struct VectorNormalised
+			{
+				static constexpr const char* name = "vector_normalised";
+				VectorBase<D, T> a;
+				VectorNormalised(size_t i) : a(make<Coordinates<D, T>>(i)) {}
+				VectorBase<D, T> operator() () const { return a.normalised(); }
+			};
+			template<size_t D, typename T>
+			struct VectorDot
+			{
+				static constexpr const char* name = "dot";
+				Vector<D, T> a, b;
+				VectorDot(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i + 1)) {}
+				T operator() () const { return dot(a, b); }
+			};
+			template<size_t D, typename T>
+			struct VectorAngle
+			{
+				static constexpr const char* name = "angle";
+				Vector<D, T> a, b;
+				VectorAngle(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i + 1)) {}
+				double operator() () const { return angle(a, b).radians(); }
+			};
+			template<size_t D, typename T>
+			struct VectorCross
+			{
+				static constexpr const char* name = "cross";
+				Vector<D, T> a, b;
+				VectorCross(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i + 1)) {}
+				Vector<D, T> operator() () const { return cross(a, b); }
+			};
+			template<size_t D, typename T>
+			struct VectorReflect
+			{
+				static constexpr const char* name = "reflect";
+				Vector<D, T> a, b;
+				VectorReflect(size_t i) : a(make<Coordinates<D, T>>(i)), b(make<Coordinates<D, T>>(i + 1)) {}
+				Vector<D, T> operator() () const { return reflect(a, b); }
+			};
+			template<size_t D, typename T>
+			struct PointDistance
+			{
+				static constexpr const char* name = "distance";
+				Point<D, T> a, b;
+				PointDistance(size_t i) : a(make<Point<D, T>>(i)), b(make<Point<D, T>>(i + 1)) {}
+				T operator() () const { return distance(a, b); }
+			};
+
+			template<template<size_t, typename> typename Op, size_t D, typename T>
+			void add(Registry& registry)
+			{
+				const std::string name = std::string(Op<D, T>::name) + '/' + std::to_string(D) + '/' + type_name<T>();
+				registry.add(name + "/latency", &latency<Op<D, T>>);
+				registry.add(name + "/throughput", &throughput<Op<D, T>>);
+			}
+			template<template<size_t, typename> typename Op, size_t First, typename T>
+			void add_dimensions(Registry& registry)
+			{
+				if constexpr (First <= 1)
+					add<Op, 1, T>(registry);
+				add<Op, 2, T>(registry);
+				add<Op, 3, T>(registry);
+				add<Op, 4, T>(registry);
+			}
+			template<template<size_t, typename> typename Op, size_t First = 1>
+			void add_all(Registry& registry)
+			{
+				add_dimensions<Op, First, int>(registry);
+				add_dimensions<Op, First, float>(registry);
+				add_dimensions<Op, First, double>(registry);
+				add_dimensions<Op, First, long double>(registry);
+			}
+		}
+
+		void register_tuple_benchmarks(Registry& registry)
+		{
+			add_all<TupleAdd>(registry);
+			add_all<TupleSubtract>(registry);
+			add_all<TupleAddAssign>(registry);
+			add_all<TupleSubtractAssign>(registry);
+			add_all<TupleScale>(registry);
+			add_all<TupleDivide>(registry);
+			add_all<TupleFma>(registry);
+			add_all<TupleAxpy>(registry);
+			add_all<TupleEquals>(registry);
+			add_all<CoordinatesCopy>(registry);
+			add_all<CoordinatesMove>(registry);
+			add_all<VectorMagnitude>(registry);
+			add_all<VectorNormalised>(registry);
+			add_all<VectorDot>(registry);
+			// Vector<1, T> has no length<L>(), which angle needs.
+			add_all<VectorAngle, 2>(registry);
+			add_all<PointDistance>(registry);
+			// cross only exists in 3 dimensions, reflect only for floating point.
+			add<VectorCross, 3, int>(registry);
+			add<VectorCross, 3, float>(registry);
+			add<VectorCross, 3, double>(registry);
+			add<VectorCross, 3, long double>(registry);
+			add_dimensions<VectorReflect, 2, float>(registry);
+			add_dimensions<VectorReflect, 2, double>(registry);
+		}
+	}
+}
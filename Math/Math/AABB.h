@@ -0,0 +1,266 @@
+#pragma once
+#include <cassert>
+#include <limits>
+#include <span>
+#include <vector>
+#include "Point.h"
+#include "Vector.h"
+#include "Pack.h"
+#include "Bulk.h"
+
+namespace math
+{
+	namespace detail
+	{
+		template<size_t C, Tuple T>
+		static constexpr void aabb_expand(T& minimum, T& maximum, const T& low, const T& high)
+		{
+			if (low.template get_component<C>() < minimum.template get_component<C>())
+				minimum.template get_component<C>() = low.template get_component<C>();
+			if (maximum.template get_component<C>() < high.template get_component<C>())
+				maximum.template get_component<C>() = high.template get_component<C>();
+		}
+		template<Tuple T, size_t... C>
+		static constexpr void aabb_expand(T& minimum, T& maximum, const T& low, const T& high, std::index_sequence<C...>)
+		{
+			(aabb_expand<C>(minimum, maximum, low, high), ...);
+		}
+		template<size_t C, Tuple T>
+		static constexpr void aabb_clip(T& minimum, T& maximum, const T& low, const T& high)
+		{
+			if (minimum.template get_component<C>() < low.template get_component<C>())
+				minimum.template get_component<C>() = low.template get_component<C>();
+			if (high.template get_component<C>() < maximum.template get_component<C>())
+				maximum.template get_component<C>() = high.template get_component<C>();
+		}
+		template<Tuple T, size_t... C>
+		static constexpr void aabb_clip(T& minimum, T& maximum, const T& low, const T& high, std::index_sequence<C...>)
+		{
+			(aabb_clip<C>(minimum, maximum, low, high), ...);
+		}
+		template<Tuple T, size_t... C>
+		static constexpr bool aabb_contains(const T& minimum, const T& maximum, const T& low, const T& high, std::index_sequence<C...>)
+		{
+			return ((!(low.template get_component<C>() < minimum.template get_component<C>()) && !(maximum.template get_component<C>() < high.template get_component<C>())) && ...);
+		}
+		template<Tuple T, size_t... C>
+		static constexpr bool aabb_overlaps(const T& minimum, const T& maximum, const T& low, const T& high, std::index_sequence<C...>)
+		{
+			return ((!(high.template get_component<C>() < minimum.template get_component<C>()) && !(maximum.template get_component<C>() < low.template get_component<C>())) && ...);
+		}
+		template<Tuple T, size_t... C>
+		static constexpr bool aabb_empty(const T& minimum, const T& maximum, std::index_sequence<C...>)
+		{
+			return ((maximum.template get_component<C>() < minimum.template get_component<C>()) || ...);
+		}
+
+		// Narrows [near, far] to the part of the ray inside the slab of component C.
+		template<size_t C, Tuple P, Tuple V>
+		static constexpr void aabb_slab(const P& minimum, const P& maximum, const P& origin, const V& inverse_direction, typename P::value_type& near, typename P::value_type& far)
+		{
+			using T = typename P::value_type;
+			const T t0 = (minimum.template get_component<C>() - origin.template get_component<C>()) * inverse_direction.template get_component<C>();
+			const T t1 = (maximum.template get_component<C>() - origin.template get_component<C>()) * inverse_direction.template get_component<C>();
+			const T entry = t1 < t0 ? t1 : t0;
+			const T exit = t1 < t0 ? t0 : t1;
+			near = near < entry ? entry : near;
+			far = exit < far ? exit : far;
+		}
+		template<Tuple P, Tuple V, size_t... C>
+		static constexpr void aabb_slabs(const P& minimum, const P& maximum, const P& origin, const V& inverse_direction, typename P::value_type& near, typename P::value_type& far, std::index_sequence<C...>)
+		{
+			(aabb_slab<C>(minimum, maximum, origin, inverse_direction, near, far), ...);
+		}
+	}
+
+	// Axis-aligned box between two corners, inclusive on every side. A default-constructed box is empty
+	// (minimum above maximum), so expanding it by points or boxes gives their bounds.
+	template<size_t D, typename T>
+	requires is_arithmetic_v<T>
+	struct AABB
+	{
+	public:
+		using point_type = Point<D, T>;
+		using vector_type = Vector<D, T>;
+
+		constexpr AABB() : minimum(std::numeric_limits<T>::max()), maximum(std::numeric_limits<T>::lowest()) {}
+		constexpr AABB(const point_type& point) : minimum(point), maximum(point) {}
+		constexpr AABB(const point_type& minimum, const point_type& maximum) : minimum(minimum), maximum(maximum) {}
+
+		// The bounds of points, reduced chunk by chunk on the executor.
+		template<bulk::Executor E = bulk::Serial>
+		static AABB bounding(std::span<const point_type> points, const E& executor = E())
+		{
+			constexpr size_t chunk = bulk::detail::bulk_chunk<point_type>;
+			std::vector<AABB> partials((points.size() + chunk - 1) / chunk);
+			bulk::detail::bulk_for<point_type>(points.size(), executor, [&](size_t first, size_t last)
+			{
+				AABB partial;
+				for (size_t i = first; i < last; ++i)
+					partial.expand(points[i]);
+				partials[first / chunk] = partial;
+			});
+			AABB result;
+			for (const AABB& partial : partials)
+				result.expand(partial);
+			return result;
+		}
+
+		constexpr bool empty() const { return detail::aabb_empty(minimum, maximum, std::make_index_sequence<D>()); }
+		constexpr vector_type extent() const { return vector_type(minimum, maximum); }
+		constexpr point_type center() const
+		{
+			point_type center(minimum);
+			detail::tuple_operation_self<detail::TupleAddition<point_type>>(center, maximum);
+			detail::tuple_operation_scalar_self<detail::TupleDivision<point_type>>(center, T(2));
+			return center;
+		}
+
+		constexpr AABB& expand(const point_type& point)
+		{
+			detail::aabb_expand(minimum, maximum, point, point, std::make_index_sequence<D>());
+			return *this;
+		}
+		constexpr AABB& expand(const AABB& box)
+		{
+			detail::aabb_expand(minimum, maximum, box.minimum, box.maximum, std::make_index_sequence<D>());
+			return *this;
+		}
+
+		constexpr bool contains(const point_type& point) const { return detail::aabb_contains(minimum, maximum, point, point, std::make_index_sequence<D>()); }
+		constexpr bool contains(const AABB& box) const { return detail::aabb_contains(minimum, maximum, box.minimum, box.maximum, std::make_index_sequence<D>()); }
+		// Boxes that only touch overlap.
+		constexpr bool overlaps(const AABB& box) const { return detail::aabb_overlaps(minimum, maximum, box.minimum, box.maximum, std::make_index_sequence<D>()); }
+
+		// Slab test against the ray origin + t * direction, given 1 / direction per component. On a hit, near and far
+		// are narrowed to the part of [near, far] inside the box; this clips an interval rather than finding a surface,
+		// so an interval that starts inside keeps its near. intersect(Ray, AABB) gives the first surface in front instead.
+		// A ray parallel to a face and starting in its plane may miss.
+		constexpr bool intersects(const point_type& origin, const vector_type& inverse_direction, T& near, T& far) const requires is_floating_point_v<T>
+		{
+			detail::aabb_slabs(minimum, maximum, origin, inverse_direction, near, far, std::make_index_sequence<D>());
+			return !(far < near);
+		}
+
+		point_type minimum;
+		point_type maximum;
+	};
+
+	template<size_t D, typename T>
+	static constexpr AABB<D, T> merge(const AABB<D, T>& a, const AABB<D, T>& b)
+	{
+		AABB<D, T> result(a);
+		return result.expand(b);
+	}
+	// Empty when the boxes do not overlap.
+	template<size_t D, typename T>
+	static constexpr AABB<D, T> intersection(const AABB<D, T>& a, const AABB<D, T>& b)
+	{
+		AABB<D, T> result(a);
+		detail::aabb_clip(result.minimum, result.maximum, b.minimum, b.maximum, std::make_index_sequence<D>());
+		return result;
+	}
+
+	namespace detail
+	{
+		// Batches of boxes are tested a chunk at a time: the corners go into SoA scratch and the kernels below
+		// run on the widest pack, written once over V = T or Pack<T, N>.
+		template<typename T, size_t D>
+		struct AABBChunk
+		{
+			static constexpr size_t size = 256;
+			alignas(64) T minimum[D][size];
+			alignas(64) T maximum[D][size];
+			alignas(64) T hits[size];
+
+			void load(std::span<const AABB<D, T>> boxes, size_t first, size_t count, size_t padded)
+			{
+				load(boxes, first, count, padded, std::make_index_sequence<D>());
+			}
+			template<size_t... C>
+			void load(std::span<const AABB<D, T>> boxes, size_t first, size_t count, size_t padded, std::index_sequence<C...>)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					((minimum[C][i] = boxes[first + i].minimum.template get_component<C>()), ...);
+					((maximum[C][i] = boxes[first + i].maximum.template get_component<C>()), ...);
+				}
+				for (size_t i = count; i < padded; ++i)
+					((minimum[C][i] = maximum[C][i] = 0), ...);
+			}
+		};
+
+		template<typename V, typename T, size_t D, size_t... C>
+		static auto aabb_overlaps_kernel(const AABBChunk<T, D>& chunk, size_t i, const AABB<D, T>& box, std::index_sequence<C...>)
+		{
+			return (!((load<V>(chunk.maximum[C] + i) < V(box.minimum.template get_component<C>())) | (V(box.maximum.template get_component<C>()) < load<V>(chunk.minimum[C] + i))) & ...);
+		}
+		template<typename V, typename T, size_t D>
+		static auto aabb_overlaps_kernel(const AABBChunk<T, D>& chunk, size_t i, const AABB<D, T>& box)
+		{
+			return aabb_overlaps_kernel<V>(chunk, i, box, std::make_index_sequence<D>());
+		}
+		template<size_t C, typename V, typename T, size_t D>
+		static void aabb_slab_kernel(const AABBChunk<T, D>& chunk, size_t i, const Point<D, T>& origin, const Vector<D, T>& inverse_direction, V& near, V& far)
+		{
+			const V o = V(origin.template get_component<C>());
+			const V inverse = V(inverse_direction.template get_component<C>());
+			const V t0 = (load<V>(chunk.minimum[C] + i) - o) * inverse;
+			const V t1 = (load<V>(chunk.maximum[C] + i) - o) * inverse;
+			const auto swapped = t1 < t0;
+			const V entry = select(swapped, t1, t0);
+			const V exit = select(swapped, t0, t1);
+			near = select(near < entry, entry, near);
+			far = select(exit < far, exit, far);
+		}
+		template<typename V, typename T, size_t D, size_t... C>
+		static auto aabb_intersects_kernel(const AABBChunk<T, D>& chunk, size_t i, const Point<D, T>& origin, const Vector<D, T>& inverse_direction, V near, V far, std::index_sequence<C...>)
+		{
+			(aabb_slab_kernel<C>(chunk, i, origin, inverse_direction, near, far), ...);
+			return !(far < near);
+		}
+		template<typename V, typename T, size_t D>
+		static auto aabb_intersects_kernel(const AABBChunk<T, D>& chunk, size_t i, const Point<D, T>& origin, const Vector<D, T>& inverse_direction, const V& near, const V& far)
+		{
+			return aabb_intersects_kernel<V>(chunk, i, origin, inverse_direction, near, far, std::make_index_sequence<D>());
+		}
+
+		template<typename T, size_t D, typename K>
+		static void aabb_batch(std::span<const AABB<D, T>> boxes, std::vector<size_t>& out, const K& kernel)
+		{
+			using V = widest_pack<T>;
+			constexpr size_t lanes = pack_traits<V>::lanes;
+			AABBChunk<T, D> chunk;
+			for (size_t first = 0; first < boxes.size(); first += chunk.size)
+			{
+				const size_t count = boxes.size() - first < chunk.size ? boxes.size() - first : chunk.size;
+				const size_t padded = (count + lanes - 1) / lanes * lanes;
+				chunk.load(boxes, first, count, padded);
+				for (size_t i = 0; i < padded; i += lanes)
+					store(chunk.hits + i, select(kernel.template operator()<V>(chunk, i), V(1), V(0)));
+				for (size_t i = 0; i < count; ++i)
+					if (chunk.hits[i] != 0)
+						out.push_back(first + i);
+			}
+		}
+	}
+
+	// Appends to out the positions of the boxes that overlap box.
+	template<size_t D, typename T>
+	static void overlapping(std::span<const AABB<D, T>> boxes, const AABB<D, T>& box, std::vector<size_t>& out)
+	{
+		if constexpr (std::is_floating_point_v<T>)
+			detail::aabb_batch(boxes, out, [&]<typename V>(const detail::AABBChunk<T, D>& chunk, size_t i) { return detail::aabb_overlaps_kernel<V>(chunk, i, box); });
+		else
+			for (size_t i = 0; i < boxes.size(); ++i)
+				if (boxes[i].overlaps(box))
+					out.push_back(i);
+	}
+	// Appends to out the positions of the boxes the ray origin + t * direction enters for some t in [near, far].
+	template<size_t D, typename T>
+	requires is_floating_point_v<T>
+	static void intersecting(std::span<const AABB<D, T>> boxes, const Point<D, T>& origin, const Vector<D, T>& inverse_direction, const T& near, const T& far, std::vector<size_t>& out)
+	{
+		detail::aabb_batch(boxes, out, [&]<typename V>(const detail::AABBChunk<T, D>& chunk, size_t i) { return detail::aabb_intersects_kernel<V>(chunk, i, origin, inverse_direction, V(near), V(far)); });
+	}
+}
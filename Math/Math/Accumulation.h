@@ -0,0 +1,260 @@
+#pragma once
+#include <cassert>
+#include <span>
+#include "Pack.h"
+
+namespace math
+{
+	// How sums of many terms are accumulated. Worst-case error of a sum of n terms in a type with unit roundoff u,
+	// relative to the sum of their magnitudes:
+	//
+	// naive          n u / lanes    a running sum per pack lane
+	// pairwise       u log2(n)      halves summed recursively down to blocks of 256
+	// compensated    2 u            Neumaier's running correction, whatever n; products add their rounding error too
+	//                               where there is a fused multiply-add
+	// widened        u + n u'       a running sum in the wider type, u' its roundoff: float sums in double,
+	//                               double in long double
+	//
+	// Types other than float, double and long double always accumulate naively.
+	enum class Accumulation
+	{
+		naive,
+		pairwise,
+		compensated,
+		widened,
+	};
+
+	namespace detail
+	{
+		template<typename T>
+		using widened_type = std::conditional_t<std::is_same_v<T, float>, double, std::conditional_t<std::is_same_v<T, double>, long double, T>>;
+
+		template<typename V>
+		static typename pack_traits<V>::value_type lane_sum(const V& value)
+		{
+			using T = typename pack_traits<V>::value_type;
+			if constexpr (std::is_same_v<V, T>)
+				return value;
+			else
+			{
+				alignas(64) T lanes[pack_traits<V>::lanes];
+				store(lanes, value);
+				T sum = lanes[0];
+				for (size_t i = 1; i < pack_traits<V>::lanes; ++i)
+					sum += lanes[i];
+				return sum;
+			}
+		}
+
+		// The span kernels add up a[i], or a[i] * b[i] for Products, over the widest pack. Each keeps accumulation_packs
+		// independent partial sums so consecutive additions do not wait on each other.
+		static constexpr size_t accumulation_packs = 4;
+
+		template<bool Products, typename T>
+		static T naive_sum(const T* a, const T* b, size_t size)
+		{
+			using V = widest_pack<T>;
+			constexpr size_t lanes = pack_traits<V>::lanes;
+			constexpr size_t step = lanes * accumulation_packs;
+			size_t i = 0;
+			T sum = T(0);
+			if constexpr (lanes > 1)
+			{
+				V sums[accumulation_packs];
+				for (size_t p = 0; p < accumulation_packs; ++p)
+					sums[p] = V(0);
+				for (; i + step <= size; i += step)
+					for (size_t p = 0; p < accumulation_packs; ++p)
+					{
+						if constexpr (Products)
+							sums[p] = fused_multiply_add(load<V>(a + i + p * lanes), load<V>(b + i + p * lanes), sums[p]);
+						else
+							sums[p] = sums[p] + load<V>(a + i + p * lanes);
+					}
+				for (; i + lanes <= size; i += lanes)
+				{
+					if constexpr (Products)
+						sums[0] = fused_multiply_add(load<V>(a + i), load<V>(b + i), sums[0]);
+					else
+						sums[0] = sums[0] + load<V>(a + i);
+				}
+				sum = lane_sum((sums[0] + sums[1]) + (sums[2] + sums[3]));
+			}
+			for (; i < size; ++i)
+			{
+				if constexpr (Products)
+					sum = fused_multiply_add(a[i], b[i], sum);
+				else
+					sum += a[i];
+			}
+			return sum;
+		}
+
+		static constexpr size_t pairwise_block = 256;
+
+		template<bool Products, typename T>
+		static T pairwise_sum(const T* a, const T* b, size_t size)
+		{
+			if (size <= pairwise_block)
+				return naive_sum<Products>(a, b, size);
+			const size_t half = (size / 2 + pairwise_block - 1) / pairwise_block * pairwise_block;
+			return pairwise_sum<Products>(a, b, half) + pairwise_sum<Products>(a + half, Products ? b + half : b, size - half);
+		}
+
+		template<typename V>
+		static void neumaier_add(V& sum, V& compensation, const V& value)
+		{
+			const V total = sum + value;
+			compensation = compensation + select(abs(value) <= abs(sum), (sum - total) + value, (value - total) + sum);
+			sum = total;
+		}
+		template<bool Products, typename V, typename T>
+		static void compensated_term(V& sum, V& compensation, const T* a, const T* b)
+		{
+			if constexpr (Products)
+			{
+				const V x = load<V>(a);
+				const V y = load<V>(b);
+				const V product = x * y;
+				neumaier_add(sum, compensation, product);
+				compensation = compensation + fused_multiply_add(x, y, V(0) - product);
+			}
+			else
+				neumaier_add(sum, compensation, load<V>(a));
+		}
+		template<bool Products, typename T>
+		static void compensated_sum(T& sum, T& compensation, const T* a, const T* b, size_t size)
+		{
+			using V = widest_pack<T>;
+			constexpr size_t lanes = pack_traits<V>::lanes;
+			constexpr size_t step = lanes * accumulation_packs;
+			size_t i = 0;
+			if constexpr (lanes > 1)
+				if (size >= step)
+				{
+					V sums[accumulation_packs], compensations[accumulation_packs];
+					for (size_t p = 0; p < accumulation_packs; ++p)
+						sums[p] = compensations[p] = V(0);
+					for (; i + step <= size; i += step)
+						for (size_t p = 0; p < accumulation_packs; ++p)
+							compensated_term<Products>(sums[p], compensations[p], a + i + p * lanes, Products ? b + i + p * lanes : b);
+					alignas(64) T partial_sums[lanes];
+					alignas(64) T partial_compensations[lanes];
+					for (size_t p = 0; p < accumulation_packs; ++p)
+					{
+						store(partial_sums, sums[p]);
+						store(partial_compensations, compensations[p]);
+						for (size_t lane = 0; lane < lanes; ++lane)
+						{
+							neumaier_add(sum, compensation, partial_sums[lane]);
+							compensation += partial_compensations[lane];
+						}
+					}
+				}
+			for (; i < size; ++i)
+				compensated_term<Products>(sum, compensation, a + i, Products ? b + i : b);
+		}
+
+		// Runs in the wider type throughout, with independent partial sums for the compiler to keep in registers.
+		template<bool Products, typename T>
+		static widened_type<T> widened_sum(const T* a, const T* b, size_t size)
+		{
+			using W = widened_type<T>;
+			constexpr size_t partials = 8;
+			W sums[partials] = {};
+			size_t i = 0;
+			for (; i + partials <= size; i += partials)
+				for (size_t p = 0; p < partials; ++p)
+				{
+					if constexpr (Products)
+						sums[p] += static_cast<W>(a[i + p]) * static_cast<W>(b[i + p]);
+					else
+						sums[p] += static_cast<W>(a[i + p]);
+				}
+			// Counted down from what is left rather than compared with size; some GCC versions warn on the latter with
+			// -Waggressive-loop-optimizations after the partials loop above.
+			for (size_t left = size - i; left > 0; --left, ++i)
+			{
+				if constexpr (Products)
+					sums[0] += static_cast<W>(a[i]) * static_cast<W>(b[i]);
+				else
+					sums[0] += static_cast<W>(a[i]);
+			}
+			return ((sums[0] + sums[1]) + (sums[2] + sums[3])) + ((sums[4] + sums[5]) + (sums[6] + sums[7]));
+		}
+	}
+
+	// A running sum of values and products under an accumulation policy. Spans are added with the vectorised kernels
+	// above; single values and products one at a time, in order. Pairwise applies within each span added, and
+	// partial sums merge with the policy of the sum they merge into.
+	template<Accumulation A, typename T>
+	struct Accumulator
+	{
+	public:
+		static constexpr Accumulation accumulation = std::is_floating_point_v<T> ? A : Accumulation::naive;
+		using sum_type = std::conditional_t<accumulation == Accumulation::widened, detail::widened_type<T>, T>;
+
+		constexpr Accumulator() : sum(0), compensation(0) {}
+
+		constexpr void add(const T& value)
+		{
+			if constexpr (accumulation == Accumulation::compensated)
+			{
+				const T total = sum + value;
+				compensation += (value < 0 ? -value : value) <= (sum < 0 ? -sum : sum) ? (sum - total) + value : (value - total) + sum;
+				sum = total;
+			}
+			else
+				sum += static_cast<sum_type>(value);
+		}
+		constexpr void add_product(const T& a, const T& b)
+		{
+			if constexpr (accumulation == Accumulation::compensated)
+			{
+				const T product = a * b;
+				add(product);
+				compensation += detail::fused_multiply_add(a, b, -product);
+			}
+			else
+				sum = detail::fused_multiply_add(static_cast<sum_type>(a), static_cast<sum_type>(b), sum);
+		}
+		void add(std::span<const T> values)
+		{
+			accumulate<false>(values.data(), nullptr, values.size());
+		}
+		void add_products(std::span<const T> a, std::span<const T> b)
+		{
+			assert(a.size() == b.size());
+			accumulate<true>(a.data(), b.data(), a.size());
+		}
+		constexpr void merge(const Accumulator& other)
+		{
+			if constexpr (accumulation == Accumulation::compensated)
+			{
+				add(other.sum);
+				compensation += other.compensation;
+			}
+			else
+				sum += other.sum;
+		}
+
+		constexpr T result() const { return static_cast<T>(sum + static_cast<sum_type>(compensation)); }
+
+	private:
+		template<bool Products>
+		void accumulate(const T* a, const T* b, size_t size)
+		{
+			if constexpr (accumulation == Accumulation::compensated)
+				detail::compensated_sum<Products>(sum, compensation, a, b, size);
+			else if constexpr (accumulation == Accumulation::pairwise)
+				sum += detail::pairwise_sum<Products>(a, b, size);
+			else if constexpr (accumulation == Accumulation::widened)
+				sum += detail::widened_sum<Products>(a, b, size);
+			else
+				sum += detail::naive_sum<Products>(a, b, size);
+		}
+
+		sum_type sum;
+		T compensation;
+	};
+}
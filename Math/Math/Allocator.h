@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <new>
+
+namespace math
+{
+	template<typename T, size_t A = 64>
+	requires (A >= alignof(T) && (A & (A - 1)) == 0)
+	struct AlignedAllocator
+	{
+		using value_type = T;
+		static constexpr size_t alignment = A;
+
+		template<typename U>
+		struct rebind
+		{
+			using other = AlignedAllocator<U, A>;
+		};
+
+		constexpr AlignedAllocator() noexcept {}
+		template<typename U>
+		constexpr AlignedAllocator(const AlignedAllocator<U, A>&) noexcept {}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(A)));
+		}
+		void deallocate(T* pointer, size_t) noexcept
+		{
+			::operator delete(pointer, std::align_val_t(A));
+		}
+
+		template<typename U>
+		constexpr bool operator== (const AlignedAllocator<U, A>&) const noexcept { return true; }
+		template<typename U>
+		constexpr bool operator!= (const AlignedAllocator<U, A>&) const noexcept { return false; }
+	};
+}
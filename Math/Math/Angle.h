@@ -1,7 +1,14 @@
 #pragma once
 #include "Constants.h"
+#include "GoniometricKernels.h"
+#include "Sqrt.h"
 #include <type_traits>
+#include <bit>
+#include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
 
 namespace math
 {
@@ -42,8 +49,8 @@ namespace math
 		template<typename T1, typename T2>
 		struct one_floating_type<T1, T2, true>
 		{
-			using higher = typename one_floating_type_t1_floating<T1, T2, std::is_floating_point_v<T1>>::higher;
-			using lower  = typename one_floating_type_t1_floating<T1, T2, std::is_floating_point_v<T1>>::lower;
+			using higher = typename one_floating_type_t1_floating<T1, T2, is_floating_point_v<T1>>::higher;
+			using lower  = typename one_floating_type_t1_floating<T1, T2, is_floating_point_v<T1>>::lower;
 		};
 		template<typename T1, typename T2>
 		struct one_floating_type<T1, T2, false>
@@ -63,15 +70,15 @@ namespace math
 		template<typename T1, typename T2>
 		struct both_floating_type<T1, T2, false>
 		{
-			using higher = typename one_floating_type<T1, T2, std::is_floating_point_v<T1> || std::is_floating_point_v<T2>>::higher;
-			using lower  = typename one_floating_type<T1, T2, std::is_floating_point_v<T1> || std::is_floating_point_v<T2>>::lower;
+			using higher = typename one_floating_type<T1, T2, is_floating_point_v<T1> || is_floating_point_v<T2>>::higher;
+			using lower  = typename one_floating_type<T1, T2, is_floating_point_v<T1> || is_floating_point_v<T2>>::lower;
 		};
 
 		template<typename T1, typename T2>
 		struct ranked_type
 		{
-			using higher = typename both_floating_type<T1, T2, std::is_floating_point_v<T1> && std::is_floating_point_v<T2>>::higher;
-			using lower  = typename both_floating_type<T1, T2, std::is_floating_point_v<T1> && std::is_floating_point_v<T2>>::lower;
+			using higher = typename both_floating_type<T1, T2, is_floating_point_v<T1> && is_floating_point_v<T2>>::higher;
+			using lower  = typename both_floating_type<T1, T2, is_floating_point_v<T1> && is_floating_point_v<T2>>::lower;
 		};
 
 		template<typename T1, typename T2, typename T3>
@@ -96,7 +103,7 @@ namespace math
 		constexpr Radians(const T& angle) : angle(angle) {}
 		constexpr Radians(T&& angle) : angle(std::move(angle)) {}
 		template<Angle A>
-		constexpr Radians(const A& angle) : angle(angle.radians<T>()) {}
+		constexpr Radians(const A& angle) : angle(angle.template radians<T>()) {}
 
 		template<typename A = T>
 		requires std::is_floating_point_v<A>
@@ -108,8 +115,8 @@ namespace math
 		requires std::is_arithmetic_v<A>
 		constexpr A pi_factor() const { return static_cast<A>(detail::high_cast<A, T>(angle) * constants<typename detail::ranked_type<T, A>::higher>::inverse_pi); }
 
-		T& native() { return angle; }
-		const T& native() const { return angle; }
+		constexpr T& native() { return angle; }
+		constexpr const T& native() const { return angle; }
 
 	private:
 		T angle;
@@ -126,7 +133,7 @@ namespace math
 		constexpr Degrees(const T& angle) : angle(angle) {}
 		constexpr Degrees(T&& angle) : angle(std::move(angle)) {}
 		template<Angle A>
-		constexpr Degrees(const A& angle) : angle(angle.degrees<T>()) {}
+		constexpr Degrees(const A& angle) : angle(angle.template degrees<T>()) {}
 
 		template<typename A = typename detail::ranked_type<T, float>::higher>
 		requires std::is_floating_point_v<A>
@@ -138,8 +145,8 @@ namespace math
 		requires std::is_arithmetic_v<A>
 		constexpr A pi_factor() const { return static_cast<A>(detail::high_cast<T, A>(angle) * constants<typename detail::ranked_type<T, A>::higher>::pi); }
 
-		T& native() { return angle; }
-		const T& native() const { return angle; }
+		constexpr T& native() { return angle; }
+		constexpr const T& native() const { return angle; }
 
 	private:
 		T angle;
@@ -156,7 +163,7 @@ namespace math
 		constexpr PiFactor(const T& angle) : angle(angle) {}
 		constexpr PiFactor(T&& angle) : angle(std::move(angle)) {}
 		template<Angle A>
-		constexpr PiFactor(const A& angle) : angle(angle.pi_factor<T>()) {}
+		constexpr PiFactor(const A& angle) : angle(angle.template pi_factor<T>()) {}
 
 		template<typename A = typename detail::ranked_type<T, float>::higher>
 		requires std::is_floating_point_v<A>
@@ -168,8 +175,8 @@ namespace math
 		requires std::is_arithmetic_v<A>
 		constexpr A pi_factor() const { return static_cast<A>(angle); }
 
-		T& native() { return angle; }
-		const T& native() const { return angle; }
+		constexpr T& native() { return angle; }
+		constexpr const T& native() const { return angle; }
 
 	private:
 		T angle;
@@ -194,6 +201,7 @@ namespace math
 			static float cosh(float x)				{ return ::coshf(x);}
 			static float sinh(float x)				{ return ::sinhf(x);}
 			static float tanh(float x)				{ return ::tanhf(x);}
+			static void sincos(float radians, float& sine, float& cosine)	{ sine = ::sinf(radians); cosine = ::cosf(radians); }
 		};
 		template<>
 		struct GoniometricFunctions<double>
@@ -208,6 +216,7 @@ namespace math
 			static double cosh(double x)				{ return ::cosh(x);}
 			static double sinh(double x)				{ return ::sinh(x);}
 			static double tanh(double x)				{ return ::tanh(x);}
+			static void sincos(double radians, double& sine, double& cosine)	{ sine = ::sin(radians); cosine = ::cos(radians); }
 		};
 		template<>
 		struct GoniometricFunctions<long double>
@@ -222,53 +231,448 @@ namespace math
 			static long double cosh(long double x)						{ return ::coshl(x);}
 			static long double sinh(long double x)						{ return ::sinhl(x);}
 			static long double tanh(long double x)						{ return ::tanhl(x);}
+			static void sincos(long double radians, long double& sine, long double& cosine)	{ sine = ::sinl(radians); cosine = ::cosl(radians); }
 		};
+
+		// The polynomial kernels of GoniometricKernels.h, for scalars and packs alike; see there for their accuracy.
+		// The inverse and hyperbolic functions without a kernel fall through to libm.
+		template<typename T>
+		struct PolynomialGoniometricFunctions
+		{};
+
+		template<typename T>
+		requires std::is_same_v<T, float> || std::is_same_v<T, double>
+		struct PolynomialGoniometricFunctions<T> : public GoniometricFunctions<T>
+		{
+			template<typename V>
+			static V atan(const V& x)									{ return polynomial_atan2(x, V(1)); }
+			template<typename V>
+			static V atan2(const V& y, const V& x)						{ return polynomial_atan2(y, x); }
+			template<typename V>
+			static V cos(const V& radians)								{ V sine, cosine; polynomial_sincos(radians, sine, cosine); return cosine; }
+			template<typename V>
+			static V sin(const V& radians)								{ V sine, cosine; polynomial_sincos(radians, sine, cosine); return sine; }
+			template<typename V>
+			static V tan(const V& radians)								{ V sine, cosine; polynomial_sincos(radians, sine, cosine); return sine / cosine; }
+			template<typename V>
+			static void sincos(const V& radians, V& sine, V& cosine)	{ polynomial_sincos(radians, sine, cosine); }
+		};
+
+		template<Precision P, typename T>
+		using goniometric_functions = std::conditional_t<P == Precision::exact || std::is_same_v<T, long double>, GoniometricFunctions<T>, PolynomialGoniometricFunctions<T>>;
+		template<Precision P, typename T, typename V>
+		using goniometric_kernel = std::conditional_t<std::is_same_v<V, T>, goniometric_functions<P, T>, PolynomialGoniometricFunctions<T>>;
+
+		template<Precision P, typename T, typename K>
+		static void goniometric_span(size_t size, const K& kernel)
+		{
+			using V = widest_pack<T>;
+			size_t i = 0;
+			if constexpr (P != Precision::exact && !std::is_same_v<V, T>)
+				for (; i + V::lanes <= size; i += V::lanes)
+					kernel(V(), i);
+			for (; i < size; ++i)
+				kernel(T(), i);
+		}
 	}
 
+	template<typename T>
+	struct SinCos
+	{
+		T sin;
+		T cos;
+	};
+
+	template<Precision P, Angle A, typename T = typename detail::ranked_type<float, typename A::angle_type>::higher>
+	static constexpr T sin(const A& angle)
+	{
+		if (std::is_constant_evaluated())
+			return detail::ConstexprGoniometricFunctions<typename std::remove_cvref<T>::type>::sin(angle.template radians<T>());
+		return detail::goniometric_functions<P, typename std::remove_cvref<T>::type>::sin(angle.template radians<T>());
+	}
+	template<Precision P, Angle A, typename T = typename detail::ranked_type<float, typename A::angle_type>::higher>
+	static constexpr T cos(const A& angle)
+	{
+		if (std::is_constant_evaluated())
+			return detail::ConstexprGoniometricFunctions<typename std::remove_cvref<T>::type>::cos(angle.template radians<T>());
+		return detail::goniometric_functions<P, typename std::remove_cvref<T>::type>::cos(angle.template radians<T>());
+	}
+	template<Precision P, Angle A, typename T = typename detail::ranked_type<float, typename A::angle_type>::higher>
+	static constexpr T tan(const A& angle)
+	{
+		if (std::is_constant_evaluated())
+			return detail::ConstexprGoniometricFunctions<typename std::remove_cvref<T>::type>::tan(angle.template radians<T>());
+		return detail::goniometric_functions<P, typename std::remove_cvref<T>::type>::tan(angle.template radians<T>());
+	}
+	template<Precision P, Angle A, typename T = typename detail::ranked_type<float, typename A::angle_type>::higher>
+	static constexpr SinCos<T> sincos(const A& angle)
+	{
+		SinCos<T> result{};
+		if (std::is_constant_evaluated())
+			detail::ConstexprGoniometricFunctions<typename std::remove_cvref<T>::type>::sincos(angle.template radians<T>(), result.sin, result.cos);
+		else
+			detail::goniometric_functions<P, typename std::remove_cvref<T>::type>::sincos(angle.template radians<T>(), result.sin, result.cos);
+		return result;
+	}
+	template<Angle A, typename T = typename detail::ranked_type<float, typename A::angle_type>::higher>
+	static constexpr T sin(const A& angle)
+	{
+		return sin<Precision::exact, A, T>(angle);
+	}
 	template<Angle A, typename T = typename detail::ranked_type<float, typename A::angle_type>::higher>
-	static T sin(const A& angle)
+	static constexpr T cos(const A& angle)
 	{
-		return detail::GoniometricFunctions<typename std::remove_cvref<T>::type>::sin(angle.radians<T>());
+		return cos<Precision::exact, A, T>(angle);
 	}
 	template<Angle A, typename T = typename detail::ranked_type<float, typename A::angle_type>::higher>
-	static T cos(const A& angle)
+	static constexpr T tan(const A& angle)
 	{
-		return detail::GoniometricFunctions<typename std::remove_cvref<T>::type>::cos(angle.radians<T>());
+		return tan<Precision::exact, A, T>(angle);
 	}
 	template<Angle A, typename T = typename detail::ranked_type<float, typename A::angle_type>::higher>
-	static T tan(const A& angle)
+	static constexpr SinCos<T> sincos(const A& angle)
 	{
-		return detail::GoniometricFunctions<typename std::remove_cvref<T>::type>::tan(angle.radians<T>());
+		return sincos<Precision::exact, A, T>(angle);
 	}
 	template<typename T = double>
 	requires std::is_floating_point_v<T>
-	static Radians<T> arccos(const T& x)
+	static constexpr Radians<T> arccos(const T& x)
 	{
+		if (std::is_constant_evaluated())
+			return detail::ConstexprGoniometricFunctions<typename std::remove_cvref<T>::type>::acos(x);
 		return detail::GoniometricFunctions<typename std::remove_cvref<T>::type>::acos(x);
 	}
 	template<typename T = double>
 	requires std::is_floating_point_v<T>
-	static Radians<T> arcsin(const T& x)
+	static constexpr Radians<T> arcsin(const T& x)
 	{
+		if (std::is_constant_evaluated())
+			return detail::ConstexprGoniometricFunctions<typename std::remove_cvref<T>::type>::asin(x);
 		return detail::GoniometricFunctions<typename std::remove_cvref<T>::type>::asin(x);
 	}
 	template<typename T = double>
 	requires std::is_floating_point_v<T>
-	static Radians<T> arctan(const T& x)
+	static constexpr Radians<T> arctan(const T& x)
 	{
+		if (std::is_constant_evaluated())
+			return detail::ConstexprGoniometricFunctions<typename std::remove_cvref<T>::type>::atan(x);
 		return detail::GoniometricFunctions<typename std::remove_cvref<T>::type>::atan(x);
 	}
+	template<Precision P, typename T>
+	requires std::is_floating_point_v<T>
+	static constexpr Radians<T> arctan(const T& x, const T& y)
+	{
+		if (std::is_constant_evaluated())
+			return detail::ConstexprGoniometricFunctions<typename std::remove_cvref<T>::type>::atan2(y, x);
+		return detail::goniometric_functions<P, typename std::remove_cvref<T>::type>::atan2(y, x);
+	}
+	template<Precision P, typename T>
+	requires std::is_floating_point_v<T>
+	static constexpr Radians<T> arctan2(const T& x, const T& y)
+	{
+		if (std::is_constant_evaluated())
+			return detail::ConstexprGoniometricFunctions<typename std::remove_cvref<T>::type>::atan2(y, x);
+		return detail::goniometric_functions<P, typename std::remove_cvref<T>::type>::atan2(y, x);
+	}
 	template<typename T = double>
 	requires std::is_floating_point_v<T>
-	static Radians<T> arctan(const T& x, const T& y)
+	static constexpr Radians<T> arctan(const T& x, const T& y)
 	{
-		return detail::GoniometricFunctions<typename std::remove_cvref<T>::type>::atan2(y, x);
+		return arctan<Precision::exact, T>(x, y);
 	}
 	template<typename T = double>
 	requires std::is_floating_point_v<T>
-	static Radians<T> arctan2(const T& x, const T& y)
+	static constexpr Radians<T> arctan2(const T& x, const T& y)
+	{
+		return arctan2<Precision::exact, T>(x, y);
+	}
+
+	template<typename T, size_t N>
+	static Pack<T, N> sin(const Pack<T, N>& radians)
+	{
+		return detail::PolynomialGoniometricFunctions<T>::sin(radians);
+	}
+	template<typename T, size_t N>
+	static Pack<T, N> cos(const Pack<T, N>& radians)
+	{
+		return detail::PolynomialGoniometricFunctions<T>::cos(radians);
+	}
+	template<typename T, size_t N>
+	static void sincos(const Pack<T, N>& radians, Pack<T, N>& sine, Pack<T, N>& cosine)
+	{
+		detail::PolynomialGoniometricFunctions<T>::sincos(radians, sine, cosine);
+	}
+	template<typename T, size_t N>
+	static Pack<T, N> arctan2(const Pack<T, N>& x, const Pack<T, N>& y)
+	{
+		return detail::PolynomialGoniometricFunctions<T>::atan2(y, x);
+	}
+
+	template<Precision P = Precision::exact, typename T>
+	requires std::is_floating_point_v<T>
+	static void sin(std::span<const std::type_identity_t<T>> radians, std::span<T> out)
+	{
+		assert(radians.size() == out.size());
+		detail::goniometric_span<P, T>(out.size(), [&]<typename V>(V, size_t i)
+		{
+			detail::store(out.data() + i, detail::goniometric_kernel<P, T, V>::sin(detail::load<V>(radians.data() + i)));
+		});
+	}
+	template<Precision P = Precision::exact, typename T>
+	requires std::is_floating_point_v<T>
+	static void cos(std::span<const std::type_identity_t<T>> radians, std::span<T> out)
+	{
+		assert(radians.size() == out.size());
+		detail::goniometric_span<P, T>(out.size(), [&]<typename V>(V, size_t i)
+		{
+			detail::store(out.data() + i, detail::goniometric_kernel<P, T, V>::cos(detail::load<V>(radians.data() + i)));
+		});
+	}
+	template<Precision P = Precision::exact, typename T>
+	requires std::is_floating_point_v<T>
+	static void sincos(std::span<const std::type_identity_t<T>> radians, std::span<T> sine, std::span<T> cosine)
+	{
+		assert(radians.size() == sine.size() && radians.size() == cosine.size());
+		detail::goniometric_span<P, T>(radians.size(), [&]<typename V>(V, size_t i)
+		{
+			V s, c;
+			detail::goniometric_kernel<P, T, V>::sincos(detail::load<V>(radians.data() + i), s, c);
+			detail::store(sine.data() + i, s);
+			detail::store(cosine.data() + i, c);
+		});
+	}
+	template<Precision P = Precision::exact, typename T>
+	requires std::is_floating_point_v<T>
+	static void arctan2(std::span<const std::type_identity_t<T>> x, std::span<const std::type_identity_t<T>> y, std::span<T> out)
 	{
-		return detail::GoniometricFunctions<typename std::remove_cvref<T>::type>::atan2(y, x);
+		assert(x.size() == out.size() && y.size() == out.size());
+		detail::goniometric_span<P, T>(out.size(), [&]<typename V>(V, size_t i)
+		{
+			detail::store(out.data() + i, detail::goniometric_kernel<P, T, V>::atan2(detail::load<V>(y.data() + i), detail::load<V>(x.data() + i)));
+		});
+	}
+
+	// The angle types hold nothing but their value, so spans of them view as plain arrays of angle_type and back.
+	template<Angle A>
+	static std::span<typename A::angle_type> native(std::span<A> angles)
+	{
+		static_assert(sizeof(A) == sizeof(typename A::angle_type) && std::is_standard_layout_v<A>);
+		return { reinterpret_cast<typename A::angle_type*>(angles.data()), angles.size() };
+	}
+	template<Angle A>
+	static std::span<const typename A::angle_type> native(std::span<const A> angles)
+	{
+		static_assert(sizeof(A) == sizeof(typename A::angle_type) && std::is_standard_layout_v<A>);
+		return { reinterpret_cast<const typename A::angle_type*>(angles.data()), angles.size() };
+	}
+
+	namespace detail
+	{
+		template<typename A>
+		inline constexpr long double half_turn = 0;
+		template<typename T>
+		inline constexpr long double half_turn<Radians<T>> = constants<long double>::pi;
+		template<typename T>
+		inline constexpr long double half_turn<Degrees<T>> = 180;
+		template<typename T>
+		inline constexpr long double half_turn<PiFactor<T>> = 1;
+
+		template<typename T, typename K>
+		static void angle_span(size_t size, const K& kernel)
+		{
+			using V = widest_pack<T>;
+			size_t i = 0;
+			if constexpr (!std::is_same_v<V, T>)
+				for (; i + V::lanes <= size; i += V::lanes)
+					kernel(V(), i);
+			for (; i < size; ++i)
+				kernel(T(), i);
+		}
+
+		// One turn split for exact reduction: high keeps the top half of the bits of turn and low the rest, so both
+		// products with a quotient below 2^(digits / 2 - 2) are exact. Past limit, std::fmod reduces instead.
+		template<typename T>
+		struct TurnSplit
+		{
+			T turn;
+			T inverse;
+			T high;
+			T low;
+			T limit;
+		};
+		template<typename T>
+		static constexpr TurnSplit<T> split_turn(long double turn)
+		{
+			const T whole = static_cast<T>(turn);
+			if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+			{
+				using B = std::conditional_t<std::is_same_v<T, float>, uint32_t, uint64_t>;
+				constexpr int high_bits = std::numeric_limits<T>::digits / 2 + 1;
+				const T high = std::bit_cast<T>(std::bit_cast<B>(whole) & ~((B(1) << (std::numeric_limits<T>::digits - high_bits)) - 1));
+				return { whole, 1 / whole, high, whole - high, static_cast<T>(B(1) << (high_bits - 4)) * whole };
+			}
+			else
+				return { whole, 1 / whole, whole, 0, 0 };
+		}
+		template<typename A>
+		inline constexpr TurnSplit<typename A::angle_type> turn_split = split_turn<typename A::angle_type>(2 * half_turn<A>);
+
+		// The remainder of angle after whole turns, with the sign of angle, exactly as std::fmod gives it. The floored
+		// quotient is refined once from the rounded remainder, which leaves it at most one off; the remainder for that
+		// quotient is then exact, and so is the final correction by one turn.
+		template<typename V, typename T>
+		static V wrap_remainder(const V& angle, const TurnSplit<T>& split)
+		{
+			const V magnitude = abs(angle);
+			if constexpr (std::is_same_v<V, T>)
+				if (!(magnitude <= split.limit))
+					return std::fmod(angle, split.turn);
+			const V turn = V(split.turn);
+			V quotient = floor(magnitude * V(split.inverse));
+			quotient = quotient + floor((magnitude - quotient * turn) * V(split.inverse));
+			V remainder = (magnitude - quotient * V(split.high)) - quotient * V(split.low);
+			remainder = select(remainder < V(0), remainder + turn, remainder);
+			remainder = copysign(select(remainder < turn, remainder, remainder - turn), angle);
+			if constexpr (!std::is_same_v<V, T>)
+				if (!all(magnitude <= V(split.limit)))
+				{
+					T inputs[V::lanes], remainders[V::lanes];
+					angle.store(inputs);
+					remainder.store(remainders);
+					for (size_t i = 0; i < V::lanes; ++i)
+						if (!(abs(inputs[i]) <= split.limit))
+							remainders[i] = std::fmod(inputs[i], split.turn);
+					remainder = V::load(remainders);
+				}
+			return remainder;
+		}
+		// Into [0, turn). A remainder just below zero rounds up to a whole turn when the turn is added; that is the
+		// same angle as zero, and zero is the nearer of the two to the exact result.
+		template<typename V, typename T>
+		static V wrap_positive(const V& angle, const TurnSplit<T>& split)
+		{
+			const V remainder = wrap_remainder(angle, split);
+			const V positive = select(remainder < V(0), remainder + V(split.turn), remainder);
+			return select(V(split.turn) <= positive, V(0), positive);
+		}
+		// Into (-turn / 2, turn / 2]. Both corrections are exact.
+		template<typename V, typename T>
+		static V wrap_signed(const V& angle, const TurnSplit<T>& split)
+		{
+			const V remainder = wrap_remainder(angle, split);
+			const V half = V(split.turn * T(0.5));
+			const V below = select(half < remainder, remainder - V(split.turn), remainder);
+			return select(below <= V(0) - half, below + V(split.turn), below);
+		}
+	}
+
+	// Angle types convert with one multiplication per value, so results can differ from the one-by-one conversions
+	// in the last bit. Integer angle types convert one by one. out must hold as many angles.
+	template<Angle To, Angle From>
+	static void angle_cast(std::span<const From> angles, std::span<To> out)
+	{
+		assert(angles.size() == out.size());
+		using T = typename To::angle_type;
+		const size_t size = out.size();
+		if constexpr (std::is_same_v<T, typename From::angle_type> && (std::is_same_v<T, float> || std::is_same_v<T, double>))
+		{
+			const std::span<const T> in = native(angles);
+			const std::span<T> result = native(out);
+			const T factor = static_cast<T>(detail::half_turn<To> / detail::half_turn<From>);
+			detail::angle_span<T>(size, [&]<typename V>(V, size_t i)
+			{
+				detail::store(result.data() + i, detail::load<V>(in.data() + i) * V(factor));
+			});
+		}
+		else
+			for (size_t i = 0; i < size; ++i)
+				out[i] = To(angles[i]);
+	}
+
+	// Wrapping into one turn: wrap_positive into [0, 2 pi), wrap_signed into (-pi, pi], or the same in degrees or
+	// multiples of pi. The turns are removed exactly at any magnitude, so the span forms give the same bits; only the
+	// turn of 2 pi is itself rounded to the angle type.
+	template<Angle A>
+	requires std::is_floating_point_v<typename A::angle_type>
+	static A wrap_positive(const A& angle)
+	{
+		return A(detail::wrap_positive(angle.native(), detail::turn_split<A>));
+	}
+	template<Angle A>
+	requires std::is_floating_point_v<typename A::angle_type>
+	static A wrap_signed(const A& angle)
+	{
+		return A(detail::wrap_signed(angle.native(), detail::turn_split<A>));
+	}
+	// The signed angle of the shorter turn from a to b, in (-pi, pi].
+	template<Angle A>
+	requires std::is_floating_point_v<typename A::angle_type>
+	static A difference(const A& a, const A& b)
+	{
+		return wrap_signed(A(b.native() - a.native()));
+	}
+	// Along the shorter turn from a to b; the result is not wrapped.
+	template<Angle A>
+	requires std::is_floating_point_v<typename A::angle_type>
+	static A lerp(const A& a, const A& b, const typename A::angle_type& t)
+	{
+		return A(a.native() + difference(a, b).native() * t);
+	}
+
+	template<Angle A>
+	requires std::is_floating_point_v<typename A::angle_type>
+	static void wrap_positive(std::span<const std::type_identity_t<A>> angles, std::span<A> out)
+	{
+		assert(angles.size() == out.size());
+		using T = typename A::angle_type;
+		const std::span<const T> in = native(angles);
+		const std::span<T> result = native(out);
+		detail::angle_span<T>(result.size(), [&]<typename V>(V, size_t i)
+		{
+			detail::store(result.data() + i, detail::wrap_positive(detail::load<V>(in.data() + i), detail::turn_split<A>));
+		});
+	}
+	template<Angle A>
+	requires std::is_floating_point_v<typename A::angle_type>
+	static void wrap_signed(std::span<const std::type_identity_t<A>> angles, std::span<A> out)
+	{
+		assert(angles.size() == out.size());
+		using T = typename A::angle_type;
+		const std::span<const T> in = native(angles);
+		const std::span<T> result = native(out);
+		detail::angle_span<T>(result.size(), [&]<typename V>(V, size_t i)
+		{
+			detail::store(result.data() + i, detail::wrap_signed(detail::load<V>(in.data() + i), detail::turn_split<A>));
+		});
+	}
+	template<Angle A>
+	requires std::is_floating_point_v<typename A::angle_type>
+	static void difference(std::span<const std::type_identity_t<A>> a, std::span<const std::type_identity_t<A>> b, std::span<A> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size());
+		using T = typename A::angle_type;
+		const std::span<const T> from = native(a);
+		const std::span<const T> to = native(b);
+		const std::span<T> result = native(out);
+		detail::angle_span<T>(result.size(), [&]<typename V>(V, size_t i)
+		{
+			detail::store(result.data() + i, detail::wrap_signed(detail::load<V>(to.data() + i) - detail::load<V>(from.data() + i), detail::turn_split<A>));
+		});
+	}
+	template<Angle A>
+	requires std::is_floating_point_v<typename A::angle_type>
+	static void lerp(std::span<const std::type_identity_t<A>> a, std::span<const std::type_identity_t<A>> b, const typename A::angle_type& t, std::span<A> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size());
+		using T = typename A::angle_type;
+		const std::span<const T> from = native(a);
+		const std::span<const T> to = native(b);
+		const std::span<T> result = native(out);
+		detail::angle_span<T>(result.size(), [&]<typename V>(V, size_t i)
+		{
+			const V start = detail::load<V>(from.data() + i);
+			detail::store(result.data() + i, start + detail::wrap_signed(detail::load<V>(to.data() + i) - start, detail::turn_split<A>) * V(t));
+		});
 	}
 
 	static constexpr Degrees<int> operator""deg(unsigned long long int degrees)
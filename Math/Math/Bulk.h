@@ -0,0 +1,279 @@
+#pragma once
+#include <span>
+#include <vector>
+#include "Executor.h"
+#include "Vector.h"
+#include "TupleOperations.h"
+#include "Accumulation.h"
+
+namespace math
+{
+	namespace bulk
+	{
+		namespace detail
+		{
+			// Elements per chunk: enough to amortise scheduling, small enough that a chunk of input and output stays in L2.
+			template<typename T>
+			static constexpr size_t bulk_chunk = (size_t(1) << 16) / sizeof(T) > 0 ? (size_t(1) << 16) / sizeof(T) : 1;
+
+			template<typename T, Executor E, typename F>
+			static void bulk_for(size_t size, const E& executor, const F& function)
+			{
+				const size_t chunks = (size + bulk_chunk<T> - 1) / bulk_chunk<T>;
+				executor(chunks, [&](size_t chunk)
+				{
+					const size_t first = chunk * bulk_chunk<T>;
+					function(first, size - first < bulk_chunk<T> ? size : first + bulk_chunk<T>);
+				});
+			}
+
+			template<Tuple T, size_t... C>
+			static constexpr void tuple_assign(T& out, const T& tuple, std::index_sequence<C...>)
+			{
+				((out.template get_component<C>() = tuple.template get_component<C>()), ...);
+			}
+			template<Tuple T>
+			static constexpr void tuple_assign(T& out, const T& tuple)
+			{
+				tuple_assign(out, tuple, std::make_index_sequence<T::dimensions>());
+			}
+			template<Tuple T, size_t... C>
+			static constexpr void tuple_minimum(T& out, const T& tuple, std::index_sequence<C...>)
+			{
+				((out.template get_component<C>() = tuple.template get_component<C>() < out.template get_component<C>() ? tuple.template get_component<C>() : out.template get_component<C>()), ...);
+			}
+			template<Tuple T>
+			static constexpr void tuple_minimum(T& out, const T& tuple)
+			{
+				tuple_minimum(out, tuple, std::make_index_sequence<T::dimensions>());
+			}
+			template<Tuple T, size_t... C>
+			static constexpr void tuple_maximum(T& out, const T& tuple, std::index_sequence<C...>)
+			{
+				((out.template get_component<C>() = out.template get_component<C>() < tuple.template get_component<C>() ? tuple.template get_component<C>() : out.template get_component<C>()), ...);
+			}
+			template<Tuple T>
+			static constexpr void tuple_maximum(T& out, const T& tuple)
+			{
+				tuple_maximum(out, tuple, std::make_index_sequence<T::dimensions>());
+			}
+
+			// Reduces every chunk into one partial starting from its first element, then folds the partials in order,
+			// so the result does not depend on the executor.
+			template<Tuple T, Executor E, typename F>
+			static T bulk_reduce(std::span<const T> tuples, const E& executor, const F& combine)
+			{
+				if (tuples.empty())
+					return T();
+				const size_t chunks = (tuples.size() + bulk_chunk<T> - 1) / bulk_chunk<T>;
+				std::vector<T> partials(chunks);
+				bulk_for<T>(tuples.size(), executor, [&](size_t first, size_t last)
+				{
+					T& partial = partials[first / bulk_chunk<T>];
+					tuple_assign(partial, tuples[first]);
+					for (size_t i = first + 1; i < last; ++i)
+						combine(partial, tuples[i]);
+				});
+				T result = partials[0];
+				for (size_t i = 1; i < chunks; ++i)
+					combine(result, partials[i]);
+				return result;
+			}
+
+			// One accumulator per component. Tuples are added a range at a time: each component is gathered into
+			// contiguous scratch so the accumulators run their span kernels over it.
+			template<Accumulation A, Tuple T>
+			struct TupleAccumulator
+			{
+				using value_type = typename T::value_type;
+				static constexpr size_t dimensions = T::dimensions;
+
+				void add(std::span<const T> tuples, std::vector<value_type>& scratch)
+				{
+					add(tuples, scratch, std::make_index_sequence<dimensions>());
+				}
+				void merge(const TupleAccumulator& other)
+				{
+					for (size_t c = 0; c < dimensions; ++c)
+						components[c].merge(other.components[c]);
+				}
+				void result(T& out) const
+				{
+					result(out, std::make_index_sequence<dimensions>());
+				}
+
+				Accumulator<A, value_type> components[dimensions];
+
+			private:
+				template<size_t C>
+				void add_component(std::span<const T> tuples, std::vector<value_type>& scratch)
+				{
+					for (size_t i = 0; i < tuples.size(); ++i)
+						scratch[i] = tuples[i].template get_component<C>();
+					components[C].add(std::span<const value_type>(scratch.data(), tuples.size()));
+				}
+				template<size_t... C>
+				void add(std::span<const T> tuples, std::vector<value_type>& scratch, std::index_sequence<C...>)
+				{
+					(add_component<C>(tuples, scratch), ...);
+				}
+				template<size_t... C>
+				void result(T& out, std::index_sequence<C...>) const
+				{
+					((out.template get_component<C>() = components[C].result()), ...);
+				}
+			};
+
+			// Accumulates every chunk into one partial, then merges the partials pairwise. As with bulk_reduce the
+			// result does not depend on the executor.
+			template<typename T, typename P, Executor E, typename F>
+			static P bulk_accumulate(size_t size, const E& executor, const F& accumulate)
+			{
+				const size_t chunks = (size + bulk_chunk<T> - 1) / bulk_chunk<T>;
+				std::vector<P> partials(chunks > 0 ? chunks : 1);
+				bulk_for<T>(size, executor, [&](size_t first, size_t last)
+				{
+					accumulate(partials[first / bulk_chunk<T>], first, last);
+				});
+				for (size_t step = 1; step < chunks; step *= 2)
+					for (size_t i = 0; i + step < chunks; i += 2 * step)
+						partials[i].merge(partials[i + step]);
+				return partials[0];
+			}
+		}
+
+		// out[i] = function(in[i]) for the first min(in.size(), out.size()) elements.
+		template<Tuple T, typename U, typename F, Executor E = Serial>
+		static void transform(std::span<const T> in, std::span<U> out, const F& function, const E& executor = E())
+		{
+			detail::bulk_for<T>(in.size() < out.size() ? in.size() : out.size(), executor, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					out[i] = function(in[i]);
+			});
+		}
+
+		template<Tuple T, Executor E = Serial>
+		static void add(std::span<T> tuples, const std::type_identity_t<T>& value, const E& executor = E())
+		{
+			detail::bulk_for<T>(tuples.size(), executor, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					tuples[i] += value;
+			});
+		}
+		template<Tuple T, Executor E = Serial>
+		static void scale(std::span<T> tuples, const typename T::value_type& factor, const E& executor = E())
+		{
+			detail::bulk_for<T>(tuples.size(), executor, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					tuples[i] *= factor;
+			});
+		}
+
+		template<Precision P = Precision::exact, size_t D, typename T, Executor E = Serial>
+		requires std::is_floating_point_v<T>
+		static void normalise_all(std::span<Vector<D, T>> vectors, const E& executor = E())
+		{
+			detail::bulk_for<Vector<D, T>>(vectors.size(), executor, [&](size_t first, size_t last)
+			{
+				math::normalise<P>(vectors.subspan(first, last - first));
+			});
+		}
+
+		// out[i] = dot(a[i], b[i]).
+		template<size_t D, typename T, Executor E = Serial>
+		static void dot_many(std::span<const Vector<D, T>> a, std::span<const std::type_identity_t<Vector<D, T>>> b, std::span<std::type_identity_t<T>> out, const E& executor = E())
+		{
+			const size_t size = a.size() < b.size() ? a.size() : b.size();
+			detail::bulk_for<Vector<D, T>>(size < out.size() ? size : out.size(), executor, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					out[i] = math::detail::vector_dot(a[i], b[i]);
+			});
+		}
+
+		// out[i] = distance(tuples[i], point).
+		template<Precision P = Precision::exact, Tuple T, Executor E = Serial>
+		static void distance_to(std::span<const T> tuples, const SameTuple<T::dimensions, typename T::value_type> auto& point, std::span<typename T::value_type> out, const E& executor = E())
+		{
+			detail::bulk_for<T>(tuples.size() < out.size() ? tuples.size() : out.size(), executor, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					out[i] = math::distance<P>(tuples[i], point);
+			});
+		}
+
+		template<Tuple T, Executor E = Serial>
+		static T sum(std::span<const T> tuples, const E& executor = E())
+		{
+			return detail::bulk_reduce(tuples, executor, [](T& out, const T& tuple) { out += tuple; });
+		}
+		// The sum under an accumulation policy: each component is summed with the span kernels of Accumulator.
+		template<Accumulation A, Tuple T, Executor E = Serial>
+		static T sum(std::span<const T> tuples, const E& executor = E())
+		{
+			if constexpr (A == Accumulation::naive)
+				return sum(tuples, executor);
+			else
+			{
+				const auto partial = detail::bulk_accumulate<T, detail::TupleAccumulator<A, T>>(tuples.size(), executor, [&](detail::TupleAccumulator<A, T>& partial, size_t first, size_t last)
+				{
+					std::vector<typename T::value_type> scratch(last - first);
+					partial.add(tuples.subspan(first, last - first), scratch);
+				});
+				T result;
+				partial.result(result);
+				return result;
+			}
+		}
+		template<Accumulation A = Accumulation::naive, typename T, Executor E = Serial>
+		requires std::is_arithmetic_v<T>
+		static T sum(std::span<const T> values, const E& executor = E())
+		{
+			return detail::bulk_accumulate<T, Accumulator<A, T>>(values.size(), executor, [&](Accumulator<A, T>& partial, size_t first, size_t last)
+			{
+				partial.add(values.subspan(first, last - first));
+			}).result();
+		}
+		// The sum of a[i] * b[i] over the first min(a.size(), b.size()) elements.
+		template<Accumulation A = Accumulation::naive, typename T, Executor E = Serial>
+		requires std::is_arithmetic_v<T>
+		static T dot(std::span<const T> a, std::span<const std::type_identity_t<T>> b, const E& executor = E())
+		{
+			const size_t size = a.size() < b.size() ? a.size() : b.size();
+			return detail::bulk_accumulate<T, Accumulator<A, T>>(size, executor, [&](Accumulator<A, T>& partial, size_t first, size_t last)
+			{
+				partial.add_products(a.subspan(first, last - first), b.subspan(first, last - first));
+			}).result();
+		}
+		// Component-wise minimum and maximum; together they give the bounding box of a point set.
+		template<Tuple T, Executor E = Serial>
+		static T min(std::span<const T> tuples, const E& executor = E())
+		{
+			return detail::bulk_reduce(tuples, executor, [](T& out, const T& tuple) { detail::tuple_minimum(out, tuple); });
+		}
+		template<Tuple T, Executor E = Serial>
+		static T max(std::span<const T> tuples, const E& executor = E())
+		{
+			return detail::bulk_reduce(tuples, executor, [](T& out, const T& tuple) { detail::tuple_maximum(out, tuple); });
+		}
+		template<Tuple T, Executor E = Serial>
+		static T centroid(std::span<const T> tuples, const E& executor = E())
+		{
+			T result = sum(tuples, executor);
+			if (!tuples.empty())
+				result /= static_cast<typename T::value_type>(tuples.size());
+			return result;
+		}
+		template<Accumulation A, Tuple T, Executor E = Serial>
+		static T centroid(std::span<const T> tuples, const E& executor = E())
+		{
+			T result = sum<A>(tuples, executor);
+			if (!tuples.empty())
+				result /= static_cast<typename T::value_type>(tuples.size());
+			return result;
+		}
+	}
+}
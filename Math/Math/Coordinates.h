@@ -1,6 +1,7 @@
 #pragma once
 #include <utility>
 #include "Tuple.h"
+#include "Simd.h"
 
 namespace math
 {
@@ -10,22 +11,14 @@ namespace math
 	public:
 		constexpr Coordinates() : components() {}
 		constexpr Coordinates(const T& value) { *this = value; }
-		constexpr Coordinates(const Coordinates& rhs) { copy_components<0>(rhs); }
-		constexpr Coordinates(Coordinates&& rhs) noexcept { move_components<0>(rhs); }
+		constexpr Coordinates(const Coordinates& rhs) = default;
+		constexpr Coordinates(Coordinates&& rhs) noexcept = default;
 
-		constexpr Coordinates& operator= (const Coordinates& rhs)
-		{
-			copy_components<0>(rhs);
-			return *this;
-		}
-		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept
-		{
-			move_components<0>(rhs);
-			return *this;
-		}
+		constexpr Coordinates& operator= (const Coordinates& rhs) = default;
+		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept = default;
 		constexpr Coordinates& operator= (const T& value)
 		{
-			copy_components<0>(value);
+			fill_components(value);
 			return *this;
 		}
 
@@ -37,28 +30,10 @@ namespace math
 		T components[D];
 
 	private:
-		template<size_t C>
-		constexpr void copy_components(const T& value)
-		{
-			components[C] = value;
-			if constexpr (C < D - 1)
-				copy_components<C + 1>(value);
-		}
-
-		template<size_t C>
-		constexpr void copy_components(const Coordinates& coordinates)
-		{
-			components[C] = coordinates.components[C];
-			if constexpr (C < D - 1)
-				copy_components<C + 1>(coordinates);
-		}
-
-		template<size_t C>
-		constexpr void move_components(Coordinates& coordinates) noexcept
+		constexpr void fill_components(const T& value)
 		{
-			components[C] = std::move(coordinates.components[C]);
-			if constexpr (C < D - 1)
-				copy_components<C + 1>(coordinates);
+			for (size_t i = 0; i < D; ++i)
+				components[i] = value;
 		}
 	};
 
@@ -67,19 +42,11 @@ namespace math
 	{
 		constexpr Coordinates() : x(0) {}
 		constexpr Coordinates(const T& x) : x(x) {}
-		constexpr Coordinates(const Coordinates& rhs) : x(rhs.x) {}
-		constexpr Coordinates(Coordinates&& rhs) noexcept : x(std::move(rhs.x)) {}
+		constexpr Coordinates(const Coordinates& rhs) = default;
+		constexpr Coordinates(Coordinates&& rhs) noexcept = default;
 
-		constexpr Coordinates& operator= (const Coordinates& rhs)
-		{
-			x = rhs.x;
-			return *this;
-		}
-		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept
-		{
-			x = std::move(rhs.x);
-			return *this;
-		}
+		constexpr Coordinates& operator= (const Coordinates& rhs) = default;
+		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept = default;
 		constexpr Coordinates& operator= (const T& x)
 		{
 			this->x = x;
@@ -87,12 +54,18 @@ namespace math
 		}
 
 		template<size_t C>
-		constexpr const T& get_component() const { static_assert(C < 1, "component index out of range"); }
-		template<> constexpr const T& get_component<0>() const { return x; }
+		constexpr const T& get_component() const
+		{
+			static_assert(C < 1, "component index out of range");
+			return x;
+		}
 
 		template<size_t C>
-		constexpr T& get_component() { static_assert(C < 1, "component index out of range"); }
-		template<> constexpr T& get_component<0>() { return x; }
+		constexpr T& get_component()
+		{
+			static_assert(C < 1, "component index out of range");
+			return x;
+		}
 
 		T x;
 	};
@@ -103,21 +76,11 @@ namespace math
 		constexpr Coordinates() : x(0), y(0) {}
 		constexpr Coordinates(const T& value) : x(value), y(value) {}
 		constexpr Coordinates(const T& x, const T& y) : x(x), y(y) {}
-		constexpr Coordinates(const Coordinates& rhs) : x(rhs.x), y(rhs.y) {}
-		constexpr Coordinates(Coordinates&& rhs) noexcept : x(std::move(rhs.x)), y(std::move(rhs.y)) {}
+		constexpr Coordinates(const Coordinates& rhs) = default;
+		constexpr Coordinates(Coordinates&& rhs) noexcept = default;
 
-		constexpr Coordinates& operator= (const Coordinates& rhs)
-		{
-			x = rhs.x;
-			y = rhs.y;
-			return *this;
-		}
-		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept
-		{
-			x = std::move(rhs.x);
-			y = std::move(rhs.y);
-			return *this;
-		}
+		constexpr Coordinates& operator= (const Coordinates& rhs) = default;
+		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept = default;
 		constexpr Coordinates& operator= (const T& value)
 		{
 			x = value;
@@ -126,42 +89,40 @@ namespace math
 		}
 
 		template<size_t C>
-		constexpr const T& get_component() const { static_assert(C < 2, "component index out of range"); }
-		template<> constexpr const T& get_component<0>() const { return x; }
-		template<> constexpr const T& get_component<1>() const { return y; }
+		constexpr const T& get_component() const
+		{
+			static_assert(C < 2, "component index out of range");
+			if constexpr (C == 0)
+				return x;
+			else
+				return y;
+		}
 
 		template<size_t C>
-		constexpr T& get_component() { static_assert(C < 2, "component index out of range"); }
-		template<> constexpr T& get_component<0>() { return x; }
-		template<> constexpr T& get_component<1>() { return y; }
+		constexpr T& get_component()
+		{
+			static_assert(C < 2, "component index out of range");
+			if constexpr (C == 0)
+				return x;
+			else
+				return y;
+		}
 
 		T x;
 		T y;
 	};
 
 	template<typename T>
-	struct Coordinates<3, T> : public TupleBase<3, T>
+	struct alignas(detail::SimdRegister<T, 3>::alignment) Coordinates<3, T> : public TupleBase<3, T>
 	{
 		constexpr Coordinates() : x(0), y(0), z(0) {}
 		constexpr Coordinates(const T& value) : x(value), y(value), z(value) {}
 		constexpr Coordinates(const T& x, const T& y, const T& z) : x(x), y(y), z(z) {}
-		constexpr Coordinates(const Coordinates& rhs) : x(rhs.x), y(rhs.y), z(rhs.z) {}
-		constexpr Coordinates(Coordinates&& rhs) noexcept : x(std::move(rhs.x)), y(std::move(rhs.y)), z(std::move(rhs.z)) {}
+		constexpr Coordinates(const Coordinates& rhs) = default;
+		constexpr Coordinates(Coordinates&& rhs) noexcept = default;
 
-		constexpr Coordinates& operator= (const Coordinates& rhs)
-		{
-			x = rhs.x;
-			y = rhs.y;
-			z = rhs.z;
-			return *this;
-		}
-		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept
-		{
-			x = std::move(rhs.x);
-			y = std::move(rhs.y);
-			z = std::move(rhs.z);
-			return *this;
-		}
+		constexpr Coordinates& operator= (const Coordinates& rhs) = default;
+		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept = default;
 		constexpr Coordinates& operator= (const T& value)
 		{
 			x = value;
@@ -171,16 +132,28 @@ namespace math
 		}
 
 		template<size_t C>
-		constexpr const T& get_component() const { static_assert(C < 3, "component index out of range"); }
-		template<> constexpr const T& get_component<0>() const { return x; }
-		template<> constexpr const T& get_component<1>() const { return y; }
-		template<> constexpr const T& get_component<2>() const { return z; }
+		constexpr const T& get_component() const
+		{
+			static_assert(C < 3, "component index out of range");
+			if constexpr (C == 0)
+				return x;
+			else if constexpr (C == 1)
+				return y;
+			else
+				return z;
+		}
 
 		template<size_t C>
-		constexpr T& get_component() { static_assert(C < 3, "component index out of range"); }
-		template<> constexpr T& get_component<0>() { return x; }
-		template<> constexpr T& get_component<1>() { return y; }
-		template<> constexpr T& get_component<2>() { return z; }
+		constexpr T& get_component()
+		{
+			static_assert(C < 3, "component index out of range");
+			if constexpr (C == 0)
+				return x;
+			else if constexpr (C == 1)
+				return y;
+			else
+				return z;
+		}
 
 		T x;
 		T y;
@@ -188,30 +161,16 @@ namespace math
 	};
 
 	template<typename T>
-	struct Coordinates<4, T> : public TupleBase<4, T>
+	struct alignas(detail::SimdRegister<T, 4>::alignment) Coordinates<4, T> : public TupleBase<4, T>
 	{
 		constexpr Coordinates() : x(0), y(0), z(0), w(0) {}
 		constexpr Coordinates(const T& value) : x(value), y(value), z(value), w(value) {}
 		constexpr Coordinates(const T& x, const T& y, const T& z, const T& w) : x(x), y(y), z(z), w(w) {}
-		constexpr Coordinates(const Coordinates& rhs) : x(rhs.x), y(rhs.y), z(rhs.z), w(rhs.w) {}
-		constexpr Coordinates(Coordinates&& rhs) noexcept : x(std::move(rhs.x)), y(std::move(rhs.y)), z(std::move(rhs.z)), w(std::move(rhs.w)) {}
+		constexpr Coordinates(const Coordinates& rhs) = default;
+		constexpr Coordinates(Coordinates&& rhs) noexcept = default;
 
-		constexpr Coordinates& operator= (const Coordinates& rhs)
-		{
-			x = rhs.x;
-			y = rhs.y;
-			z = rhs.z;
-			w = rhs.w;
-			return *this;
-		}
-		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept
-		{
-			x = std::move(rhs.x);
-			y = std::move(rhs.y);
-			z = std::move(rhs.z);
-			w = std::move(rhs.w);
-			return *this;
-		}
+		constexpr Coordinates& operator= (const Coordinates& rhs) = default;
+		constexpr Coordinates& operator= (Coordinates&& rhs) noexcept = default;
 		constexpr Coordinates& operator= (const T& value)
 		{
 			x = value;
@@ -221,25 +180,41 @@ namespace math
 			return *this;
 		}
 
-		template<size_t C> 
-		constexpr const T& get_component() const { static_assert(C < 4, "component index out of range"); }
-		template<> constexpr const T& get_component<0>() const { return x; }
-		template<> constexpr const T& get_component<1>() const { return y; }
-		template<> constexpr const T& get_component<2>() const { return z; }
-		template<> constexpr const T& get_component<3>() const { return w; }
+		template<size_t C>
+		constexpr const T& get_component() const
+		{
+			static_assert(C < 4, "component index out of range");
+			if constexpr (C == 0)
+				return x;
+			else if constexpr (C == 1)
+				return y;
+			else if constexpr (C == 2)
+				return z;
+			else
+				return w;
+		}
 
 		template<size_t C>
-		constexpr T& get_component() { static_assert(C < 4, "component index out of range"); }
-		template<> constexpr T& get_component<0>() { return x; }
-		template<> constexpr T& get_component<1>() { return y; }
-		template<> constexpr T& get_component<2>() { return z; }
-		template<> constexpr T& get_component<3>() { return w; }
+		constexpr T& get_component()
+		{
+			static_assert(C < 4, "component index out of range");
+			if constexpr (C == 0)
+				return x;
+			else if constexpr (C == 1)
+				return y;
+			else if constexpr (C == 2)
+				return z;
+			else
+				return w;
+		}
 
 		T x;
 		T y;
 		T z;
 		T w;
 	};
+
+	static_assert(detail::trivial_tuples<Coordinates, float>() && detail::trivial_tuples<Coordinates, double>() && detail::trivial_tuples<Coordinates, int>());
 }
 
 #include "TupleOperations.h"
\ No newline at end of file
@@ -0,0 +1,416 @@
+#pragma once
+#include <cassert>
+#include <span>
+#include <vector>
+#include "Coordinates.h"
+#include "Allocator.h"
+#include "Sqrt.h"
+
+namespace math
+{
+	template<size_t D, typename T>
+	requires is_arithmetic_v<T>
+	struct CoordinatesSoA;
+
+	template<size_t D, typename T, bool Const>
+	struct CoordinatesSoAReference : public TupleBase<D, T>
+	{
+	public:
+		using container_type = std::conditional_t<Const, const CoordinatesSoA<D, T>, CoordinatesSoA<D, T>>;
+		using reference = std::conditional_t<Const, const T&, T&>;
+
+		constexpr CoordinatesSoAReference(container_type& soa, size_t index) : soa(&soa), index(index) {}
+		constexpr CoordinatesSoAReference(const CoordinatesSoAReference& rhs) = default;
+		constexpr CoordinatesSoAReference(const CoordinatesSoAReference<D, T, false>& rhs) requires Const : soa(rhs.container()), index(rhs.position()) {}
+
+		constexpr CoordinatesSoAReference& operator= (const CoordinatesSoAReference& rhs) requires (!Const)
+		{
+			store(rhs);
+			return *this;
+		}
+		template<SameTuple<D, T> U>
+		constexpr CoordinatesSoAReference& operator= (const U& tuple) requires (!Const)
+		{
+			store(tuple);
+			return *this;
+		}
+
+		constexpr operator Coordinates<D, T>() const { return load(); }
+
+		template<SameTuple<D, T> U = Coordinates<D, T>>
+		constexpr U load() const
+		{
+			U tuple;
+			load_components(tuple, std::make_index_sequence<D>());
+			return tuple;
+		}
+		template<SameTuple<D, T> U>
+		constexpr void store(const U& tuple) const requires (!Const)
+		{
+			store_components(tuple, std::make_index_sequence<D>());
+		}
+
+		template<size_t C>
+		constexpr reference get_component() const { static_assert(C < D, "component index out of range"); return soa->components[C][index]; }
+
+		constexpr container_type* container() const { return soa; }
+		constexpr size_t position() const { return index; }
+
+	private:
+		template<typename U, size_t... C>
+		constexpr void load_components(U& tuple, std::index_sequence<C...>) const
+		{
+			((tuple.template get_component<C>() = get_component<C>()), ...);
+		}
+		template<typename U, size_t... C>
+		constexpr void store_components(const U& tuple, std::index_sequence<C...>) const
+		{
+			((get_component<C>() = tuple.template get_component<C>()), ...);
+		}
+
+		container_type* soa;
+		size_t index;
+	};
+
+	template<size_t D, typename T>
+	requires is_arithmetic_v<T>
+	struct CoordinatesSoA
+	{
+	public:
+		using value_type = T;
+		using column_type = std::vector<T, AlignedAllocator<T>>;
+		using reference = CoordinatesSoAReference<D, T, false>;
+		using const_reference = CoordinatesSoAReference<D, T, true>;
+		static constexpr size_t dimensions = D;
+
+		CoordinatesSoA() : components() {}
+		explicit CoordinatesSoA(size_t size) : components() { resize(size); }
+		CoordinatesSoA(size_t size, const Coordinates<D, T>& value) : components() { resize(size, value); }
+		template<typename It>
+		CoordinatesSoA(It first, It last) : components()
+		{
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+
+		size_t size() const { return components[0].size(); }
+		bool empty() const { return components[0].empty(); }
+
+		void reserve(size_t capacity)
+		{
+			for (column_type& column : components)
+				column.reserve(capacity);
+		}
+		void resize(size_t size)
+		{
+			for (column_type& column : components)
+				column.resize(size);
+		}
+		void resize(size_t size, const Coordinates<D, T>& value)
+		{
+			const size_t first = this->size();
+			resize(size);
+			for (size_t i = first; i < size; ++i)
+				(*this)[i] = value;
+		}
+		void clear()
+		{
+			for (column_type& column : components)
+				column.clear();
+		}
+
+		template<SameTuple<D, T> U>
+		void push_back(const U& tuple)
+		{
+			push_back_components(tuple, std::make_index_sequence<D>());
+		}
+
+		reference operator[] (size_t index) { return reference(*this, index); }
+		const_reference operator[] (size_t index) const { return const_reference(*this, index); }
+
+		T* data(size_t component) { return components[component].data(); }
+		const T* data(size_t component) const { return components[component].data(); }
+
+		template<size_t C>
+		std::span<T> component() { static_assert(C < D, "component index out of range"); return components[C]; }
+		template<size_t C>
+		std::span<const T> component() const { static_assert(C < D, "component index out of range"); return components[C]; }
+
+		column_type components[D];
+
+	private:
+		template<typename U, size_t... C>
+		void push_back_components(const U& tuple, std::index_sequence<C...>)
+		{
+			(components[C].push_back(tuple.template get_component<C>()), ...);
+		}
+	};
+
+	template<size_t D, typename T, bool Const>
+	static constexpr Coordinates<D, T> operator+ (const CoordinatesSoAReference<D, T, Const>& a, const CoordinatesSoAReference<D, T, Const>& b)
+	{
+		return a.load() + b.load();
+	}
+	template<size_t D, typename T, bool Const>
+	static constexpr Coordinates<D, T> operator- (const CoordinatesSoAReference<D, T, Const>& a, const CoordinatesSoAReference<D, T, Const>& b)
+	{
+		return a.load() - b.load();
+	}
+	template<size_t D, typename T, bool Const>
+	static constexpr Coordinates<D, T> operator* (const CoordinatesSoAReference<D, T, Const>& tuple, const std::type_identity_t<T>& scalar)
+	{
+		return tuple.load() * scalar;
+	}
+	template<size_t D, typename T, bool Const>
+	static constexpr Coordinates<D, T> operator* (const std::type_identity_t<T>& scalar, const CoordinatesSoAReference<D, T, Const>& tuple)
+	{
+		return tuple.load() * scalar;
+	}
+	template<size_t D, typename T, bool Const>
+	static constexpr Coordinates<D, T> operator/ (const CoordinatesSoAReference<D, T, Const>& tuple, const std::type_identity_t<T>& scalar)
+	{
+		return tuple.load() / scalar;
+	}
+
+	namespace detail
+	{
+		template<typename O, size_t D, typename T>
+		static void soa_operation(CoordinatesSoA<D, T>& out, const CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b)
+		{
+			assert(a.size() == b.size() && out.size() == a.size());
+			const size_t size = a.size();
+			for (size_t c = 0; c < D; ++c)
+			{
+				T* __restrict po = out.data(c);
+				const T* __restrict pa = a.data(c);
+				const T* __restrict pb = b.data(c);
+				for (size_t i = 0; i < size; ++i)
+					po[i] = O::operation(pa[i], pb[i]);
+			}
+		}
+		template<typename O, size_t D, typename T>
+		static void soa_operation_self(CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b)
+		{
+			assert(a.size() == b.size());
+			const size_t size = a.size();
+			for (size_t c = 0; c < D; ++c)
+			{
+				T* pa = a.data(c);
+				const T* pb = b.data(c);
+				for (size_t i = 0; i < size; ++i)
+					O::operation_self(pa[i], pb[i]);
+			}
+		}
+		template<typename O, size_t D, typename T>
+		static void soa_operation_scalar(CoordinatesSoA<D, T>& out, const CoordinatesSoA<D, T>& soa, const T scalar)
+		{
+			assert(out.size() == soa.size());
+			const size_t size = soa.size();
+			for (size_t c = 0; c < D; ++c)
+			{
+				T* __restrict po = out.data(c);
+				const T* __restrict ps = soa.data(c);
+				for (size_t i = 0; i < size; ++i)
+					po[i] = O::operation(ps[i], scalar);
+			}
+		}
+		template<typename O, size_t D, typename T>
+		static void soa_operation_scalar_self(CoordinatesSoA<D, T>& soa, const T scalar)
+		{
+			const size_t size = soa.size();
+			for (size_t c = 0; c < D; ++c)
+			{
+				T* __restrict ps = soa.data(c);
+				for (size_t i = 0; i < size; ++i)
+					O::operation_self(ps[i], scalar);
+			}
+		}
+
+		template<size_t D, typename T>
+		static bool soa_equals(const CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b)
+		{
+			if (a.size() != b.size())
+				return false;
+			const size_t size = a.size();
+			for (size_t c = 0; c < D; ++c)
+			{
+				const T* __restrict pa = a.data(c);
+				const T* __restrict pb = b.data(c);
+				bool equals = true;
+				for (size_t i = 0; i < size; ++i)
+					equals &= pa[i] == pb[i];
+				if (!equals)
+					return false;
+			}
+			return true;
+		}
+
+		template<size_t D, typename T>
+		static void soa_distance_sq(const CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b, std::span<T> out)
+		{
+			assert(a.size() == b.size() && out.size() >= a.size());
+			const size_t size = a.size();
+			T* __restrict po = out.data();
+			for (size_t i = 0; i < size; ++i)
+				po[i] = 0;
+			for (size_t c = 0; c < D; ++c)
+			{
+				const T* __restrict pa = a.data(c);
+				const T* __restrict pb = b.data(c);
+				for (size_t i = 0; i < size; ++i)
+				{
+					const T distance = pb[i] - pa[i];
+					po[i] += distance * distance;
+				}
+			}
+		}
+		template<size_t C, Tuple P, size_t D, typename T>
+		static void soa_distance_sq_component(const CoordinatesSoA<D, T>& a, const P& point, std::span<T> out)
+		{
+			const size_t size = a.size();
+			const T component = point.template get_component<C>();
+			T* __restrict po = out.data();
+			const T* __restrict pa = a.data(C);
+			for (size_t i = 0; i < size; ++i)
+			{
+				const T distance = component - pa[i];
+				if constexpr (C == 0)
+					po[i] = distance * distance;
+				else
+					po[i] += distance * distance;
+			}
+		}
+		template<Tuple P, size_t D, typename T, size_t... C>
+		static void soa_distance_sq_point(const CoordinatesSoA<D, T>& a, const P& point, std::span<T> out, std::index_sequence<C...>)
+		{
+			assert(out.size() >= a.size());
+			(soa_distance_sq_component<C>(a, point, out), ...);
+		}
+	}
+
+	template<size_t D, typename T>
+	static bool operator== (const CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b)
+	{
+		return detail::soa_equals(a, b);
+	}
+	template<size_t D, typename T>
+	static bool operator!= (const CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b)
+	{
+		return !detail::soa_equals(a, b);
+	}
+
+	template<size_t D, typename T>
+	static CoordinatesSoA<D, T> operator+ (const CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b)
+	{
+		CoordinatesSoA<D, T> result(a.size());
+		detail::soa_operation<detail::TupleAddition<Coordinates<D, T>>>(result, a, b);
+		return result;
+	}
+	template<size_t D, typename T>
+	static CoordinatesSoA<D, T> operator- (const CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b)
+	{
+		CoordinatesSoA<D, T> result(a.size());
+		detail::soa_operation<detail::TupleSubtraction<Coordinates<D, T>>>(result, a, b);
+		return result;
+	}
+
+	template<size_t D, typename T>
+	static CoordinatesSoA<D, T>& operator+= (CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b)
+	{
+		detail::soa_operation_self<detail::TupleAddition<Coordinates<D, T>>>(a, b);
+		return a;
+	}
+	template<size_t D, typename T>
+	static CoordinatesSoA<D, T>& operator-= (CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b)
+	{
+		detail::soa_operation_self<detail::TupleSubtraction<Coordinates<D, T>>>(a, b);
+		return a;
+	}
+
+	template<size_t D, typename T>
+	static CoordinatesSoA<D, T> operator* (const CoordinatesSoA<D, T>& soa, const std::type_identity_t<T>& scalar)
+	{
+		CoordinatesSoA<D, T> result(soa.size());
+		detail::soa_operation_scalar<detail::TupleMultiplication<Coordinates<D, T>>>(result, soa, scalar);
+		return result;
+	}
+	template<size_t D, typename T>
+	static CoordinatesSoA<D, T> operator/ (const CoordinatesSoA<D, T>& soa, const std::type_identity_t<T>& scalar)
+	{
+		CoordinatesSoA<D, T> result(soa.size());
+		detail::soa_operation_scalar<detail::TupleDivision<Coordinates<D, T>>>(result, soa, scalar);
+		return result;
+	}
+	template<size_t D, typename T>
+	static CoordinatesSoA<D, T> operator* (const std::type_identity_t<T>& scalar, const CoordinatesSoA<D, T>& soa)
+	{
+		CoordinatesSoA<D, T> result(soa.size());
+		detail::soa_operation_scalar<detail::TupleMultiplication<Coordinates<D, T>>>(result, soa, scalar);
+		return result;
+	}
+	template<size_t D, typename T>
+	static CoordinatesSoA<D, T>& operator*= (CoordinatesSoA<D, T>& soa, const std::type_identity_t<T>& scalar)
+	{
+		detail::soa_operation_scalar_self<detail::TupleMultiplication<Coordinates<D, T>>>(soa, scalar);
+		return soa;
+	}
+	template<size_t D, typename T>
+	static CoordinatesSoA<D, T>& operator/= (CoordinatesSoA<D, T>& soa, const std::type_identity_t<T>& scalar)
+	{
+		detail::soa_operation_scalar_self<detail::TupleDivision<Coordinates<D, T>>>(soa, scalar);
+		return soa;
+	}
+
+	// y += alpha * x, column by column.
+	template<size_t D, typename T>
+	static void axpy(const std::type_identity_t<T>& alpha, const CoordinatesSoA<D, T>& x, CoordinatesSoA<D, T>& y)
+	{
+		assert(x.size() == y.size());
+		const size_t size = y.size();
+		for (size_t c = 0; c < D; ++c)
+		{
+			T* __restrict py = y.data(c);
+			const T* __restrict px = x.data(c);
+			for (size_t i = 0; i < size; ++i)
+				py[i] = detail::fused_multiply_add(px[i], alpha, py[i]);
+		}
+	}
+
+	template<size_t D, typename T>
+	static void distance_sq(const CoordinatesSoA<D, T>& a, const CoordinatesSoA<D, T>& b, std::span<std::type_identity_t<T>> out)
+	{
+		detail::soa_distance_sq(a, b, out);
+	}
+	template<size_t D, typename T, SameTuple<D, T> P>
+	static void distance_sq(const CoordinatesSoA<D, T>& a, const P& point, std::span<std::type_identity_t<T>> out)
+	{
+		detail::soa_distance_sq_point(a, point, out, std::make_index_sequence<D>());
+	}
+
+	template<Precision P = Precision::exact, size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static void normalise(CoordinatesSoA<D, T>& soa)
+	{
+		constexpr size_t chunk = 1024;
+		alignas(64) T scales[chunk];
+		for (size_t first = 0; first < soa.size(); first += chunk)
+		{
+			const size_t count = soa.size() - first < chunk ? soa.size() - first : chunk;
+			for (size_t i = 0; i < count; ++i)
+				scales[i] = 0;
+			for (size_t c = 0; c < D; ++c)
+			{
+				const T* __restrict pc = soa.data(c) + first;
+				for (size_t i = 0; i < count; ++i)
+					scales[i] += pc[i] * pc[i];
+			}
+			rsqrt<P>(std::span<const T>(scales, count), std::span<T>(scales, count));
+			for (size_t c = 0; c < D; ++c)
+			{
+				T* __restrict pc = soa.data(c) + first;
+				for (size_t i = 0; i < count; ++i)
+					pc[i] *= scales[i];
+			}
+		}
+	}
+}
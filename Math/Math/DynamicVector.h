@@ -0,0 +1,310 @@
+#pragma once
+#include <cassert>
+#include <initializer_list>
+#include <span>
+#include <vector>
+#include "Allocator.h"
+#include "Accumulation.h"
+#include "Angle.h"
+#include "Sqrt.h"
+
+namespace math
+{
+	namespace detail
+	{
+		// Runs function<V>(i) over [0, size): a pack at a time, then one component at a time for the rest.
+		template<typename T, typename F>
+		static void span_for(size_t size, const F& function)
+		{
+			using V = widest_pack<T>;
+			constexpr size_t lanes = pack_traits<V>::lanes;
+			size_t i = 0;
+			if constexpr (lanes > 1)
+				for (; i + lanes <= size; i += lanes)
+					function.template operator()<V>(i);
+			for (; i < size; ++i)
+				function.template operator()<T>(i);
+		}
+
+		template<typename T>
+		static T span_distance_sq(const T* a, const T* b, size_t size)
+		{
+			using V = widest_pack<T>;
+			constexpr size_t lanes = pack_traits<V>::lanes;
+			size_t i = 0;
+			T distance = T(0);
+			if constexpr (lanes > 1)
+			{
+				V sums[accumulation_packs];
+				for (size_t p = 0; p < accumulation_packs; ++p)
+					sums[p] = V(0);
+				for (; i + lanes * accumulation_packs <= size; i += lanes * accumulation_packs)
+					for (size_t p = 0; p < accumulation_packs; ++p)
+					{
+						const V component = load<V>(b + i + p * lanes) - load<V>(a + i + p * lanes);
+						sums[p] = fused_multiply_add(component, component, sums[p]);
+					}
+				for (; i + lanes <= size; i += lanes)
+				{
+					const V component = load<V>(b + i) - load<V>(a + i);
+					sums[0] = fused_multiply_add(component, component, sums[0]);
+				}
+				distance = lane_sum((sums[0] + sums[1]) + (sums[2] + sums[3]));
+			}
+			for (; i < size; ++i)
+			{
+				const T component = b[i] - a[i];
+				distance = fused_multiply_add(component, component, distance);
+			}
+			return distance;
+		}
+
+		// Measures for the row kernels: add accumulates one pack of a row against the query into the row's sums,
+		// finish turns the sums into the result given the squared length of the query.
+		struct RowDot
+		{
+			static constexpr size_t sums = 1;
+			template<typename V>
+			static void add(V (&sums)[1], const V& row, const V& query) { sums[0] = fused_multiply_add(row, query, sums[0]); }
+			template<typename T>
+			static T finish(const T (&sums)[1], const T&) { return sums[0]; }
+		};
+		struct RowDistanceSq
+		{
+			static constexpr size_t sums = 1;
+			template<typename V>
+			static void add(V (&sums)[1], const V& row, const V& query)
+			{
+				const V component = row - query;
+				sums[0] = fused_multiply_add(component, component, sums[0]);
+			}
+			template<typename T>
+			static T finish(const T (&sums)[1], const T&) { return sums[0]; }
+		};
+		struct RowCosine
+		{
+			static constexpr size_t sums = 2;
+			template<typename V>
+			static void add(V (&sums)[2], const V& row, const V& query)
+			{
+				sums[0] = fused_multiply_add(row, query, sums[0]);
+				sums[1] = fused_multiply_add(row, row, sums[1]);
+			}
+			template<typename T>
+			static T finish(const T (&sums)[2], const T& query_sq) { return sums[0] / sqrt(sums[1] * query_sq); }
+		};
+
+		// Measures Rows consecutive rows against the query in one pass, so every pack of the query is loaded once
+		// for all of them.
+		template<typename M, size_t Rows, typename T>
+		static void row_block(const T* rows, const T* query, size_t size, const T& query_sq, T* out)
+		{
+			using V = widest_pack<T>;
+			constexpr size_t lanes = pack_traits<V>::lanes;
+			V sums[Rows][M::sums];
+			for (size_t r = 0; r < Rows; ++r)
+				for (size_t s = 0; s < M::sums; ++s)
+					sums[r][s] = V(0);
+			size_t i = 0;
+			for (; i + lanes <= size; i += lanes)
+			{
+				const V q = load<V>(query + i);
+				for (size_t r = 0; r < Rows; ++r)
+					M::add(sums[r], load<V>(rows + r * size + i), q);
+			}
+			for (size_t r = 0; r < Rows; ++r)
+			{
+				T totals[M::sums];
+				for (size_t s = 0; s < M::sums; ++s)
+					totals[s] = lane_sum(sums[r][s]);
+				for (size_t j = i; j < size; ++j)
+					M::add(totals, rows[r * size + j], query[j]);
+				out[r] = M::finish(totals, query_sq);
+			}
+		}
+		template<typename M, typename T>
+		static void row_kernel(std::span<const T> rows, std::span<const T> query, std::span<T> out)
+		{
+			constexpr size_t block = 4;
+			const size_t size = query.size();
+			assert(rows.size() == out.size() * size);
+			const T query_sq = M::sums > 1 ? naive_sum<true>(query.data(), query.data(), size) : T(0);
+			size_t row = 0;
+			for (; row + block <= out.size(); row += block)
+				row_block<M, block>(rows.data() + row * size, query.data(), size, query_sq, out.data() + row);
+			for (; row < out.size(); ++row)
+				row_block<M, 1>(rows.data() + row * size, query.data(), size, query_sq, out.data() + row);
+		}
+	}
+
+	// A vector whose size is chosen at run time, for embeddings and feature vectors of hundreds or thousands of
+	// components. Components are stored 64-byte aligned and every operation runs on the widest pack. Vectors combined
+	// by an operation must have the same size.
+	template<typename T>
+	requires std::is_floating_point_v<T>
+	struct DynamicVector
+	{
+	public:
+		using value_type = T;
+		using storage_type = std::vector<T, AlignedAllocator<T>>;
+
+		DynamicVector() : components() {}
+		explicit DynamicVector(size_t size) : components(size) {}
+		DynamicVector(size_t size, const T& value) : components(size, value) {}
+		DynamicVector(std::span<const T> values) : components(values.begin(), values.end()) {}
+		DynamicVector(std::initializer_list<T> values) : components(values) {}
+
+		size_t size() const { return components.size(); }
+		bool empty() const { return components.empty(); }
+		void resize(size_t size) { components.resize(size); }
+
+		T* data() { return components.data(); }
+		const T* data() const { return components.data(); }
+		T& operator[] (size_t index) { return components[index]; }
+		const T& operator[] (size_t index) const { return components[index]; }
+		operator std::span<T>() { return components; }
+		operator std::span<const T>() const { return components; }
+
+		DynamicVector& operator+= (const DynamicVector& rhs)
+		{
+			assert(size() == rhs.size());
+			T* out = data();
+			const T* in = rhs.data();
+			detail::span_for<T>(size(), [&]<typename V>(size_t i) { detail::store(out + i, detail::load<V>(out + i) + detail::load<V>(in + i)); });
+			return *this;
+		}
+		DynamicVector& operator-= (const DynamicVector& rhs)
+		{
+			assert(size() == rhs.size());
+			T* out = data();
+			const T* in = rhs.data();
+			detail::span_for<T>(size(), [&]<typename V>(size_t i) { detail::store(out + i, detail::load<V>(out + i) - detail::load<V>(in + i)); });
+			return *this;
+		}
+		DynamicVector& operator*= (const T& scalar)
+		{
+			T* out = data();
+			detail::span_for<T>(size(), [&]<typename V>(size_t i) { detail::store(out + i, detail::load<V>(out + i) * V(scalar)); });
+			return *this;
+		}
+		DynamicVector& operator/= (const T& scalar)
+		{
+			return *this *= T(1) / scalar;
+		}
+
+		bool operator== (const DynamicVector& rhs) const { return components == rhs.components; }
+
+		template<Accumulation A = Accumulation::naive>
+		T magnitude_sq() const
+		{
+			Accumulator<A, T> sum;
+			sum.add_products(components, components);
+			return sum.result();
+		}
+		template<Accumulation A = Accumulation::naive>
+		T length_sq() const { return magnitude_sq<A>(); }
+		template<Precision P = Precision::exact, Accumulation A = Accumulation::naive>
+		T magnitude() const { return sqrt<P>(magnitude_sq<A>()); }
+		template<Accumulation A>
+		T magnitude() const { return sqrt(magnitude_sq<A>()); }
+		template<Precision P = Precision::exact, Accumulation A = Accumulation::naive>
+		T length() const { return sqrt<P>(length_sq<A>()); }
+		template<Accumulation A>
+		T length() const { return sqrt(length_sq<A>()); }
+
+		template<Precision P = Precision::exact>
+		DynamicVector normalised() const
+		{
+			DynamicVector out(*this);
+			out.template normalise<P>();
+			return out;
+		}
+		template<Precision P = Precision::exact>
+		void normalise()
+		{
+			*this *= rsqrt<P>(length_sq());
+		}
+
+		storage_type components;
+	};
+
+	template<typename T>
+	static DynamicVector<T> operator+ (const DynamicVector<T>& a, const DynamicVector<T>& b)
+	{
+		DynamicVector<T> result(a);
+		return result += b;
+	}
+	template<typename T>
+	static DynamicVector<T> operator- (const DynamicVector<T>& a, const DynamicVector<T>& b)
+	{
+		DynamicVector<T> result(a);
+		return result -= b;
+	}
+	template<typename T>
+	static DynamicVector<T> operator* (const DynamicVector<T>& vector, const std::type_identity_t<T>& scalar)
+	{
+		DynamicVector<T> result(vector);
+		return result *= scalar;
+	}
+	template<typename T>
+	static DynamicVector<T> operator* (const std::type_identity_t<T>& scalar, const DynamicVector<T>& vector)
+	{
+		return vector * scalar;
+	}
+	template<typename T>
+	static DynamicVector<T> operator/ (const DynamicVector<T>& vector, const std::type_identity_t<T>& scalar)
+	{
+		DynamicVector<T> result(vector);
+		return result /= scalar;
+	}
+
+	template<Accumulation A = Accumulation::naive, typename T>
+	static T dot(const DynamicVector<T>& a, const DynamicVector<T>& b)
+	{
+		assert(a.size() == b.size());
+		Accumulator<A, T> sum;
+		sum.add_products(a.components, b.components);
+		return sum.result();
+	}
+	template<typename T>
+	static T distance_sq(const DynamicVector<T>& a, const DynamicVector<T>& b)
+	{
+		assert(a.size() == b.size());
+		return detail::span_distance_sq(a.data(), b.data(), a.size());
+	}
+	template<Precision P = Precision::exact, typename T>
+	static T distance(const DynamicVector<T>& a, const DynamicVector<T>& b)
+	{
+		return sqrt<P>(distance_sq(a, b));
+	}
+	// The cosine of the angle between a and b; neither may be zero.
+	template<typename T>
+	static T cosine_similarity(const DynamicVector<T>& a, const DynamicVector<T>& b)
+	{
+		return dot(a, b) / sqrt(a.length_sq() * b.length_sq());
+	}
+	template<typename A = double, typename T>
+	static Radians<A> angle(const DynamicVector<T>& a, const DynamicVector<T>& b)
+	{
+		const A cosine = static_cast<A>(cosine_similarity(a, b));
+		return arccos<A>(cosine < A(-1) ? A(-1) : A(1) < cosine ? A(1) : cosine);
+	}
+
+	// One query against many rows: rows holds out.size() vectors of query.size() components one after another, and
+	// out[i] receives the measure between row i and the query. Rows are measured four at a time.
+	template<typename T>
+	static void dot_rows(std::span<const std::type_identity_t<T>> rows, const DynamicVector<T>& query, std::span<T> out)
+	{
+		detail::row_kernel<detail::RowDot>(rows, std::span<const T>(query.components), out);
+	}
+	template<typename T>
+	static void distance_sq_rows(std::span<const std::type_identity_t<T>> rows, const DynamicVector<T>& query, std::span<T> out)
+	{
+		detail::row_kernel<detail::RowDistanceSq>(rows, std::span<const T>(query.components), out);
+	}
+	template<typename T>
+	static void cosine_similarity_rows(std::span<const std::type_identity_t<T>> rows, const DynamicVector<T>& query, std::span<T> out)
+	{
+		detail::row_kernel<detail::RowCosine>(rows, std::span<const T>(query.components), out);
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+#if __has_include(<execution>)
+	#include <execution>
+#endif
+
+namespace math
+{
+	namespace bulk
+	{
+		// An executor runs function(0) ... function(chunks - 1), in any order and on any threads,
+		// and returns once all of them have finished.
+		template<typename E>
+		concept Executor = requires(const E& executor, void (*function)(size_t))
+		{
+			executor(size_t(), function);
+		};
+
+		struct Serial
+		{
+			template<typename F>
+			void operator() (size_t chunks, const F& function) const
+			{
+				for (size_t i = 0; i < chunks; ++i)
+					function(i);
+			}
+		};
+
+#if defined(__cpp_lib_execution)
+		// std::execution::par_unseq; with libstdc++ this needs the TBB backend linked in to actually run in parallel.
+		struct Parallel
+		{
+			template<typename F>
+			void operator() (size_t chunks, const F& function) const
+			{
+				std::vector<size_t> indices(chunks);
+				std::iota(indices.begin(), indices.end(), size_t(0));
+				std::for_each(std::execution::par_unseq, indices.begin(), indices.end(), [&](size_t i) { function(i); });
+			}
+		};
+#endif
+
+		// Fork-join pool: the calling thread works along with the workers and returns when every chunk is done.
+		// Calls from several threads are serialised; a chunk must not submit work to the pool it runs on.
+		class ThreadPool
+		{
+		public:
+			ThreadPool(size_t threads = std::thread::hardware_concurrency())
+			{
+				for (size_t i = 1; i < threads; ++i)
+					workers.emplace_back([this] { work(); });
+			}
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator= (const ThreadPool&) = delete;
+			~ThreadPool()
+			{
+				{
+					std::lock_guard lock(mutex);
+					stopping = true;
+				}
+				wake.notify_all();
+			}
+
+			size_t size() const { return workers.size() + 1; }
+
+			template<typename F>
+			void operator() (size_t chunks, const F& function) const
+			{
+				if (chunks == 0)
+					return;
+
+				std::lock_guard submitting(submission);
+				{
+					// a worker that woke too late for the previous job may still be reading it
+					std::unique_lock lock(mutex);
+					done.wait(lock, [this] { return active == 0; });
+					job = { &function, [](const void* f, size_t i) { (*static_cast<const F*>(f))(i); }, chunks };
+					next = 0;
+					++generation;
+				}
+				wake.notify_all();
+				run();
+
+				std::unique_lock lock(mutex);
+				done.wait(lock, [this] { return active == 0; });
+			}
+
+		private:
+			struct Job
+			{
+				const void* function = nullptr;
+				void (*invoke)(const void*, size_t) = nullptr;
+				size_t chunks = 0;
+			};
+
+			void run() const
+			{
+				for (size_t i = next.fetch_add(1); i < job.chunks; i = next.fetch_add(1))
+					job.invoke(job.function, i);
+			}
+
+			void work() const
+			{
+				size_t seen = 0;
+				while (true)
+				{
+					{
+						std::unique_lock lock(mutex);
+						wake.wait(lock, [&] { return stopping || generation != seen; });
+						if (stopping)
+							return;
+						seen = generation;
+						++active;
+					}
+					run();
+					{
+						std::lock_guard lock(mutex);
+						--active;
+					}
+					done.notify_all();
+				}
+			}
+
+			mutable std::mutex submission;
+			mutable std::mutex mutex;
+			mutable std::condition_variable wake;
+			mutable std::condition_variable done;
+			mutable Job job;
+			mutable std::atomic<size_t> next = 0;
+			mutable size_t generation = 0;
+			mutable size_t active = 0;
+			bool stopping = false;
+			std::vector<std::jthread> workers;
+		};
+
+		static constexpr Serial serial;
+#if defined(__cpp_lib_execution)
+		static constexpr Parallel parallel;
+#endif
+	}
+}
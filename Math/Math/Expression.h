@@ -0,0 +1,235 @@
+#pragma once
+#include <cassert>
+#include <concepts>
+#include <span>
+#include "TupleOperations.h"
+#include "CoordinatesSoA.h"
+
+namespace math
+{
+	// Opt-in lazy arithmetic: lazy(x) wraps a tuple, a span of tuples or a CoordinatesSoA, and +, - and scalar * and /
+	// on the result build expression nodes instead of temporaries. Nothing is computed until the expression is assigned,
+	// which then happens in a single pass, component by component:
+	//     assign(positions, lazy(positions) + lazy(velocities) * dt);
+	// Every component of the result depends only on the same component of the operands, so the target may also be an operand.
+	// Single tuples are held by value, so an expression over them may be kept and evaluated later, and converts to any
+	// tuple of the same shape: Point<3, float> p = lazy(a) + b * 2.f; spans and CoordinatesSoA are held by reference.
+	template<typename E>
+	concept TupleExpr = E::expression && requires(const E& expression)
+	{
+		typename E::value_type;
+		{ E::dimensions } -> std::convertible_to<size_t>;
+		{ expression.size() } -> std::convertible_to<size_t>;
+		expression.template evaluate<0>(size_t());
+	};
+
+	namespace detail
+	{
+		// Leaves report the number of elements they hold, or 0 for a single tuple that is broadcast to every element.
+		static constexpr size_t expression_size(size_t a, size_t b)
+		{
+			assert(a == 0 || b == 0 || a == b);
+			return a ? a : b;
+		}
+
+		template<Tuple U, TupleExpr E, size_t... C>
+		static constexpr void expression_assign(U& out, const E& expression, size_t index, std::index_sequence<C...>)
+		{
+			((out.template get_component<C>() = expression.template evaluate<C>(index)), ...);
+		}
+		template<Tuple U, TupleExpr E>
+		static constexpr void expression_assign(U& out, const E& expression, size_t index)
+		{
+			expression_assign(out, expression, index, std::make_index_sequence<U::dimensions>());
+		}
+		template<size_t C, size_t D, typename T, TupleExpr E>
+		static void expression_assign_column(CoordinatesSoA<D, T>& out, const E& expression)
+		{
+			T* column = out.data(C);
+			const size_t size = out.size();
+			for (size_t i = 0; i < size; ++i)
+				column[i] = expression.template evaluate<C>(i);
+		}
+		template<size_t D, typename T, TupleExpr E, size_t... C>
+		static void expression_assign_soa(CoordinatesSoA<D, T>& out, const E& expression, std::index_sequence<C...>)
+		{
+			(expression_assign_column<C>(out, expression), ...);
+		}
+		template<size_t D, typename T, TupleExpr E>
+		static void expression_assign_soa(CoordinatesSoA<D, T>& out, const E& expression)
+		{
+			expression_assign_soa(out, expression, std::make_index_sequence<D>());
+		}
+
+		template<Tuple T>
+		struct TupleLeaf
+		{
+			static constexpr bool expression = true;
+			static constexpr bool single = true;
+			using value_type = typename T::value_type;
+			static constexpr size_t dimensions = T::dimensions;
+
+			T tuple;
+
+			constexpr size_t size() const { return 0; }
+			template<size_t C>
+			constexpr value_type evaluate(size_t) const { return tuple.template get_component<C>(); }
+		};
+		template<Tuple T>
+		struct SpanLeaf
+		{
+			static constexpr bool expression = true;
+			static constexpr bool single = false;
+			using value_type = typename T::value_type;
+			static constexpr size_t dimensions = T::dimensions;
+
+			std::span<const T> tuples;
+
+			constexpr size_t size() const { return tuples.size(); }
+			template<size_t C>
+			constexpr value_type evaluate(size_t index) const { return tuples[index].template get_component<C>(); }
+		};
+		template<size_t D, typename T>
+		struct SoALeaf
+		{
+			static constexpr bool expression = true;
+			static constexpr bool single = false;
+			using value_type = T;
+			static constexpr size_t dimensions = D;
+
+			const CoordinatesSoA<D, T>& soa;
+
+			size_t size() const { return soa.size(); }
+			template<size_t C>
+			value_type evaluate(size_t index) const { return soa.data(C)[index]; }
+		};
+
+		template<template<typename> typename O, TupleExpr L, TupleExpr R>
+		requires (L::dimensions == R::dimensions && std::is_same_v<typename L::value_type, typename R::value_type>)
+		struct BinaryExpression
+		{
+			static constexpr bool expression = true;
+			static constexpr bool single = L::single && R::single;
+			using value_type = typename L::value_type;
+			static constexpr size_t dimensions = L::dimensions;
+			using operation = O<Coordinates<dimensions, value_type>>;
+
+			L left;
+			R right;
+
+			constexpr size_t size() const { return expression_size(left.size(), right.size()); }
+			template<size_t C>
+			constexpr value_type evaluate(size_t index) const { return operation::operation(left.template evaluate<C>(index), right.template evaluate<C>(index)); }
+			template<Tuple U>
+			requires (single && U::dimensions == dimensions && std::is_same_v<typename U::value_type, value_type>)
+			constexpr operator U() const
+			{
+				U out;
+				expression_assign(out, *this, 0);
+				return out;
+			}
+		};
+		template<template<typename> typename O, TupleExpr E, bool ScalarFirst = false>
+		struct ScalarExpression
+		{
+			static constexpr bool expression = true;
+			static constexpr bool single = E::single;
+			using value_type = typename E::value_type;
+			static constexpr size_t dimensions = E::dimensions;
+			using operation = O<Coordinates<dimensions, value_type>>;
+
+			E tuple;
+			value_type scalar;
+
+			constexpr size_t size() const { return tuple.size(); }
+			template<size_t C>
+			constexpr value_type evaluate(size_t index) const
+			{
+				if constexpr (ScalarFirst)
+					return operation::operation(scalar, tuple.template evaluate<C>(index));
+				else
+					return operation::operation(tuple.template evaluate<C>(index), scalar);
+			}
+			template<Tuple U>
+			requires (single && U::dimensions == dimensions && std::is_same_v<typename U::value_type, value_type>)
+			constexpr operator U() const
+			{
+				U out;
+				expression_assign(out, *this, 0);
+				return out;
+			}
+		};
+
+	}
+
+	template<Tuple T>
+	static constexpr detail::TupleLeaf<T> lazy(const T& tuple)
+	{
+		return { tuple };
+	}
+	template<Tuple T>
+	static constexpr detail::SpanLeaf<T> lazy(std::span<const T> tuples)
+	{
+		return { tuples };
+	}
+	template<size_t D, typename T>
+	static detail::SoALeaf<D, T> lazy(const CoordinatesSoA<D, T>& soa)
+	{
+		return { soa };
+	}
+
+	// Mixing an expression with a plain tuple wraps the tuple, so only one operand needs lazy().
+	template<TupleExpr L, TupleExpr R>
+	static constexpr auto operator+ (const L& a, const R& b) { return detail::BinaryExpression<detail::TupleAddition, L, R>{ a, b }; }
+	template<TupleExpr L, Tuple R>
+	static constexpr auto operator+ (const L& a, const R& b) { return a + lazy(b); }
+	template<Tuple L, TupleExpr R>
+	static constexpr auto operator+ (const L& a, const R& b) { return lazy(a) + b; }
+
+	template<TupleExpr L, TupleExpr R>
+	static constexpr auto operator- (const L& a, const R& b) { return detail::BinaryExpression<detail::TupleSubtraction, L, R>{ a, b }; }
+	template<TupleExpr L, Tuple R>
+	static constexpr auto operator- (const L& a, const R& b) { return a - lazy(b); }
+	template<Tuple L, TupleExpr R>
+	static constexpr auto operator- (const L& a, const R& b) { return lazy(a) - b; }
+
+	template<TupleExpr E>
+	static constexpr auto operator* (const E& tuple, const typename E::value_type& scalar) { return detail::ScalarExpression<detail::TupleMultiplication, E>{ tuple, scalar }; }
+	template<TupleExpr E>
+	static constexpr auto operator* (const typename E::value_type& scalar, const E& tuple) { return detail::ScalarExpression<detail::TupleMultiplication, E, true>{ tuple, scalar }; }
+	template<TupleExpr E>
+	static constexpr auto operator/ (const E& tuple, const typename E::value_type& scalar) { return detail::ScalarExpression<detail::TupleDivision, E>{ tuple, scalar }; }
+
+	// Evaluates expression into out in one pass; expressions over arrays need out to have the same number of elements.
+	template<Tuple U, TupleExpr E>
+	requires (U::dimensions == E::dimensions && std::is_same_v<typename U::value_type, typename E::value_type>)
+	static constexpr U& assign(U& out, const E& expression)
+	{
+		assert(expression.size() == 0);
+		detail::expression_assign(out, expression, 0);
+		return out;
+	}
+	template<Tuple U, TupleExpr E>
+	requires (U::dimensions == E::dimensions && std::is_same_v<typename U::value_type, typename E::value_type>)
+	static void assign(std::span<U> out, const E& expression)
+	{
+		assert(expression.size() == 0 || expression.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			detail::expression_assign(out[i], expression, i);
+	}
+	template<size_t D, typename T, TupleExpr E>
+	requires (D == E::dimensions && std::is_same_v<T, typename E::value_type>)
+	static void assign(CoordinatesSoA<D, T>& out, const E& expression)
+	{
+		assert(expression.size() == 0 || expression.size() == out.size());
+		detail::expression_assign_soa(out, expression);
+	}
+
+	template<Tuple U, TupleExpr E>
+	static constexpr U evaluate(const E& expression)
+	{
+		U out;
+		assign(out, expression);
+		return out;
+	}
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <cassert>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include "TupleOperations.h"
+
+namespace math
+{
+	namespace detail
+	{
+		template<size_t Bits>
+		using fixed_storage = std::conditional_t<Bits <= 8, int8_t, std::conditional_t<Bits <= 16, int16_t, int32_t>>;
+		template<size_t Bits>
+		using fixed_intermediate = std::conditional_t<Bits <= 8, int16_t, std::conditional_t<Bits <= 16, int32_t, int64_t>>;
+	}
+
+	// Signed binary fixed point: IntBits integer bits, sign included, and FracBits fraction bits, held in the smallest
+	// integer that fits both. Fixed<8, 8> spans [-128, 128) in steps of 1/256 in two bytes.
+	// Products round to nearest and quotients truncate toward zero, both through a wider intermediate;
+	// results outside the range wrap like the underlying integer. Floating-point numbers wrap too while their scaled value
+	// fits in 64 bits; beyond that they saturate to the range, and NaN converts to zero.
+	template<size_t IntBits, size_t FracBits>
+	requires (IntBits >= 1 && IntBits + FracBits <= 32)
+	struct Fixed
+	{
+	public:
+		using storage_type = detail::fixed_storage<IntBits + FracBits>;
+		using intermediate_type = detail::fixed_intermediate<IntBits + FracBits>;
+		static constexpr intermediate_type one = intermediate_type(1) << FracBits;
+
+		constexpr Fixed() : value(0) {}
+		template<typename T>
+		requires std::is_arithmetic_v<T>
+		constexpr Fixed(const T& number) : value(from_number(number)) {}
+
+		template<typename T>
+		requires std::is_arithmetic_v<T>
+		explicit constexpr operator T() const
+		{
+			if constexpr (std::is_floating_point_v<T>)
+				return static_cast<T>(value) / static_cast<T>(one);
+			else
+				return static_cast<T>(value / one);
+		}
+
+		static constexpr Fixed from_raw(storage_type raw)
+		{
+			Fixed fixed;
+			fixed.value = raw;
+			return fixed;
+		}
+		constexpr storage_type raw() const { return value; }
+
+		constexpr Fixed operator- () const { return from_raw(static_cast<storage_type>(-static_cast<intermediate_type>(value))); }
+
+		friend constexpr Fixed operator+ (const Fixed& a, const Fixed& b) { return from_raw(static_cast<storage_type>(static_cast<intermediate_type>(a.value) + b.value)); }
+		friend constexpr Fixed operator- (const Fixed& a, const Fixed& b) { return from_raw(static_cast<storage_type>(static_cast<intermediate_type>(a.value) - b.value)); }
+		friend constexpr Fixed operator* (const Fixed& a, const Fixed& b)
+		{
+			const intermediate_type product = static_cast<intermediate_type>(a.value) * b.value;
+			if constexpr (FracBits == 0)
+				return from_raw(static_cast<storage_type>(product));
+			else
+				return from_raw(static_cast<storage_type>((product + (intermediate_type(1) << (FracBits - 1))) >> FracBits));
+		}
+		friend constexpr Fixed operator/ (const Fixed& a, const Fixed& b) { return from_raw(static_cast<storage_type>(static_cast<intermediate_type>(a.value) * one / b.value)); }
+
+		constexpr Fixed& operator+= (const Fixed& rhs) { return *this = *this + rhs; }
+		constexpr Fixed& operator-= (const Fixed& rhs) { return *this = *this - rhs; }
+		constexpr Fixed& operator*= (const Fixed& rhs) { return *this = *this * rhs; }
+		constexpr Fixed& operator/= (const Fixed& rhs) { return *this = *this / rhs; }
+
+		friend constexpr bool operator== (const Fixed& a, const Fixed& b) = default;
+		friend constexpr std::strong_ordering operator<=> (const Fixed& a, const Fixed& b) = default;
+
+	private:
+		template<typename T>
+		static constexpr storage_type from_number(const T& number)
+		{
+			if constexpr (std::is_floating_point_v<T>)
+			{
+				// Casting NaN or a magnitude of 2^63 or more to int64_t is undefined.
+				constexpr T limit = static_cast<T>(uint64_t(1) << 63);
+				const T scaled = number * static_cast<T>(one);
+				if (scaled != scaled)
+					return 0;
+				if (scaled >= limit)
+					return std::numeric_limits<storage_type>::max();
+				if (scaled <= -limit)
+					return std::numeric_limits<storage_type>::min();
+				return static_cast<storage_type>(static_cast<int64_t>(scaled < 0 ? scaled - T(0.5) : scaled + T(0.5)));
+			}
+			else
+				return static_cast<storage_type>(static_cast<uint64_t>(number) << FracBits);
+		}
+
+		storage_type value;
+	};
+
+	template<size_t IntBits, size_t FracBits>
+	struct is_arithmetic<Fixed<IntBits, FracBits>> : std::true_type {};
+
+	template<Precision P = Precision::exact, size_t IntBits, size_t FracBits>
+	static constexpr Fixed<IntBits, FracBits> sqrt(const Fixed<IntBits, FracBits>& value)
+	{
+		return Fixed<IntBits, FracBits>(sqrt<P>(static_cast<double>(value)));
+	}
+	template<Precision P = Precision::exact, size_t IntBits, size_t FracBits>
+	static constexpr Fixed<IntBits, FracBits> rsqrt(const Fixed<IntBits, FracBits>& value)
+	{
+		return Fixed<IntBits, FracBits>(rsqrt<P>(static_cast<double>(value)));
+	}
+
+	namespace detail
+	{
+		template<typename T>
+		struct is_fixed : std::false_type {};
+		template<size_t IntBits, size_t FracBits>
+		struct is_fixed<Fixed<IntBits, FracBits>> : std::true_type {};
+
+		template<typename T, typename U>
+		static void fixed_convert(std::span<const T> values, std::span<U> out)
+		{
+			assert(values.size() == out.size());
+			for (size_t i = 0; i < out.size(); ++i)
+				out[i] = static_cast<U>(values[i]);
+		}
+	}
+
+	// Bulk conversion between floating point and Fixed; out must hold as many values.
+	template<size_t IntBits, size_t FracBits>
+	static void pack(std::span<const float> values, std::span<Fixed<IntBits, FracBits>> out)
+	{
+		detail::fixed_convert(values, out);
+	}
+	template<size_t IntBits, size_t FracBits>
+	static void pack(std::span<const double> values, std::span<Fixed<IntBits, FracBits>> out)
+	{
+		detail::fixed_convert(values, out);
+	}
+	template<size_t IntBits, size_t FracBits>
+	static void unpack(std::span<const Fixed<IntBits, FracBits>> values, std::span<float> out)
+	{
+		detail::fixed_convert(values, out);
+	}
+	template<size_t IntBits, size_t FracBits>
+	static void unpack(std::span<const Fixed<IntBits, FracBits>> values, std::span<double> out)
+	{
+		detail::fixed_convert(values, out);
+	}
+
+	template<Tuple T, Tuple U>
+	requires (T::dimensions == U::dimensions && std::is_floating_point_v<typename T::value_type> && detail::is_fixed<typename U::value_type>::value)
+	static void pack(std::span<const T> tuples, std::span<U> out)
+	{
+		tuple_cast(tuples, out);
+	}
+	template<Tuple T, Tuple U>
+	requires (T::dimensions == U::dimensions && detail::is_fixed<typename T::value_type>::value && std::is_floating_point_v<typename U::value_type>)
+	static void unpack(std::span<const T> tuples, std::span<U> out)
+	{
+		tuple_cast(tuples, out);
+	}
+}
+
+namespace std
+{
+	template<size_t IntBits, size_t FracBits>
+	class numeric_limits<math::Fixed<IntBits, FracBits>>
+	{
+	public:
+		using type = math::Fixed<IntBits, FracBits>;
+		using storage_type = typename type::storage_type;
+
+		static constexpr bool is_specialized = true;
+		static constexpr bool is_signed = true;
+		static constexpr bool is_integer = false;
+		static constexpr bool is_exact = true;
+		static constexpr bool is_modulo = true;
+		static constexpr int digits = IntBits + FracBits - 1;
+		static constexpr int radix = 2;
+
+		static constexpr type min() { return type::from_raw(std::numeric_limits<storage_type>::min()); }
+		static constexpr type max() { return type::from_raw(std::numeric_limits<storage_type>::max()); }
+		static constexpr type lowest() { return min(); }
+		static constexpr type epsilon() { return type::from_raw(1); }
+	};
+}
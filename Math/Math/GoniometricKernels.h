@@ -0,0 +1,289 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include "Constants.h"
+#include "Pack.h"
+#include "Sqrt.h"
+
+namespace math
+{
+	namespace detail
+	{
+		// Range-reduced minimax polynomials for sin, cos and atan2, written once over V = T or Pack<T, N>.
+		// sin and cos reduce by pi/2 in three (double) or four (float) Cody-Waite steps and evaluate on [-pi/4, pi/4];
+		// atan2 folds both arguments into [0, 1] and evaluates atan there.
+		// Lanes outside reduction_limit, and non-finite lanes, are recomputed with libm.
+		//
+		// Maximum error against libm evaluated one type wider; float sin and cos were checked on every
+		// input in range, double and atan2 on 2e7 random inputs each:
+		//
+		//                      float     double
+		// sin, cos            2.4 ulp   2 ulp     |x| <= reduction_limit
+		// atan2               3.3 ulp   2 ulp
+		//
+		// The double reduction splits pi/2 into three parts; past 2^27 the remainder near multiples of pi/2 loses enough
+		// bits to reach 14 ulp, so the limit stays a factor two below that.
+		template<typename T>
+		struct goniometric_coefficients
+		{};
+
+		template<>
+		struct goniometric_coefficients<float>
+		{
+			static constexpr float reduction_limit = 8192.0f;
+			static constexpr float two_over_pi = 0.636619772367581343076f;
+			static constexpr float pi_over_2_1 = 1.5703125f;
+			static constexpr float pi_over_2_2 = 4.837512969970703125e-4f;
+			static constexpr float pi_over_2_3 = 7.54953362047672271728515625e-8f;
+			static constexpr float pi_over_2_4 = 2.56334415159451878819e-12f;
+
+			static constexpr float sin[] = { -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f };
+			static constexpr float cos[] = { 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f };
+
+			static constexpr float atan_split = 0.4142135623730950f;
+			static constexpr float atan[] = { 8.05374449538e-2f, -1.38776856032e-1f, 1.99777106478e-1f, -3.33329491539e-1f };
+		};
+
+		template<>
+		struct goniometric_coefficients<double>
+		{
+			static constexpr double reduction_limit = 67108864.0;
+			static constexpr double two_over_pi = 0.636619772367581343076;
+			static constexpr double pi_over_2_1 = 1.57079625129699707031;
+			static constexpr double pi_over_2_2 = 7.54978941586159635335e-8;
+			static constexpr double pi_over_2_3 = 5.39030285815811905290e-15;
+			static constexpr double pi_over_2_4 = 0.0;
+
+			static constexpr double sin[] = { 1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6, -1.98412698295895385996e-4, 8.33333333332211858878e-3, -1.66666666666666307295e-1 };
+			static constexpr double cos[] = { -1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7, 2.48015872888517045348e-5, -1.38888888888730564116e-3, 4.16666666666665929218e-2 };
+
+			static constexpr double atan_split = 0.66;
+			static constexpr double atan_split_bits = 3.0616169978683830e-17;
+			static constexpr double atan_p[] = { -8.750608600031904122785e-1, -1.615753718733365076637e1, -7.500855792314704667340e1, -1.228866684490136173410e2, -6.485021904942025371773e1 };
+			static constexpr double atan_q[] = { 1.0, 2.485846490142306297962e1, 1.650270098316988542046e2, 4.328810604912902668951e2, 4.853903996359136964868e2, 1.945506571482613964425e2 };
+		};
+
+		template<typename V, typename T, size_t N>
+		static V polynomial(const V& x, const T (&coefficients)[N])
+		{
+			V result = V(coefficients[0]);
+			for (size_t i = 1; i < N; ++i)
+				result = result * x + V(coefficients[i]);
+			return result;
+		}
+
+		template<typename V>
+		static V floor(const V& value)
+		{
+			const V rounded = round_nearest(value);
+			return select(rounded > value, rounded - V(1), rounded);
+		}
+
+		template<typename V>
+		static auto quadrant_negative(const V& quadrant)
+		{
+			const V quarter = floor(quadrant * V(0.5)) * V(0.5);
+			return floor(quarter) < quarter;
+		}
+
+		template<typename V>
+		static void polynomial_sincos(const V& x, V& sine, V& cosine)
+		{
+			using T = typename pack_traits<V>::value_type;
+			using K = goniometric_coefficients<T>;
+
+			const V quadrant = round_nearest(x * V(K::two_over_pi));
+			V r = ((x - quadrant * V(K::pi_over_2_1)) - quadrant * V(K::pi_over_2_2)) - quadrant * V(K::pi_over_2_3);
+			if constexpr (K::pi_over_2_4 != 0)
+				r = r - quadrant * V(K::pi_over_2_4);
+			const V z = r * r;
+			const V s = r + r * z * polynomial(z, K::sin);
+			const V c = V(1) - V(0.5) * z + z * z * polynomial(z, K::cos);
+
+			const V half = quadrant * V(0.5);
+			const auto odd = floor(half) < half;
+			sine = select(odd, c, s);
+			cosine = select(odd, s, c);
+			sine = select(quadrant_negative(quadrant), -sine, sine);
+			cosine = select(quadrant_negative(quadrant + V(1)), -cosine, cosine);
+
+			if (!all(abs(x) <= V(K::reduction_limit)))
+			{
+				if constexpr (std::is_same_v<V, T>)
+				{
+					sine = std::sin(x);
+					cosine = std::cos(x);
+				}
+				else
+				{
+					T inputs[V::lanes], sines[V::lanes], cosines[V::lanes];
+					x.store(inputs);
+					sine.store(sines);
+					cosine.store(cosines);
+					for (size_t i = 0; i < V::lanes; ++i)
+						if (!(abs(inputs[i]) <= K::reduction_limit))
+						{
+							sines[i] = std::sin(inputs[i]);
+							cosines[i] = std::cos(inputs[i]);
+						}
+					sine = V::load(sines);
+					cosine = V::load(cosines);
+				}
+			}
+		}
+
+		template<typename V>
+		static V polynomial_atan_unit(const V& a)
+		{
+			using T = typename pack_traits<V>::value_type;
+			using K = goniometric_coefficients<T>;
+
+			const auto split = a > V(K::atan_split);
+			const V t = select(split, (a - V(1)) / (a + V(1)), a);
+			const V z = t * t;
+			if constexpr (std::is_same_v<T, float>)
+				return select(split, V(constants<T>::pi / 4), V(0)) + (t + t * z * polynomial(z, K::atan));
+			else
+				return select(split, V(constants<T>::pi / 4), V(0)) + (t + t * z * polynomial(z, K::atan_p) / polynomial(z, K::atan_q) + select(split, V(K::atan_split_bits), V(0)));
+		}
+
+		template<typename V>
+		static V polynomial_atan2(const V& y, const V& x)
+		{
+			using T = typename pack_traits<V>::value_type;
+
+			const V ax = abs(x);
+			const V ay = abs(y);
+			const auto swap = ay > ax;
+			const V numerator = select(swap, ax, ay);
+			const V denominator = select(swap, ay, ax);
+			V angle = polynomial_atan_unit(select(denominator > V(0), numerator / denominator, V(0)));
+			angle = select(swap, V(constants<T>::pi / 2) - angle, angle);
+			angle = select(negative(x), V(constants<T>::pi) - angle, angle);
+			angle = copysign(angle, y);
+
+			if (!all(finite(x) & finite(y)))
+			{
+				if constexpr (std::is_same_v<V, T>)
+					angle = std::atan2(y, x);
+				else
+				{
+					T ys[V::lanes], xs[V::lanes], angles[V::lanes];
+					y.store(ys);
+					x.store(xs);
+					angle.store(angles);
+					for (size_t i = 0; i < V::lanes; ++i)
+						if (!(finite(ys[i]) && finite(xs[i])))
+							angles[i] = std::atan2(ys[i], xs[i]);
+					angle = V::load(angles);
+				}
+			}
+			return angle;
+		}
+
+		// Taylor series in long double after reduction by pi/2, for constant evaluation only.
+		// atan halves its argument twice, to below tan(pi / 16), before summing its series.
+		template<typename T>
+		static constexpr bool constexpr_signbit(const T& value)
+		{
+			if constexpr (sizeof(T) == sizeof(uint32_t))
+				return std::bit_cast<uint32_t>(value) >> 31;
+			else if constexpr (sizeof(T) == sizeof(uint64_t))
+				return std::bit_cast<uint64_t>(value) >> 63;
+			else
+				return value < 0;
+		}
+
+		template<typename T>
+		static constexpr void constexpr_sincos(const T& radians, T& sine, T& cosine)
+		{
+			using L = long double;
+			if (radians != radians || radians - radians != 0)
+			{
+				sine = cosine = std::numeric_limits<T>::quiet_NaN();
+				return;
+			}
+
+			const L scaled = static_cast<L>(radians) * (2 / constants<L>::pi);
+			const long long quadrant = static_cast<long long>(scaled < 0 ? scaled - (L)0.5 : scaled + (L)0.5);
+			const L r = ((static_cast<L>(radians) - quadrant * (L)1.57079632673412561417e+00) - quadrant * (L)6.07710050630396597660e-11) - quadrant * (L)2.02226624879595063154e-21;
+			const L z = r * r;
+
+			L s = r, c = 1, sine_term = r, cosine_term = 1;
+			for (int n = 1; sine_term != 0 || cosine_term != 0; ++n)
+			{
+				sine_term *= -z / ((2 * n) * (2 * n + 1));
+				cosine_term *= -z / ((2 * n - 1) * (2 * n));
+				if (s + sine_term == s && c + cosine_term == c)
+					break;
+				s += sine_term;
+				c += cosine_term;
+			}
+
+			switch (((quadrant % 4) + 4) % 4)
+			{
+			case 0: sine = static_cast<T>(s);  cosine = static_cast<T>(c);  break;
+			case 1: sine = static_cast<T>(c);  cosine = static_cast<T>(-s); break;
+			case 2: sine = static_cast<T>(-s); cosine = static_cast<T>(-c); break;
+			default: sine = static_cast<T>(-c); cosine = static_cast<T>(s); break;
+			}
+		}
+
+		static constexpr long double constexpr_atan_unit(long double t)
+		{
+			for (int halving = 0; halving < 2; ++halving)
+				t = t / (1 + constexpr_sqrt(1 + t * t));
+			const long double z = t * t;
+			long double result = t, power = t;
+			for (int n = 1; ; ++n)
+			{
+				power *= -z;
+				const long double next = result + power / (2 * n + 1);
+				if (next == result)
+					break;
+				result = next;
+			}
+			return 4 * result;
+		}
+
+		template<typename T>
+		static constexpr T constexpr_atan2(const T& y, const T& x)
+		{
+			using L = long double;
+			if (y != y || x != x)
+				return std::numeric_limits<T>::quiet_NaN();
+
+			const L ay = y < 0 ? -static_cast<L>(y) : static_cast<L>(y);
+			const L ax = x < 0 ? -static_cast<L>(x) : static_cast<L>(x);
+			constexpr L infinity = std::numeric_limits<L>::infinity();
+			L angle;
+			if (ay == infinity && ax == infinity)
+				angle = constants<L>::pi / 4;
+			else if (ay == infinity)
+				angle = constants<L>::pi / 2;
+			else if (ax == infinity || ay == 0)
+				angle = 0;
+			else if (ay <= ax)
+				angle = constexpr_atan_unit(ay / ax);
+			else
+				angle = constants<L>::pi / 2 - constexpr_atan_unit(ax / ay);
+
+			if (constexpr_signbit(x))
+				angle = constants<L>::pi - angle;
+			return static_cast<T>(constexpr_signbit(y) ? -angle : angle);
+		}
+
+		template<typename T>
+		struct ConstexprGoniometricFunctions
+		{
+			static constexpr T acos(const T& x)								{ const long double l = x; return static_cast<T>(constexpr_atan2(constexpr_sqrt((1 - l) * (1 + l)), l)); }
+			static constexpr T asin(const T& x)								{ const long double l = x; return static_cast<T>(constexpr_atan2(l, constexpr_sqrt((1 - l) * (1 + l)))); }
+			static constexpr T atan(const T& x)								{ return constexpr_atan2(x, (T)1); }
+			static constexpr T atan2(const T& y, const T& x)				{ return constexpr_atan2(y, x); }
+			static constexpr T cos(const T& radians)						{ T sine, cosine; constexpr_sincos(radians, sine, cosine); return cosine; }
+			static constexpr T sin(const T& radians)						{ T sine, cosine; constexpr_sincos(radians, sine, cosine); return sine; }
+			static constexpr T tan(const T& radians)						{ long double sine, cosine; constexpr_sincos<long double>(radians, sine, cosine); return static_cast<T>(sine / cosine); }
+			static constexpr void sincos(const T& radians, T& sine, T& cosine)	{ constexpr_sincos(radians, sine, cosine); }
+		};
+	}
+}
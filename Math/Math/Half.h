@@ -0,0 +1,245 @@
+#pragma once
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include "TupleOperations.h"
+
+namespace math
+{
+	namespace detail
+	{
+		// Round to nearest even; overflow goes to infinity and NaNs stay quiet NaNs.
+		static constexpr uint16_t float_to_half(float value)
+		{
+#if defined(MATH_ISA_F16C)
+			if (!std::is_constant_evaluated())
+				return static_cast<uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#endif
+			const uint32_t bits = std::bit_cast<uint32_t>(value);
+			const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+			const uint32_t magnitude = bits & 0x7FFFFFFF;
+			if (magnitude >= 0x7F800000)
+				return sign | (magnitude > 0x7F800000 ? 0x7E00 | ((magnitude >> 13) & 0x3FF) : 0x7C00);
+			if (magnitude >= 0x477FF000)
+				return sign | 0x7C00;
+			if (magnitude < 0x38800000)
+			{
+				if (magnitude < 0x33000000)
+					return sign;
+				const uint32_t shift = 126 - (magnitude >> 23);
+				const uint32_t mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+				const uint32_t remainder = mantissa & ((1u << shift) - 1);
+				const uint32_t halfway = 1u << (shift - 1);
+				uint32_t result = mantissa >> shift;
+				if (remainder > halfway || (remainder == halfway && (result & 1)))
+					++result;
+				return sign | static_cast<uint16_t>(result);
+			}
+			const uint32_t rebiased = magnitude - 0x38000000;
+			return sign | static_cast<uint16_t>((rebiased + 0xFFF + ((rebiased >> 13) & 1)) >> 13);
+		}
+		// As float_to_half, from the bits of the double: going through float would round twice, and a double just above
+		// a half tie could round onto the tie in float and then to even in half.
+		static constexpr uint16_t double_to_half(double value)
+		{
+			const uint64_t bits = std::bit_cast<uint64_t>(value);
+			const uint16_t sign = static_cast<uint16_t>((bits >> 48) & 0x8000);
+			const uint64_t magnitude = bits & 0x7FFFFFFFFFFFFFFF;
+			if (magnitude >= 0x7FF0000000000000)
+				return sign | (magnitude > 0x7FF0000000000000 ? 0x7E00 | ((magnitude >> 42) & 0x3FF) : 0x7C00);
+			if (magnitude >= 0x40EFFE0000000000)
+				return sign | 0x7C00;
+			if (magnitude < 0x3F10000000000000)
+			{
+				if (magnitude < 0x3E60000000000000)
+					return sign;
+				const uint64_t shift = 1051 - (magnitude >> 52);
+				const uint64_t mantissa = (magnitude & 0xFFFFFFFFFFFFF) | 0x10000000000000;
+				const uint64_t remainder = mantissa & ((uint64_t(1) << shift) - 1);
+				const uint64_t halfway = uint64_t(1) << (shift - 1);
+				uint64_t result = mantissa >> shift;
+				if (remainder > halfway || (remainder == halfway && (result & 1)))
+					++result;
+				return sign | static_cast<uint16_t>(result);
+			}
+			const uint64_t rebiased = magnitude - 0x3F00000000000000;
+			return sign | static_cast<uint16_t>((rebiased + 0x1FFFFFFFFFF + ((rebiased >> 42) & 1)) >> 42);
+		}
+		static constexpr float half_to_float(uint16_t bits)
+		{
+#if defined(MATH_ISA_F16C)
+			if (!std::is_constant_evaluated())
+				return _cvtsh_ss(bits);
+#endif
+			const uint32_t sign = static_cast<uint32_t>(bits & 0x8000) << 16;
+			const uint32_t exponent = (bits >> 10) & 0x1F;
+			const uint32_t mantissa = bits & 0x3FF;
+			if (exponent == 0x1F)
+				return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+			if (exponent == 0)
+			{
+				const float subnormal = static_cast<float>(mantissa) * 0x1p-24f;
+				return sign ? -subnormal : subnormal;
+			}
+			return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+		}
+	}
+
+	// IEEE 754 binary16: half the storage of float with 11 significant bits, up to 65504.
+	// Arithmetic converts to float and rounds the result back, so every operation rounds once to half.
+	struct Half
+	{
+	public:
+		constexpr Half() : bits(0) {}
+		// Floating types wider than float round once, from double; long double rounds to double first.
+		template<typename T>
+		requires std::is_arithmetic_v<T>
+		constexpr Half(const T& value) : bits(convert(value)) {}
+
+		template<typename T>
+		requires std::is_arithmetic_v<T>
+		explicit constexpr operator T() const { return static_cast<T>(detail::half_to_float(bits)); }
+
+		static constexpr Half from_bits(uint16_t bits)
+		{
+			Half half;
+			half.bits = bits;
+			return half;
+		}
+		constexpr uint16_t to_bits() const { return bits; }
+
+		constexpr Half operator- () const { return from_bits(bits ^ 0x8000); }
+
+		friend constexpr Half operator+ (const Half& a, const Half& b) { return Half(static_cast<float>(a) + static_cast<float>(b)); }
+		friend constexpr Half operator- (const Half& a, const Half& b) { return Half(static_cast<float>(a) - static_cast<float>(b)); }
+		friend constexpr Half operator* (const Half& a, const Half& b) { return Half(static_cast<float>(a) * static_cast<float>(b)); }
+		friend constexpr Half operator/ (const Half& a, const Half& b) { return Half(static_cast<float>(a) / static_cast<float>(b)); }
+
+		constexpr Half& operator+= (const Half& rhs) { return *this = *this + rhs; }
+		constexpr Half& operator-= (const Half& rhs) { return *this = *this - rhs; }
+		constexpr Half& operator*= (const Half& rhs) { return *this = *this * rhs; }
+		constexpr Half& operator/= (const Half& rhs) { return *this = *this / rhs; }
+
+		friend constexpr bool operator== (const Half& a, const Half& b) { return static_cast<float>(a) == static_cast<float>(b); }
+		friend constexpr std::partial_ordering operator<=> (const Half& a, const Half& b) { return static_cast<float>(a) <=> static_cast<float>(b); }
+
+	private:
+		template<typename T>
+		static constexpr uint16_t convert(const T& value)
+		{
+			if constexpr (std::is_floating_point_v<T> && sizeof(T) > sizeof(float))
+				return detail::double_to_half(static_cast<double>(value));
+			else
+				return detail::float_to_half(static_cast<float>(value));
+		}
+
+		uint16_t bits;
+	};
+
+	template<>
+	struct is_arithmetic<Half> : std::true_type {};
+	template<>
+	struct is_floating_point<Half> : std::true_type {};
+
+	template<Precision P = Precision::exact>
+	static constexpr Half sqrt(const Half& value)
+	{
+		return Half(sqrt<P>(static_cast<float>(value)));
+	}
+	template<Precision P = Precision::exact>
+	static constexpr Half rsqrt(const Half& value)
+	{
+		return Half(rsqrt<P>(static_cast<float>(value)));
+	}
+
+	// Bulk conversion between float and Half; out must hold as many values.
+	inline void pack(std::span<const float> values, std::span<Half> out)
+	{
+		assert(values.size() == out.size());
+		const size_t size = out.size();
+		size_t i = 0;
+#if defined(MATH_ISA_F16C)
+		for (; i + 8 <= size; i += 8)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), _mm256_cvtps_ph(_mm256_loadu_ps(values.data() + i), _MM_FROUND_TO_NEAREST_INT));
+#elif defined(MATH_ISA_NEON)
+		for (; i + 4 <= size; i += 4)
+			vst1_u16(reinterpret_cast<uint16_t*>(out.data() + i), vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(values.data() + i))));
+#endif
+		for (; i < size; ++i)
+			out[i] = Half(values[i]);
+	}
+	inline void unpack(std::span<const Half> values, std::span<float> out)
+	{
+		assert(values.size() == out.size());
+		const size_t size = out.size();
+		size_t i = 0;
+#if defined(MATH_ISA_F16C)
+		for (; i + 8 <= size; i += 8)
+			_mm256_storeu_ps(out.data() + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values.data() + i))));
+#elif defined(MATH_ISA_NEON)
+		for (; i + 4 <= size; i += 4)
+			vst1q_f32(out.data() + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const uint16_t*>(values.data() + i)))));
+#endif
+		for (; i < size; ++i)
+			out[i] = static_cast<float>(values[i]);
+	}
+
+	// Tuples without padding go through the flat kernels above; padded ones (Coordinates<3, float> with MATH_SIMD) convert one by one.
+	template<Tuple T, Tuple U>
+	requires (T::dimensions == U::dimensions && std::is_same_v<typename T::value_type, float> && std::is_same_v<typename U::value_type, Half>)
+	static void pack(std::span<const T> tuples, std::span<U> out)
+	{
+		assert(tuples.size() == out.size());
+		if constexpr (sizeof(T) == T::dimensions * sizeof(float) && sizeof(U) == U::dimensions * sizeof(Half))
+		{
+			if (!out.empty())
+				pack(std::span<const float>(&tuples[0].template get_component<0>(), tuples.size() * T::dimensions), std::span<Half>(&out[0].template get_component<0>(), out.size() * U::dimensions));
+		}
+		else
+			tuple_cast(tuples, out);
+	}
+	template<Tuple T, Tuple U>
+	requires (T::dimensions == U::dimensions && std::is_same_v<typename T::value_type, Half> && std::is_same_v<typename U::value_type, float>)
+	static void unpack(std::span<const T> tuples, std::span<U> out)
+	{
+		assert(tuples.size() == out.size());
+		if constexpr (sizeof(T) == T::dimensions * sizeof(Half) && sizeof(U) == U::dimensions * sizeof(float))
+		{
+			if (!out.empty())
+				unpack(std::span<const Half>(&tuples[0].template get_component<0>(), tuples.size() * T::dimensions), std::span<float>(&out[0].template get_component<0>(), out.size() * U::dimensions));
+		}
+		else
+			tuple_cast(tuples, out);
+	}
+}
+
+namespace std
+{
+	template<>
+	class numeric_limits<math::Half>
+	{
+	public:
+		static constexpr bool is_specialized = true;
+		static constexpr bool is_signed = true;
+		static constexpr bool is_integer = false;
+		static constexpr bool is_exact = false;
+		static constexpr bool has_infinity = true;
+		static constexpr bool has_quiet_NaN = true;
+		static constexpr bool is_iec559 = true;
+		static constexpr int digits = 11;
+		static constexpr int radix = 2;
+		static constexpr int min_exponent = -13;
+		static constexpr int max_exponent = 16;
+
+		static constexpr math::Half min() { return math::Half::from_bits(0x0400); }
+		static constexpr math::Half max() { return math::Half::from_bits(0x7BFF); }
+		static constexpr math::Half lowest() { return math::Half::from_bits(0xFBFF); }
+		static constexpr math::Half epsilon() { return math::Half::from_bits(0x1400); }
+		static constexpr math::Half infinity() { return math::Half::from_bits(0x7C00); }
+		static constexpr math::Half quiet_NaN() { return math::Half::from_bits(0x7E00); }
+		static constexpr math::Half denorm_min() { return math::Half::from_bits(0x0001); }
+	};
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+#include "Point.h"
+#include "TupleOperations.h"
+#include "Executor.h"
+
+namespace math
+{
+	namespace detail
+	{
+		// The component at a run-time index, found by comparing the index with each component's in turn.
+		template<Tuple U, size_t... C>
+		static constexpr const typename U::value_type& tuple_component(const U& tuple, size_t component, std::index_sequence<C...>)
+		{
+			const typename U::value_type* found = &tuple.template get_component<U::dimensions - 1>();
+			(void)((component == C && (found = &tuple.template get_component<C>(), true)) || ...);
+			return *found;
+		}
+		template<Tuple U>
+		static constexpr const typename U::value_type& tuple_component(const U& tuple, size_t component)
+		{
+			return tuple_component(tuple, component, std::make_index_sequence<U::dimensions - 1>());
+		}
+	}
+
+	// Static k-d tree over Point<D, T> with distance_sq as the metric.
+	// The tree has no node objects: the points are reordered so that the subtree over [first, last) keeps its
+	// splitting point at (first + last) / 2, its left subtree in [first, middle) and its right subtree in (middle, last).
+	// Ranges of at most leaf_size points are not split further and are scanned linearly.
+	// Query results refer to positions in the span the tree was built from.
+	template<size_t D, typename T>
+	requires std::is_arithmetic_v<T> && std::is_signed_v<T>
+	class KdTree
+	{
+	public:
+		using point_type = Point<D, T>;
+		static constexpr size_t leaf_size = 8;
+
+		struct Neighbour
+		{
+			size_t index;
+			T distance_sq;
+		};
+
+		KdTree() = default;
+		template<bulk::Executor E = bulk::Serial>
+		KdTree(std::span<const point_type> points, const E& executor = E()) : indices(points.size()), axes(points.size())
+		{
+			std::iota(indices.begin(), indices.end(), size_t(0));
+
+			// Split the top levels here until there is enough independent work, then let the executor build the subtrees.
+			constexpr size_t tasks = 64;
+			std::vector<std::pair<size_t, size_t>> ranges{ { 0, points.size() } };
+			while (ranges.size() < tasks)
+			{
+				std::vector<std::pair<size_t, size_t>> next;
+				for (const auto& [first, last] : ranges)
+				{
+					if (last - first <= leaf_size)
+					{
+						next.emplace_back(first, last);
+						continue;
+					}
+					const size_t middle = split(points, first, last);
+					next.emplace_back(first, middle);
+					next.emplace_back(middle + 1, last);
+				}
+				if (next.size() == ranges.size())
+					break;
+				ranges = std::move(next);
+			}
+			executor(ranges.size(), [&](size_t i) { build(points, ranges[i].first, ranges[i].second); });
+
+			this->points.reserve(points.size());
+			for (size_t index : indices)
+				this->points.emplace_back(points[index]);
+		}
+
+		size_t size() const { return points.size(); }
+		bool empty() const { return points.empty(); }
+
+		// Closest point; index is size() for an empty tree.
+		Neighbour nearest(const point_type& query) const
+		{
+			Neighbour best{ size(), std::numeric_limits<T>::max() };
+			nearest(query, std::span<Neighbour>(&best, 1));
+			return best;
+		}
+		// Up to out.size() closest points, nearest first; returns how many were written.
+		size_t nearest(const point_type& query, std::span<Neighbour> out) const
+		{
+			size_t count = 0;
+			if (!out.empty())
+				search_nearest(query, 0, size(), out, count);
+			return count;
+		}
+		// Appends the points with distance_sq(point, query) <= radius * radius.
+		void radius(const point_type& query, const T& radius, std::vector<size_t>& out) const
+		{
+			search_radius(query, radius * radius, 0, size(), out);
+		}
+		// Appends the points with minimum <= point <= maximum in every component.
+		void box(const point_type& minimum, const point_type& maximum, std::vector<size_t>& out) const
+		{
+			search_box(minimum, maximum, 0, size(), out);
+		}
+
+		// k = out.size() / queries.size() neighbours per query; query i writes out[i * k, i * k + k) and counts[i].
+		template<bulk::Executor E = bulk::Serial>
+		void nearest(std::span<const point_type> queries, std::span<Neighbour> out, std::span<size_t> counts, const E& executor = E()) const
+		{
+			if (queries.empty())
+				return;
+			const size_t k = out.size() / queries.size();
+			batch(queries.size(), executor, [&](size_t i) { counts[i] = nearest(queries[i], out.subspan(i * k, k)); });
+		}
+		template<bulk::Executor E = bulk::Serial>
+		void radius(std::span<const point_type> queries, const T& radius, std::span<std::vector<size_t>> out, const E& executor = E()) const
+		{
+			batch(queries.size(), executor, [&](size_t i) { this->radius(queries[i], radius, out[i]); });
+		}
+
+	private:
+		// Splits [first, last) at its median along the axis of widest spread and returns the median's position.
+		size_t split(std::span<const point_type> input, size_t first, size_t last)
+		{
+			T low[D], high[D];
+			for (size_t c = 0; c < D; ++c)
+				low[c] = high[c] = detail::tuple_component(input[indices[first]], c);
+			for (size_t i = first + 1; i < last; ++i)
+				for (size_t c = 0; c < D; ++c)
+				{
+					const T value = detail::tuple_component(input[indices[i]], c);
+					low[c] = value < low[c] ? value : low[c];
+					high[c] = high[c] < value ? value : high[c];
+				}
+			size_t axis = 0;
+			for (size_t c = 1; c < D; ++c)
+				if (high[axis] - low[axis] < high[c] - low[c])
+					axis = c;
+
+			const size_t middle = first + (last - first) / 2;
+			std::nth_element(indices.begin() + first, indices.begin() + middle, indices.begin() + last, [&](size_t a, size_t b)
+			{
+				return detail::tuple_component(input[a], axis) < detail::tuple_component(input[b], axis);
+			});
+			axes[middle] = static_cast<uint8_t>(axis);
+			return middle;
+		}
+		void build(std::span<const point_type> input, size_t first, size_t last)
+		{
+			if (last - first <= leaf_size)
+				return;
+			const size_t middle = split(input, first, last);
+			build(input, first, middle);
+			build(input, middle + 1, last);
+		}
+
+		void search_nearest(const point_type& query, size_t first, size_t last, std::span<Neighbour> out, size_t& count) const
+		{
+			const auto visit = [&](size_t i)
+			{
+				// out[0, count) stays sorted by insertion, which beats a heap for the small k this is used with.
+				const T distance = distance_sq(points[i], query);
+				if (count == out.size() && !(distance < out[count - 1].distance_sq))
+					return;
+				size_t j = count < out.size() ? count++ : count - 1;
+				for (; j > 0 && distance < out[j - 1].distance_sq; --j)
+					out[j] = out[j - 1];
+				out[j] = { indices[i], distance };
+			};
+			if (last - first <= leaf_size)
+			{
+				for (size_t i = first; i < last; ++i)
+					visit(i);
+				return;
+			}
+			const size_t middle = first + (last - first) / 2;
+			const T offset = detail::tuple_component(query, axes[middle]) - detail::tuple_component(points[middle], axes[middle]);
+			visit(middle);
+			if (offset < 0)
+				search_nearest(query, first, middle, out, count);
+			else
+				search_nearest(query, middle + 1, last, out, count);
+			if (count < out.size() || offset * offset < out[count - 1].distance_sq)
+			{
+				if (offset < 0)
+					search_nearest(query, middle + 1, last, out, count);
+				else
+					search_nearest(query, first, middle, out, count);
+			}
+		}
+		void search_radius(const point_type& query, const T& radius_sq, size_t first, size_t last, std::vector<size_t>& out) const
+		{
+			if (last - first <= leaf_size)
+			{
+				for (size_t i = first; i < last; ++i)
+					if (distance_sq(points[i], query) <= radius_sq)
+						out.push_back(indices[i]);
+				return;
+			}
+			const size_t middle = first + (last - first) / 2;
+			const T offset = detail::tuple_component(query, axes[middle]) - detail::tuple_component(points[middle], axes[middle]);
+			if (distance_sq(points[middle], query) <= radius_sq)
+				out.push_back(indices[middle]);
+			if (offset <= 0 || offset * offset <= radius_sq)
+				search_radius(query, radius_sq, first, middle, out);
+			if (offset >= 0 || offset * offset <= radius_sq)
+				search_radius(query, radius_sq, middle + 1, last, out);
+		}
+		void search_box(const point_type& minimum, const point_type& maximum, size_t first, size_t last, std::vector<size_t>& out) const
+		{
+			const auto inside = [&](const point_type& point)
+			{
+				for (size_t c = 0; c < D; ++c)
+				{
+					const T value = detail::tuple_component(point, c);
+					if (value < detail::tuple_component(minimum, c) || detail::tuple_component(maximum, c) < value)
+						return false;
+				}
+				return true;
+			};
+			if (last - first <= leaf_size)
+			{
+				for (size_t i = first; i < last; ++i)
+					if (inside(points[i]))
+						out.push_back(indices[i]);
+				return;
+			}
+			const size_t middle = first + (last - first) / 2;
+			const T split = detail::tuple_component(points[middle], axes[middle]);
+			if (inside(points[middle]))
+				out.push_back(indices[middle]);
+			if (!(split < detail::tuple_component(minimum, axes[middle])))
+				search_box(minimum, maximum, first, middle, out);
+			if (!(detail::tuple_component(maximum, axes[middle]) < split))
+				search_box(minimum, maximum, middle + 1, last, out);
+		}
+
+		// Queries are handed to the executor in blocks so that neighbouring queries share a thread and its cache.
+		template<bulk::Executor E, typename F>
+		static void batch(size_t size, const E& executor, const F& query)
+		{
+			constexpr size_t block = 256;
+			executor((size + block - 1) / block, [&](size_t chunk)
+			{
+				const size_t last = size - chunk * block < block ? size : chunk * block + block;
+				for (size_t i = chunk * block; i < last; ++i)
+					query(i);
+			});
+		}
+
+		std::vector<point_type> points;
+		std::vector<size_t> indices;
+		std::vector<uint8_t> axes;
+	};
+}
@@ -0,0 +1,459 @@
+#pragma once
+#include <cassert>
+#include <span>
+#include "Vector.h"
+#include "Point.h"
+#include "CoordinatesSoA.h"
+#include "Pack.h"
+
+namespace math
+{
+	namespace detail
+	{
+		template<Tuple U, size_t... I>
+		static constexpr void tuple_to_array(typename U::value_type* out, const U& tuple, std::index_sequence<I...>)
+		{
+			((out[I] = tuple.template get_component<I>()), ...);
+		}
+		template<Tuple U>
+		static constexpr void tuple_to_array(typename U::value_type* out, const U& tuple)
+		{
+			if constexpr (array_tuple<U>)
+				for (size_t i = 0; i < U::dimensions; ++i)
+					out[i] = tuple.components[i];
+			else
+				tuple_to_array(out, tuple, std::make_index_sequence<U::dimensions>());
+		}
+		template<Tuple U, size_t... I>
+		static constexpr void array_to_tuple(U& tuple, const typename U::value_type* in, std::index_sequence<I...>)
+		{
+			((tuple.template get_component<I>() = in[I]), ...);
+		}
+		template<Tuple U>
+		static constexpr void array_to_tuple(U& tuple, const typename U::value_type* in)
+		{
+			if constexpr (array_tuple<U>)
+				for (size_t i = 0; i < U::dimensions; ++i)
+					tuple.components[i] = in[i];
+			else
+				array_to_tuple(tuple, in, std::make_index_sequence<U::dimensions>());
+		}
+	}
+
+	// Row-major R x C matrix. As a Tuple its components are the elements in row-major order.
+	// The matrix is aligned like Coordinates<C, T>, so with MATH_SIMD the rows of a 4 column matrix are register-aligned.
+	// Square matrices act on Point<N - 1, T> and Vector<N - 1, T> as affine transforms: points are translated
+	// by the last column, vectors are not. The bottom row is assumed to be (0, ..., 0, 1).
+	template<size_t R, size_t C, typename T>
+	requires std::is_arithmetic_v<T>
+	struct alignas(detail::SimdRegister<T, C>::alignment) Matrix : public TupleBase<R * C, T>
+	{
+	public:
+		static constexpr size_t rows = R;
+		static constexpr size_t columns = C;
+
+		constexpr Matrix() : elements() {}
+		constexpr Matrix(const T& diagonal) : elements()
+		{
+			for (size_t i = 0; i < R && i < C; ++i)
+				elements[i][i] = diagonal;
+		}
+		template<SameTuple<C, T>... Rows>
+		requires (sizeof...(Rows) == R)
+		constexpr Matrix(const Rows&... rows) : elements()
+		{
+			size_t i = 0;
+			(set_row(i++, rows), ...);
+		}
+
+		static constexpr Matrix identity() { return Matrix((T)1); }
+
+		template<size_t I>
+		constexpr const T& get_component() const { static_assert(I < R * C, "component index out of range"); return elements[I / C][I % C]; }
+		template<size_t I>
+		constexpr T& get_component() { static_assert(I < R * C, "component index out of range"); return elements[I / C][I % C]; }
+
+		constexpr const T& operator() (size_t row, size_t column) const { return elements[row][column]; }
+		constexpr T& operator() (size_t row, size_t column) { return elements[row][column]; }
+
+		template<size_t I>
+		constexpr Coordinates<C, T> row() const
+		{
+			static_assert(I < R, "row index out of range");
+			Coordinates<C, T> out;
+			detail::array_to_tuple(out, elements[I]);
+			return out;
+		}
+		template<size_t J>
+		constexpr Coordinates<R, T> column() const
+		{
+			static_assert(J < C, "column index out of range");
+			T values[R];
+			for (size_t i = 0; i < R; ++i)
+				values[i] = elements[i][J];
+			Coordinates<R, T> out;
+			detail::array_to_tuple(out, values);
+			return out;
+		}
+
+		constexpr Matrix<C, R, T> transposed() const
+		{
+			Matrix<C, R, T> out;
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					out.elements[j][i] = elements[i][j];
+			return out;
+		}
+
+		T elements[R][C];
+
+	private:
+		template<Tuple U>
+		constexpr void set_row(size_t row, const U& tuple)
+		{
+			detail::tuple_to_array(elements[row], tuple);
+		}
+	};
+
+	namespace detail
+	{
+		template<typename O, size_t R, size_t C, typename T>
+		static constexpr void matrix_operation(Matrix<R, C, T>& out, const Matrix<R, C, T>& a, const Matrix<R, C, T>& b)
+		{
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					out.elements[i][j] = O::operation(a.elements[i][j], b.elements[i][j]);
+		}
+		template<typename O, size_t R, size_t C, typename T>
+		static constexpr void matrix_operation_scalar(Matrix<R, C, T>& out, const Matrix<R, C, T>& a, const T& scalar)
+		{
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					out.elements[i][j] = O::operation(a.elements[i][j], scalar);
+		}
+
+		// Tiles of matrix_block x matrix_block elements keep one tile of each operand in cache
+		// once any dimension outgrows a single tile.
+		static constexpr size_t matrix_block = 64;
+
+		template<size_t R, size_t K, size_t C, typename T>
+		static constexpr void matrix_multiply(Matrix<R, C, T>& out, const Matrix<R, K, T>& a, const Matrix<K, C, T>& b)
+		{
+			for (size_t i = 0; i < R; ++i)
+				for (size_t k = 0; k < K; ++k)
+				{
+					const T scale = a.elements[i][k];
+					for (size_t j = 0; j < C; ++j)
+						out.elements[i][j] += scale * b.elements[k][j];
+				}
+		}
+
+		template<size_t R, size_t K, size_t C, typename T>
+		static void matrix_multiply_blocked(Matrix<R, C, T>& out, const Matrix<R, K, T>& a, const Matrix<K, C, T>& b)
+		{
+			for (size_t ii = 0; ii < R; ii += matrix_block)
+				for (size_t kk = 0; kk < K; kk += matrix_block)
+					for (size_t jj = 0; jj < C; jj += matrix_block)
+					{
+						const size_t i_end = ii + matrix_block < R ? ii + matrix_block : R;
+						const size_t k_end = kk + matrix_block < K ? kk + matrix_block : K;
+						const size_t j_end = jj + matrix_block < C ? jj + matrix_block : C;
+						for (size_t i = ii; i < i_end; ++i)
+							for (size_t k = kk; k < k_end; ++k)
+							{
+								const T scale = a.elements[i][k];
+								T* row = out.elements[i];
+								const T* source = b.elements[k];
+								for (size_t j = jj; j < j_end; ++j)
+									row[j] += scale * source[j];
+							}
+					}
+		}
+
+		// One register per row of the result: each row of a broadcasts into the rows of b.
+		template<size_t R, size_t K, size_t C, typename T>
+		static void matrix_multiply_packed(Matrix<R, C, T>& out, const Matrix<R, K, T>& a, const Matrix<K, C, T>& b)
+		{
+			using V = Pack<T, C>;
+			V rows[K];
+			for (size_t k = 0; k < K; ++k)
+				rows[k] = V::load(b.elements[k]);
+			for (size_t i = 0; i < R; ++i)
+			{
+				V row = V(a.elements[i][0]) * rows[0];
+				for (size_t k = 1; k < K; ++k)
+					row = row + V(a.elements[i][k]) * rows[k];
+				row.store(out.elements[i]);
+			}
+		}
+
+		// Columns 0..N-1 of m, one register each; the transform of (v0, ..., vN-1) is the sum of column j * vj.
+		template<size_t R, size_t C, typename T>
+		struct MatrixColumns
+		{
+			using pack = Pack<T, R>;
+
+			MatrixColumns(const Matrix<R, C, T>& m)
+			{
+				for (size_t j = 0; j < C; ++j)
+				{
+					T values[R];
+					for (size_t i = 0; i < R; ++i)
+						values[i] = m.elements[i][j];
+					columns[j] = pack::load(values);
+				}
+			}
+
+			template<bool Translate>
+			void transform(T* out, const T* in, size_t count) const
+			{
+				pack result = Translate ? columns[count] : pack();
+				for (size_t j = 0; j < count; ++j)
+					result = result + columns[j] * pack(in[j]);
+				T values[R];
+				result.store(values);
+				for (size_t i = 0; i < count; ++i)
+					out[i] = values[i];
+			}
+
+			pack columns[C];
+		};
+
+		template<bool Translate, size_t R, size_t C, typename T>
+		static constexpr void matrix_transform(T* out, const Matrix<R, C, T>& m, const T* in, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				T value = Translate ? m.elements[i][count] : T();
+				for (size_t j = 0; j < count; ++j)
+					value += m.elements[i][j] * in[j];
+				out[i] = value;
+			}
+		}
+
+		template<bool Translate, size_t N, typename T, typename U>
+		static void matrix_transform_span(const Matrix<N, N, T>& m, std::span<const U> in, std::span<U> out)
+		{
+			assert(in.size() == out.size());
+			const size_t size = out.size();
+			if constexpr (Pack<T, N>::enabled)
+			{
+				const MatrixColumns<N, N, T> columns(m);
+				for (size_t i = 0; i < size; ++i)
+				{
+					T values[N - 1];
+					tuple_to_array(values, in[i]);
+					columns.template transform<Translate>(values, values, N - 1);
+					array_to_tuple(out[i], values);
+				}
+			}
+			else
+				for (size_t i = 0; i < size; ++i)
+				{
+					T source[N - 1], values[N - 1];
+					tuple_to_array(source, in[i]);
+					matrix_transform<Translate>(values, m, source, N - 1);
+					array_to_tuple(out[i], values);
+				}
+		}
+
+		// Each column of the SoA is already one register per component, so the widest pack runs over the elements and
+		// every matrix element is broadcast; the tail runs the same kernel on T.
+		template<bool Translate, size_t N, typename T>
+		static void matrix_transform_soa(const Matrix<N, N, T>& m, CoordinatesSoA<N - 1, T>& soa)
+		{
+			constexpr size_t D = N - 1;
+			T* columns[D];
+			for (size_t c = 0; c < D; ++c)
+				columns[c] = soa.data(c);
+			const auto kernel = [&]<typename V>(V, size_t i)
+			{
+				V source[D];
+				for (size_t c = 0; c < D; ++c)
+					source[c] = load<V>(columns[c] + i);
+				for (size_t r = 0; r < D; ++r)
+				{
+					V value = Translate ? V(m.elements[r][D]) : V(T());
+					for (size_t c = 0; c < D; ++c)
+						value = value + V(m.elements[r][c]) * source[c];
+					store(columns[r] + i, value);
+				}
+			};
+
+			using V = widest_pack<T>;
+			const size_t size = soa.size();
+			size_t i = 0;
+			if constexpr (!std::is_same_v<V, T>)
+				for (; i + V::lanes <= size; i += V::lanes)
+					kernel(V(), i);
+			for (; i < size; ++i)
+				kernel(T(), i);
+		}
+	}
+
+	template<size_t R, size_t C, typename T>
+	static constexpr bool operator== (const Matrix<R, C, T>& a, const Matrix<R, C, T>& b)
+	{
+		for (size_t i = 0; i < R; ++i)
+			for (size_t j = 0; j < C; ++j)
+				if (a.elements[i][j] != b.elements[i][j])
+					return false;
+		return true;
+	}
+	template<size_t R, size_t C, typename T>
+	static constexpr bool operator!= (const Matrix<R, C, T>& a, const Matrix<R, C, T>& b)
+	{
+		return !(a == b);
+	}
+
+	template<size_t R, size_t C, typename T>
+	static constexpr Matrix<R, C, T> operator+ (const Matrix<R, C, T>& a, const Matrix<R, C, T>& b)
+	{
+		Matrix<R, C, T> result;
+		detail::matrix_operation<detail::TupleAddition<Matrix<R, C, T>>>(result, a, b);
+		return result;
+	}
+	template<size_t R, size_t C, typename T>
+	static constexpr Matrix<R, C, T> operator- (const Matrix<R, C, T>& a, const Matrix<R, C, T>& b)
+	{
+		Matrix<R, C, T> result;
+		detail::matrix_operation<detail::TupleSubtraction<Matrix<R, C, T>>>(result, a, b);
+		return result;
+	}
+	template<size_t R, size_t C, typename T>
+	static constexpr Matrix<R, C, T>& operator+= (Matrix<R, C, T>& a, const Matrix<R, C, T>& b)
+	{
+		detail::matrix_operation<detail::TupleAddition<Matrix<R, C, T>>>(a, a, b);
+		return a;
+	}
+	template<size_t R, size_t C, typename T>
+	static constexpr Matrix<R, C, T>& operator-= (Matrix<R, C, T>& a, const Matrix<R, C, T>& b)
+	{
+		detail::matrix_operation<detail::TupleSubtraction<Matrix<R, C, T>>>(a, a, b);
+		return a;
+	}
+	template<size_t R, size_t C, typename T>
+	static constexpr Matrix<R, C, T> operator* (const Matrix<R, C, T>& matrix, const std::type_identity_t<T>& scalar)
+	{
+		Matrix<R, C, T> result;
+		detail::matrix_operation_scalar<detail::TupleMultiplication<Matrix<R, C, T>>>(result, matrix, scalar);
+		return result;
+	}
+	template<size_t R, size_t C, typename T>
+	static constexpr Matrix<R, C, T> operator* (const std::type_identity_t<T>& scalar, const Matrix<R, C, T>& matrix)
+	{
+		return matrix * scalar;
+	}
+	template<size_t R, size_t C, typename T>
+	static constexpr Matrix<R, C, T> operator/ (const Matrix<R, C, T>& matrix, const std::type_identity_t<T>& scalar)
+	{
+		Matrix<R, C, T> result;
+		detail::matrix_operation_scalar<detail::TupleDivision<Matrix<R, C, T>>>(result, matrix, scalar);
+		return result;
+	}
+	template<size_t R, size_t C, typename T>
+	static constexpr Matrix<R, C, T>& operator*= (Matrix<R, C, T>& matrix, const std::type_identity_t<T>& scalar)
+	{
+		detail::matrix_operation_scalar<detail::TupleMultiplication<Matrix<R, C, T>>>(matrix, matrix, scalar);
+		return matrix;
+	}
+	template<size_t R, size_t C, typename T>
+	static constexpr Matrix<R, C, T>& operator/= (Matrix<R, C, T>& matrix, const std::type_identity_t<T>& scalar)
+	{
+		detail::matrix_operation_scalar<detail::TupleDivision<Matrix<R, C, T>>>(matrix, matrix, scalar);
+		return matrix;
+	}
+
+	template<size_t R, size_t K, size_t C, typename T>
+	static constexpr Matrix<R, C, T> operator* (const Matrix<R, K, T>& a, const Matrix<K, C, T>& b)
+	{
+		Matrix<R, C, T> result;
+		if (!std::is_constant_evaluated())
+		{
+			if constexpr (Pack<T, C>::enabled && K <= 16)
+			{
+				detail::matrix_multiply_packed(result, a, b);
+				return result;
+			}
+			else if constexpr (R > detail::matrix_block || K > detail::matrix_block || C > detail::matrix_block)
+			{
+				detail::matrix_multiply_blocked(result, a, b);
+				return result;
+			}
+		}
+		detail::matrix_multiply(result, a, b);
+		return result;
+	}
+	template<size_t N, typename T>
+	static constexpr Matrix<N, N, T>& operator*= (Matrix<N, N, T>& a, const Matrix<N, N, T>& b)
+	{
+		return a = a * b;
+	}
+
+	template<size_t R, size_t C, typename T>
+	static constexpr Vector<R, T> operator* (const Matrix<R, C, T>& m, const Vector<C, T>& vector)
+	{
+		T source[C], values[R];
+		detail::tuple_to_array(source, vector);
+		if constexpr (R == C && Pack<T, R>::enabled)
+			if (!std::is_constant_evaluated())
+			{
+				detail::MatrixColumns<R, C, T>(m).template transform<false>(values, source, C);
+				Vector<R, T> out;
+				detail::array_to_tuple(out, values);
+				return out;
+			}
+		for (size_t i = 0; i < R; ++i)
+		{
+			values[i] = T();
+			for (size_t j = 0; j < C; ++j)
+				values[i] += m.elements[i][j] * source[j];
+		}
+		Vector<R, T> out;
+		detail::array_to_tuple(out, values);
+		return out;
+	}
+	template<size_t N, typename T>
+	requires (N > 1)
+	static constexpr Vector<N - 1, T> operator* (const Matrix<N, N, T>& m, const Vector<N - 1, T>& vector)
+	{
+		T source[N - 1], values[N - 1];
+		detail::tuple_to_array(source, vector);
+		detail::matrix_transform<false>(values, m, source, N - 1);
+		Vector<N - 1, T> out;
+		detail::array_to_tuple(out, values);
+		return out;
+	}
+	template<size_t N, typename T>
+	requires (N > 1)
+	static constexpr Point<N - 1, T> operator* (const Matrix<N, N, T>& m, const Point<N - 1, T>& point)
+	{
+		T source[N - 1], values[N - 1];
+		detail::tuple_to_array(source, point);
+		detail::matrix_transform<true>(values, m, source, N - 1);
+		Point<N - 1, T> out;
+		detail::array_to_tuple(out, values);
+		return out;
+	}
+
+	template<size_t N, typename T>
+	static void transform(const Matrix<N, N, T>& m, std::span<const std::type_identity_t<Point<N - 1, T>>> in, std::span<std::type_identity_t<Point<N - 1, T>>> out)
+	{
+		detail::matrix_transform_span<true>(m, in, out);
+	}
+	template<size_t N, typename T>
+	static void transform(const Matrix<N, N, T>& m, std::span<const std::type_identity_t<Vector<N - 1, T>>> in, std::span<std::type_identity_t<Vector<N - 1, T>>> out)
+	{
+		detail::matrix_transform_span<false>(m, in, out);
+	}
+	template<size_t N, typename T>
+	static void transform_points(const Matrix<N, N, T>& m, CoordinatesSoA<N - 1, T>& soa)
+	{
+		detail::matrix_transform_soa<true>(m, soa);
+	}
+	template<size_t N, typename T>
+	static void transform_vectors(const Matrix<N, N, T>& m, CoordinatesSoA<N - 1, T>& soa)
+	{
+		detail::matrix_transform_soa<false>(m, soa);
+	}
+}
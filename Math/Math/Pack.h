@@ -0,0 +1,555 @@
+#pragma once
+#include <cmath>
+#include <limits>
+#include "Simd.h"
+
+namespace math
+{
+	// N lanes of T held in one native register. Kernels are written once against the operators below
+	// and the detail:: helpers, and instantiated for both plain T and every available Pack.
+	template<typename T, size_t N>
+	struct Pack
+	{
+		static constexpr bool enabled = false;
+	};
+
+#if defined(MATH_ISA_SSE2)
+	template<>
+	struct Pack<float, 4>
+	{
+	public:
+		using value_type = float;
+		using register_type = __m128;
+		static constexpr bool enabled = true;
+		static constexpr size_t lanes = 4;
+
+		struct Mask
+		{
+			Mask operator& (const Mask& rhs) const { return { _mm_and_ps(bits, rhs.bits) }; }
+			Mask operator| (const Mask& rhs) const { return { _mm_or_ps(bits, rhs.bits) }; }
+			Mask operator! () const { return { _mm_xor_ps(bits, _mm_castsi128_ps(_mm_set1_epi32(-1))) }; }
+			bool any() const { return _mm_movemask_ps(bits) != 0; }
+			bool all() const { return _mm_movemask_ps(bits) == 0xF; }
+
+			__m128 bits;
+		};
+
+		Pack() : value(_mm_setzero_ps()) {}
+		Pack(const __m128& value) : value(value) {}
+		Pack(float value) : value(_mm_set1_ps(value)) {}
+
+		static Pack load(const float* pointer) { return _mm_loadu_ps(pointer); }
+		void store(float* pointer) const { _mm_storeu_ps(pointer, value); }
+
+		Pack operator- () const { return _mm_xor_ps(value, _mm_set1_ps(-0.0f)); }
+		Pack operator+ (const Pack& rhs) const { return _mm_add_ps(value, rhs.value); }
+		Pack operator- (const Pack& rhs) const { return _mm_sub_ps(value, rhs.value); }
+		Pack operator* (const Pack& rhs) const { return _mm_mul_ps(value, rhs.value); }
+		Pack operator/ (const Pack& rhs) const { return _mm_div_ps(value, rhs.value); }
+
+		Mask operator<  (const Pack& rhs) const { return { _mm_cmplt_ps(value, rhs.value) }; }
+		Mask operator>  (const Pack& rhs) const { return { _mm_cmpgt_ps(value, rhs.value) }; }
+		Mask operator<= (const Pack& rhs) const { return { _mm_cmple_ps(value, rhs.value) }; }
+		Mask operator>= (const Pack& rhs) const { return { _mm_cmpge_ps(value, rhs.value) }; }
+
+		__m128 value;
+	};
+
+	template<>
+	struct Pack<double, 2>
+	{
+	public:
+		using value_type = double;
+		using register_type = __m128d;
+		static constexpr bool enabled = true;
+		static constexpr size_t lanes = 2;
+
+		struct Mask
+		{
+			Mask operator& (const Mask& rhs) const { return { _mm_and_pd(bits, rhs.bits) }; }
+			Mask operator| (const Mask& rhs) const { return { _mm_or_pd(bits, rhs.bits) }; }
+			Mask operator! () const { return { _mm_xor_pd(bits, _mm_castsi128_pd(_mm_set1_epi32(-1))) }; }
+			bool any() const { return _mm_movemask_pd(bits) != 0; }
+			bool all() const { return _mm_movemask_pd(bits) == 0x3; }
+
+			__m128d bits;
+		};
+
+		Pack() : value(_mm_setzero_pd()) {}
+		Pack(const __m128d& value) : value(value) {}
+		Pack(double value) : value(_mm_set1_pd(value)) {}
+
+		static Pack load(const double* pointer) { return _mm_loadu_pd(pointer); }
+		void store(double* pointer) const { _mm_storeu_pd(pointer, value); }
+
+		Pack operator- () const { return _mm_xor_pd(value, _mm_set1_pd(-0.0)); }
+		Pack operator+ (const Pack& rhs) const { return _mm_add_pd(value, rhs.value); }
+		Pack operator- (const Pack& rhs) const { return _mm_sub_pd(value, rhs.value); }
+		Pack operator* (const Pack& rhs) const { return _mm_mul_pd(value, rhs.value); }
+		Pack operator/ (const Pack& rhs) const { return _mm_div_pd(value, rhs.value); }
+
+		Mask operator<  (const Pack& rhs) const { return { _mm_cmplt_pd(value, rhs.value) }; }
+		Mask operator>  (const Pack& rhs) const { return { _mm_cmpgt_pd(value, rhs.value) }; }
+		Mask operator<= (const Pack& rhs) const { return { _mm_cmple_pd(value, rhs.value) }; }
+		Mask operator>= (const Pack& rhs) const { return { _mm_cmpge_pd(value, rhs.value) }; }
+
+		__m128d value;
+	};
+#endif
+
+#if defined(MATH_ISA_AVX)
+	template<>
+	struct Pack<float, 8>
+	{
+	public:
+		using value_type = float;
+		using register_type = __m256;
+		static constexpr bool enabled = true;
+		static constexpr size_t lanes = 8;
+
+		struct Mask
+		{
+			Mask operator& (const Mask& rhs) const { return { _mm256_and_ps(bits, rhs.bits) }; }
+			Mask operator| (const Mask& rhs) const { return { _mm256_or_ps(bits, rhs.bits) }; }
+			Mask operator! () const { return { _mm256_xor_ps(bits, _mm256_castsi256_ps(_mm256_set1_epi32(-1))) }; }
+			bool any() const { return _mm256_movemask_ps(bits) != 0; }
+			bool all() const { return _mm256_movemask_ps(bits) == 0xFF; }
+
+			__m256 bits;
+		};
+
+		Pack() : value(_mm256_setzero_ps()) {}
+		Pack(const __m256& value) : value(value) {}
+		Pack(float value) : value(_mm256_set1_ps(value)) {}
+
+		static Pack load(const float* pointer) { return _mm256_loadu_ps(pointer); }
+		void store(float* pointer) const { _mm256_storeu_ps(pointer, value); }
+
+		Pack operator- () const { return _mm256_xor_ps(value, _mm256_set1_ps(-0.0f)); }
+		Pack operator+ (const Pack& rhs) const { return _mm256_add_ps(value, rhs.value); }
+		Pack operator- (const Pack& rhs) const { return _mm256_sub_ps(value, rhs.value); }
+		Pack operator* (const Pack& rhs) const { return _mm256_mul_ps(value, rhs.value); }
+		Pack operator/ (const Pack& rhs) const { return _mm256_div_ps(value, rhs.value); }
+
+		Mask operator<  (const Pack& rhs) const { return { _mm256_cmp_ps(value, rhs.value, _CMP_LT_OQ) }; }
+		Mask operator>  (const Pack& rhs) const { return { _mm256_cmp_ps(value, rhs.value, _CMP_GT_OQ) }; }
+		Mask operator<= (const Pack& rhs) const { return { _mm256_cmp_ps(value, rhs.value, _CMP_LE_OQ) }; }
+		Mask operator>= (const Pack& rhs) const { return { _mm256_cmp_ps(value, rhs.value, _CMP_GE_OQ) }; }
+
+		__m256 value;
+	};
+
+	template<>
+	struct Pack<double, 4>
+	{
+	public:
+		using value_type = double;
+		using register_type = __m256d;
+		static constexpr bool enabled = true;
+		static constexpr size_t lanes = 4;
+
+		struct Mask
+		{
+			Mask operator& (const Mask& rhs) const { return { _mm256_and_pd(bits, rhs.bits) }; }
+			Mask operator| (const Mask& rhs) const { return { _mm256_or_pd(bits, rhs.bits) }; }
+			Mask operator! () const { return { _mm256_xor_pd(bits, _mm256_castsi256_pd(_mm256_set1_epi32(-1))) }; }
+			bool any() const { return _mm256_movemask_pd(bits) != 0; }
+			bool all() const { return _mm256_movemask_pd(bits) == 0xF; }
+
+			__m256d bits;
+		};
+
+		Pack() : value(_mm256_setzero_pd()) {}
+		Pack(const __m256d& value) : value(value) {}
+		Pack(double value) : value(_mm256_set1_pd(value)) {}
+
+		static Pack load(const double* pointer) { return _mm256_loadu_pd(pointer); }
+		void store(double* pointer) const { _mm256_storeu_pd(pointer, value); }
+
+		Pack operator- () const { return _mm256_xor_pd(value, _mm256_set1_pd(-0.0)); }
+		Pack operator+ (const Pack& rhs) const { return _mm256_add_pd(value, rhs.value); }
+		Pack operator- (const Pack& rhs) const { return _mm256_sub_pd(value, rhs.value); }
+		Pack operator* (const Pack& rhs) const { return _mm256_mul_pd(value, rhs.value); }
+		Pack operator/ (const Pack& rhs) const { return _mm256_div_pd(value, rhs.value); }
+
+		Mask operator<  (const Pack& rhs) const { return { _mm256_cmp_pd(value, rhs.value, _CMP_LT_OQ) }; }
+		Mask operator>  (const Pack& rhs) const { return { _mm256_cmp_pd(value, rhs.value, _CMP_GT_OQ) }; }
+		Mask operator<= (const Pack& rhs) const { return { _mm256_cmp_pd(value, rhs.value, _CMP_LE_OQ) }; }
+		Mask operator>= (const Pack& rhs) const { return { _mm256_cmp_pd(value, rhs.value, _CMP_GE_OQ) }; }
+
+		__m256d value;
+	};
+#endif
+
+#if defined(MATH_ISA_AVX512F)
+	template<>
+	struct Pack<float, 16>
+	{
+	public:
+		using value_type = float;
+		using register_type = __m512;
+		static constexpr bool enabled = true;
+		static constexpr size_t lanes = 16;
+
+		struct Mask
+		{
+			Mask operator& (const Mask& rhs) const { return { static_cast<__mmask16>(bits & rhs.bits) }; }
+			Mask operator| (const Mask& rhs) const { return { static_cast<__mmask16>(bits | rhs.bits) }; }
+			Mask operator! () const { return { static_cast<__mmask16>(~bits) }; }
+			bool any() const { return bits != 0; }
+			bool all() const { return bits == 0xFFFF; }
+
+			__mmask16 bits;
+		};
+
+		Pack() : value(_mm512_setzero_ps()) {}
+		Pack(const __m512& value) : value(value) {}
+		Pack(float value) : value(_mm512_set1_ps(value)) {}
+
+		static Pack load(const float* pointer) { return _mm512_loadu_ps(pointer); }
+		void store(float* pointer) const { _mm512_storeu_ps(pointer, value); }
+
+		Pack operator- () const { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(value), _mm512_set1_epi32(static_cast<int>(0x80000000u)))); }
+		Pack operator+ (const Pack& rhs) const { return _mm512_add_ps(value, rhs.value); }
+		Pack operator- (const Pack& rhs) const { return _mm512_sub_ps(value, rhs.value); }
+		Pack operator* (const Pack& rhs) const { return _mm512_mul_ps(value, rhs.value); }
+		Pack operator/ (const Pack& rhs) const { return _mm512_div_ps(value, rhs.value); }
+
+		Mask operator<  (const Pack& rhs) const { return { _mm512_cmp_ps_mask(value, rhs.value, _CMP_LT_OQ) }; }
+		Mask operator>  (const Pack& rhs) const { return { _mm512_cmp_ps_mask(value, rhs.value, _CMP_GT_OQ) }; }
+		Mask operator<= (const Pack& rhs) const { return { _mm512_cmp_ps_mask(value, rhs.value, _CMP_LE_OQ) }; }
+		Mask operator>= (const Pack& rhs) const { return { _mm512_cmp_ps_mask(value, rhs.value, _CMP_GE_OQ) }; }
+
+		__m512 value;
+	};
+
+	template<>
+	struct Pack<double, 8>
+	{
+	public:
+		using value_type = double;
+		using register_type = __m512d;
+		static constexpr bool enabled = true;
+		static constexpr size_t lanes = 8;
+
+		struct Mask
+		{
+			Mask operator& (const Mask& rhs) const { return { static_cast<__mmask8>(bits & rhs.bits) }; }
+			Mask operator| (const Mask& rhs) const { return { static_cast<__mmask8>(bits | rhs.bits) }; }
+			Mask operator! () const { return { static_cast<__mmask8>(~bits) }; }
+			bool any() const { return bits != 0; }
+			bool all() const { return bits == 0xFF; }
+
+			__mmask8 bits;
+		};
+
+		Pack() : value(_mm512_setzero_pd()) {}
+		Pack(const __m512d& value) : value(value) {}
+		Pack(double value) : value(_mm512_set1_pd(value)) {}
+
+		static Pack load(const double* pointer) { return _mm512_loadu_pd(pointer); }
+		void store(double* pointer) const { _mm512_storeu_pd(pointer, value); }
+
+		Pack operator- () const { return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(value), _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ull)))); }
+		Pack operator+ (const Pack& rhs) const { return _mm512_add_pd(value, rhs.value); }
+		Pack operator- (const Pack& rhs) const { return _mm512_sub_pd(value, rhs.value); }
+		Pack operator* (const Pack& rhs) const { return _mm512_mul_pd(value, rhs.value); }
+		Pack operator/ (const Pack& rhs) const { return _mm512_div_pd(value, rhs.value); }
+
+		Mask operator<  (const Pack& rhs) const { return { _mm512_cmp_pd_mask(value, rhs.value, _CMP_LT_OQ) }; }
+		Mask operator>  (const Pack& rhs) const { return { _mm512_cmp_pd_mask(value, rhs.value, _CMP_GT_OQ) }; }
+		Mask operator<= (const Pack& rhs) const { return { _mm512_cmp_pd_mask(value, rhs.value, _CMP_LE_OQ) }; }
+		Mask operator>= (const Pack& rhs) const { return { _mm512_cmp_pd_mask(value, rhs.value, _CMP_GE_OQ) }; }
+
+		__m512d value;
+	};
+#endif
+
+#if defined(MATH_ISA_NEON)
+	template<>
+	struct Pack<float, 4>
+	{
+	public:
+		using value_type = float;
+		using register_type = float32x4_t;
+		static constexpr bool enabled = true;
+		static constexpr size_t lanes = 4;
+
+		struct Mask
+		{
+			Mask operator& (const Mask& rhs) const { return { vandq_u32(bits, rhs.bits) }; }
+			Mask operator| (const Mask& rhs) const { return { vorrq_u32(bits, rhs.bits) }; }
+			Mask operator! () const { return { vmvnq_u32(bits) }; }
+			bool any() const { return vmaxvq_u32(bits) != 0; }
+			bool all() const { return vminvq_u32(bits) != 0; }
+
+			uint32x4_t bits;
+		};
+
+		Pack() : value(vdupq_n_f32(0.0f)) {}
+		Pack(const float32x4_t& value) : value(value) {}
+		Pack(float value) : value(vdupq_n_f32(value)) {}
+
+		static Pack load(const float* pointer) { return vld1q_f32(pointer); }
+		void store(float* pointer) const { vst1q_f32(pointer, value); }
+
+		Pack operator- () const { return vnegq_f32(value); }
+		Pack operator+ (const Pack& rhs) const { return vaddq_f32(value, rhs.value); }
+		Pack operator- (const Pack& rhs) const { return vsubq_f32(value, rhs.value); }
+		Pack operator* (const Pack& rhs) const { return vmulq_f32(value, rhs.value); }
+		Pack operator/ (const Pack& rhs) const { return vdivq_f32(value, rhs.value); }
+
+		Mask operator<  (const Pack& rhs) const { return { vcltq_f32(value, rhs.value) }; }
+		Mask operator>  (const Pack& rhs) const { return { vcgtq_f32(value, rhs.value) }; }
+		Mask operator<= (const Pack& rhs) const { return { vcleq_f32(value, rhs.value) }; }
+		Mask operator>= (const Pack& rhs) const { return { vcgeq_f32(value, rhs.value) }; }
+
+		float32x4_t value;
+	};
+
+	template<>
+	struct Pack<double, 2>
+	{
+	public:
+		using value_type = double;
+		using register_type = float64x2_t;
+		static constexpr bool enabled = true;
+		static constexpr size_t lanes = 2;
+
+		struct Mask
+		{
+			Mask operator& (const Mask& rhs) const { return { vandq_u64(bits, rhs.bits) }; }
+			Mask operator| (const Mask& rhs) const { return { vorrq_u64(bits, rhs.bits) }; }
+			Mask operator! () const { return { veorq_u64(bits, vdupq_n_u64(~0ull)) }; }
+			bool any() const { return vmaxvq_u32(vreinterpretq_u32_u64(bits)) != 0; }
+			bool all() const { return vminvq_u32(vreinterpretq_u32_u64(bits)) != 0; }
+
+			uint64x2_t bits;
+		};
+
+		Pack() : value(vdupq_n_f64(0.0)) {}
+		Pack(const float64x2_t& value) : value(value) {}
+		Pack(double value) : value(vdupq_n_f64(value)) {}
+
+		static Pack load(const double* pointer) { return vld1q_f64(pointer); }
+		void store(double* pointer) const { vst1q_f64(pointer, value); }
+
+		Pack operator- () const { return vnegq_f64(value); }
+		Pack operator+ (const Pack& rhs) const { return vaddq_f64(value, rhs.value); }
+		Pack operator- (const Pack& rhs) const { return vsubq_f64(value, rhs.value); }
+		Pack operator* (const Pack& rhs) const { return vmulq_f64(value, rhs.value); }
+		Pack operator/ (const Pack& rhs) const { return vdivq_f64(value, rhs.value); }
+
+		Mask operator<  (const Pack& rhs) const { return { vcltq_f64(value, rhs.value) }; }
+		Mask operator>  (const Pack& rhs) const { return { vcgtq_f64(value, rhs.value) }; }
+		Mask operator<= (const Pack& rhs) const { return { vcleq_f64(value, rhs.value) }; }
+		Mask operator>= (const Pack& rhs) const { return { vcgeq_f64(value, rhs.value) }; }
+
+		float64x2_t value;
+	};
+#endif
+
+	namespace detail
+	{
+		template<typename V>
+		struct pack_traits
+		{
+			using value_type = V;
+			using mask_type = bool;
+			static constexpr size_t lanes = 1;
+		};
+		template<typename T, size_t N>
+		struct pack_traits<Pack<T, N>>
+		{
+			using value_type = T;
+			using mask_type = typename Pack<T, N>::Mask;
+			static constexpr size_t lanes = N;
+		};
+
+		template<typename T>
+		requires std::is_floating_point_v<T>
+		static T select(bool mask, const T& a, const T& b) { return mask ? a : b; }
+		template<typename T>
+		requires std::is_floating_point_v<T>
+		static T round_nearest(const T& a) { return std::nearbyint(a); }
+		template<typename T>
+		requires std::is_floating_point_v<T>
+		static T abs(const T& a) { return std::fabs(a); }
+		template<typename T>
+		requires std::is_floating_point_v<T>
+		static T square_root(const T& a) { return std::sqrt(a); }
+		template<typename T>
+		requires std::is_floating_point_v<T>
+		static T copysign(const T& magnitude, const T& sign) { return std::copysign(magnitude, sign); }
+		inline bool any(bool mask) { return mask; }
+		inline bool all(bool mask) { return mask; }
+
+		template<typename M>
+		requires requires(const M& mask) { mask.any(); }
+		static bool any(const M& mask) { return mask.any(); }
+		template<typename M>
+		requires requires(const M& mask) { mask.all(); }
+		static bool all(const M& mask) { return mask.all(); }
+
+#if defined(MATH_ISA_SSE2)
+		inline Pack<float, 4> select(const Pack<float, 4>::Mask& mask, const Pack<float, 4>& a, const Pack<float, 4>& b)
+		{
+#if defined(MATH_ISA_SSE41)
+			return _mm_blendv_ps(b.value, a.value, mask.bits);
+#else
+			return _mm_or_ps(_mm_and_ps(mask.bits, a.value), _mm_andnot_ps(mask.bits, b.value));
+#endif
+		}
+		inline Pack<float, 4> abs(const Pack<float, 4>& a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.value); }
+		inline Pack<float, 4> square_root(const Pack<float, 4>& a) { return _mm_sqrt_ps(a.value); }
+		inline Pack<float, 4> copysign(const Pack<float, 4>& magnitude, const Pack<float, 4>& sign)
+		{
+			const __m128 mask = _mm_set1_ps(-0.0f);
+			return _mm_or_ps(_mm_andnot_ps(mask, magnitude.value), _mm_and_ps(mask, sign.value));
+		}
+		// Without SSE4.1 this goes through int32, which overflows from 2^31; floats from 2^23 up are integers already
+		// and pass through, as do NaNs.
+		inline Pack<float, 4> round_nearest(const Pack<float, 4>& a)
+		{
+#if defined(MATH_ISA_SSE41)
+			return _mm_round_ps(a.value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else
+			const Pack<float, 4> rounded = copysign(Pack<float, 4>(_mm_cvtepi32_ps(_mm_cvtps_epi32(a.value))), a);
+			return select(abs(a) < Pack<float, 4>(8388608.0f), rounded, a);
+#endif
+		}
+
+		inline Pack<double, 2> select(const Pack<double, 2>::Mask& mask, const Pack<double, 2>& a, const Pack<double, 2>& b)
+		{
+#if defined(MATH_ISA_SSE41)
+			return _mm_blendv_pd(b.value, a.value, mask.bits);
+#else
+			return _mm_or_pd(_mm_and_pd(mask.bits, a.value), _mm_andnot_pd(mask.bits, b.value));
+#endif
+		}
+		inline Pack<double, 2> abs(const Pack<double, 2>& a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.value); }
+		inline Pack<double, 2> square_root(const Pack<double, 2>& a) { return _mm_sqrt_pd(a.value); }
+		inline Pack<double, 2> copysign(const Pack<double, 2>& magnitude, const Pack<double, 2>& sign)
+		{
+			const __m128d mask = _mm_set1_pd(-0.0);
+			return _mm_or_pd(_mm_andnot_pd(mask, magnitude.value), _mm_and_pd(mask, sign.value));
+		}
+		// Without SSE4.1 there is no conversion through int64, so below 2^52 adding and removing 2^52 rounds to an
+		// integer in the current rounding mode; doubles from 2^52 up are integers already and pass through, as do NaNs.
+		inline Pack<double, 2> round_nearest(const Pack<double, 2>& a)
+		{
+#if defined(MATH_ISA_SSE41)
+			return _mm_round_pd(a.value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else
+			const Pack<double, 2> magnitude = abs(a), shift(4503599627370496.0);
+			return select(magnitude < shift, copysign((magnitude + shift) - shift, a), a);
+#endif
+		}
+#endif
+
+#if defined(MATH_ISA_AVX)
+		inline Pack<float, 8> select(const Pack<float, 8>::Mask& mask, const Pack<float, 8>& a, const Pack<float, 8>& b) { return _mm256_blendv_ps(b.value, a.value, mask.bits); }
+		inline Pack<float, 8> round_nearest(const Pack<float, 8>& a) { return _mm256_round_ps(a.value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		inline Pack<float, 8> abs(const Pack<float, 8>& a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.value); }
+		inline Pack<float, 8> square_root(const Pack<float, 8>& a) { return _mm256_sqrt_ps(a.value); }
+		inline Pack<float, 8> copysign(const Pack<float, 8>& magnitude, const Pack<float, 8>& sign)
+		{
+			const __m256 mask = _mm256_set1_ps(-0.0f);
+			return _mm256_or_ps(_mm256_andnot_ps(mask, magnitude.value), _mm256_and_ps(mask, sign.value));
+		}
+
+		inline Pack<double, 4> select(const Pack<double, 4>::Mask& mask, const Pack<double, 4>& a, const Pack<double, 4>& b) { return _mm256_blendv_pd(b.value, a.value, mask.bits); }
+		inline Pack<double, 4> round_nearest(const Pack<double, 4>& a) { return _mm256_round_pd(a.value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		inline Pack<double, 4> abs(const Pack<double, 4>& a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.value); }
+		inline Pack<double, 4> square_root(const Pack<double, 4>& a) { return _mm256_sqrt_pd(a.value); }
+		inline Pack<double, 4> copysign(const Pack<double, 4>& magnitude, const Pack<double, 4>& sign)
+		{
+			const __m256d mask = _mm256_set1_pd(-0.0);
+			return _mm256_or_pd(_mm256_andnot_pd(mask, magnitude.value), _mm256_and_pd(mask, sign.value));
+		}
+#endif
+
+#if defined(MATH_ISA_AVX512F)
+		// The maskz forms with every lane set: GCC implements the unmasked ones with an undefined source register,
+		// which -Wmaybe-uninitialized reports.
+		inline Pack<float, 16> select(const Pack<float, 16>::Mask& mask, const Pack<float, 16>& a, const Pack<float, 16>& b) { return _mm512_mask_blend_ps(mask.bits, b.value, a.value); }
+		inline Pack<float, 16> round_nearest(const Pack<float, 16>& a) { return _mm512_maskz_roundscale_ps(0xFFFF, a.value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		inline Pack<float, 16> abs(const Pack<float, 16>& a) { return _mm512_abs_ps(a.value); }
+		inline Pack<float, 16> square_root(const Pack<float, 16>& a) { return _mm512_maskz_sqrt_ps(0xFFFF, a.value); }
+		inline Pack<float, 16> copysign(const Pack<float, 16>& magnitude, const Pack<float, 16>& sign)
+		{
+			const __m512i mask = _mm512_set1_epi32(static_cast<int>(0x80000000u));
+			return _mm512_castsi512_ps(_mm512_or_si512(_mm512_maskz_andnot_epi32(0xFFFF, mask, _mm512_castps_si512(magnitude.value)), _mm512_and_si512(mask, _mm512_castps_si512(sign.value))));
+		}
+
+		inline Pack<double, 8> select(const Pack<double, 8>::Mask& mask, const Pack<double, 8>& a, const Pack<double, 8>& b) { return _mm512_mask_blend_pd(mask.bits, b.value, a.value); }
+		inline Pack<double, 8> round_nearest(const Pack<double, 8>& a) { return _mm512_maskz_roundscale_pd(0xFF, a.value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		inline Pack<double, 8> abs(const Pack<double, 8>& a) { return _mm512_abs_pd(a.value); }
+		inline Pack<double, 8> square_root(const Pack<double, 8>& a) { return _mm512_maskz_sqrt_pd(0xFF, a.value); }
+		inline Pack<double, 8> copysign(const Pack<double, 8>& magnitude, const Pack<double, 8>& sign)
+		{
+			const __m512i mask = _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ull));
+			return _mm512_castsi512_pd(_mm512_or_si512(_mm512_maskz_andnot_epi64(0xFF, mask, _mm512_castpd_si512(magnitude.value)), _mm512_and_si512(mask, _mm512_castpd_si512(sign.value))));
+		}
+#endif
+
+#if defined(MATH_ISA_NEON)
+		inline Pack<float, 4> select(const Pack<float, 4>::Mask& mask, const Pack<float, 4>& a, const Pack<float, 4>& b) { return vbslq_f32(mask.bits, a.value, b.value); }
+		inline Pack<float, 4> round_nearest(const Pack<float, 4>& a) { return vrndnq_f32(a.value); }
+		inline Pack<float, 4> abs(const Pack<float, 4>& a) { return vabsq_f32(a.value); }
+		inline Pack<float, 4> square_root(const Pack<float, 4>& a) { return vsqrtq_f32(a.value); }
+		inline Pack<float, 4> copysign(const Pack<float, 4>& magnitude, const Pack<float, 4>& sign) { return vbslq_f32(vdupq_n_u32(0x80000000u), sign.value, magnitude.value); }
+
+		inline Pack<double, 2> select(const Pack<double, 2>::Mask& mask, const Pack<double, 2>& a, const Pack<double, 2>& b) { return vbslq_f64(mask.bits, a.value, b.value); }
+		inline Pack<double, 2> round_nearest(const Pack<double, 2>& a) { return vrndnq_f64(a.value); }
+		inline Pack<double, 2> abs(const Pack<double, 2>& a) { return vabsq_f64(a.value); }
+		inline Pack<double, 2> square_root(const Pack<double, 2>& a) { return vsqrtq_f64(a.value); }
+		inline Pack<double, 2> copysign(const Pack<double, 2>& magnitude, const Pack<double, 2>& sign) { return vbslq_f64(vdupq_n_u64(0x8000000000000000ull), sign.value, magnitude.value); }
+#endif
+
+		// Overloads of the scalar fused_multiply_add in Simd.h, fused under the same condition.
+#if defined(MATH_ISA_FMA) && defined(MATH_ISA_SSE2)
+		inline Pack<float, 4> fused_multiply_add(const Pack<float, 4>& a, const Pack<float, 4>& b, const Pack<float, 4>& c) { return _mm_fmadd_ps(a.value, b.value, c.value); }
+		inline Pack<double, 2> fused_multiply_add(const Pack<double, 2>& a, const Pack<double, 2>& b, const Pack<double, 2>& c) { return _mm_fmadd_pd(a.value, b.value, c.value); }
+#endif
+#if defined(MATH_ISA_FMA) && defined(MATH_ISA_AVX)
+		inline Pack<float, 8> fused_multiply_add(const Pack<float, 8>& a, const Pack<float, 8>& b, const Pack<float, 8>& c) { return _mm256_fmadd_ps(a.value, b.value, c.value); }
+		inline Pack<double, 4> fused_multiply_add(const Pack<double, 4>& a, const Pack<double, 4>& b, const Pack<double, 4>& c) { return _mm256_fmadd_pd(a.value, b.value, c.value); }
+#endif
+#if defined(MATH_ISA_AVX512F)
+		inline Pack<float, 16> fused_multiply_add(const Pack<float, 16>& a, const Pack<float, 16>& b, const Pack<float, 16>& c) { return _mm512_fmadd_ps(a.value, b.value, c.value); }
+		inline Pack<double, 8> fused_multiply_add(const Pack<double, 8>& a, const Pack<double, 8>& b, const Pack<double, 8>& c) { return _mm512_fmadd_pd(a.value, b.value, c.value); }
+#endif
+#if defined(MATH_ISA_NEON)
+		inline Pack<float, 4> fused_multiply_add(const Pack<float, 4>& a, const Pack<float, 4>& b, const Pack<float, 4>& c) { return vfmaq_f32(c.value, a.value, b.value); }
+		inline Pack<double, 2> fused_multiply_add(const Pack<double, 2>& a, const Pack<double, 2>& b, const Pack<double, 2>& c) { return vfmaq_f64(c.value, a.value, b.value); }
+#endif
+
+		template<typename T>
+		using widest_pack = std::conditional_t<Pack<T, 64 / sizeof(T)>::enabled, Pack<T, 64 / sizeof(T)>,
+			std::conditional_t<Pack<T, 32 / sizeof(T)>::enabled, Pack<T, 32 / sizeof(T)>,
+			std::conditional_t<Pack<T, 16 / sizeof(T)>::enabled, Pack<T, 16 / sizeof(T)>, T>>>;
+
+		template<typename V, typename T>
+		static V load(const T* pointer)
+		{
+			if constexpr (std::is_same_v<V, T>)
+				return *pointer;
+			else
+				return V::load(pointer);
+		}
+		template<typename V, typename T>
+		static void store(T* pointer, const V& value)
+		{
+			if constexpr (std::is_same_v<V, T>)
+				*pointer = value;
+			else
+				value.store(pointer);
+		}
+
+		template<typename V>
+		static auto negative(const V& value) { return copysign(V(1), value) < V(0); }
+		template<typename V>
+		static auto finite(const V& value) { return abs(value) <= V(std::numeric_limits<typename pack_traits<V>::value_type>::max()); }
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Ray.h"
+
+namespace math
+{
+	// The points x with dot(normal, x) == offset. The normal need not be normalised; signed distances are then in
+	// multiples of its length.
+	template<typename T>
+	requires std::is_floating_point_v<T>
+	struct Plane
+	{
+	public:
+		using point_type = Point<3, T>;
+		using vector_type = Vector<3, T>;
+
+		constexpr Plane() : normal(T(0), T(0), T(1)), offset(0) {}
+		constexpr Plane(const vector_type& normal, const T& offset) : normal(normal), offset(offset) {}
+		constexpr Plane(const vector_type& normal, const point_type& point) : normal(normal), offset(dot(normal, vector_type(point))) {}
+
+		// Positive on the side the normal points to.
+		constexpr T signed_distance(const point_type& point) const { return dot(normal, vector_type(point)) - offset; }
+
+		vector_type normal;
+		T offset;
+	};
+
+	namespace detail
+	{
+		// Hits either side of the plane; rays parallel to it miss.
+		template<typename V, typename T>
+		static auto plane_intersect(const V (&origin)[3], const V (&direction)[3], const Plane<T>& plane, V& distance)
+		{
+			V normal[3];
+			soa_splat(normal, plane.normal);
+			const V t = (V(plane.offset) - soa_dot(normal, origin)) / soa_dot(normal, direction);
+			const auto hit = (t >= V(0)) & (t < distance);
+			distance = select(hit, t, distance);
+			return hit;
+		}
+	}
+
+	template<typename T>
+	static bool intersect(const Ray<3, T>& ray, const Plane<T>& plane, T& distance)
+	{
+		return detail::ray_intersect(ray, distance, [&]<typename V>(const V (&origin)[3], const V (&direction)[3], V& nearest) { return detail::plane_intersect(origin, direction, plane, nearest); });
+	}
+	template<typename T, size_t N>
+	static uint32_t intersect(const RayPacket<3, T, N>& rays, const Plane<T>& plane, T (&distance)[N])
+	{
+		return detail::packet_intersect(rays, distance, [&]<typename V>(const V (&origin)[3], const V (&direction)[3], V& nearest) { return detail::plane_intersect(origin, direction, plane, nearest); });
+	}
+}
@@ -8,8 +8,6 @@ namespace math
 	{
 		constexpr Point() : Coordinates<D, T>() {}
 		constexpr Point(const T& value) : Coordinates<D, T>(value) {}
-		constexpr Point(const Point& rhs) : Coordinates<D, T>(rhs) {}
-		constexpr Point(Point&& rhs) noexcept : Coordinates<D, T>(std::move(rhs)) {}
 	};
 
 	template<typename T>
@@ -17,8 +15,6 @@ namespace math
 	{
 		constexpr Point() : Coordinates<1, T>() {}
 		constexpr Point(const T& x) : Coordinates<1, T>(x) {}
-		constexpr Point(const Point& rhs) : Coordinates<1, T>(rhs) {}
-		constexpr Point(Point&& rhs) noexcept : Coordinates<1, T>(std::move(rhs)) {}
 	};
 
 	template<typename T>
@@ -27,8 +23,6 @@ namespace math
 		constexpr Point() : Coordinates<2, T>() {}
 		constexpr Point(const T& value) : Coordinates<2, T>(value) {}
 		constexpr Point(const T& x, const T& y) : Coordinates<2, T>(x, y) {}
-		constexpr Point(const Point& rhs) : Coordinates<2, T>(rhs) {}
-		constexpr Point(Point&& rhs) noexcept : Coordinates<2, T>(std::move(rhs)) {}
 	};
 
 	template<typename T>
@@ -37,8 +31,6 @@ namespace math
 		constexpr Point() : Coordinates<3, T>() {}
 		constexpr Point(const T& value) : Coordinates<3, T>(value) {}
 		constexpr Point(const T& x, const T& y, const T& z) : Coordinates<3, T>(x, y, z) {}
-		constexpr Point(const Point& rhs) : Coordinates<3, T>(rhs) {}
-		constexpr Point(Point&& rhs) noexcept : Coordinates<3, T>(std::move(rhs)) {}
 	};
 
 	template<typename T>
@@ -47,7 +39,7 @@ namespace math
 		constexpr Point() : Coordinates<4, T>() {}
 		constexpr Point(const T& value) : Coordinates<4, T>(value) {}
 		constexpr Point(const T& x, const T& y, const T& z, const T& w) : Coordinates<4, T>(x, y, z, w) {}
-		constexpr Point(const Point& rhs) : Coordinates<4, T>(rhs) {}
-		constexpr Point(Point&& rhs) noexcept : Coordinates<4, T>(std::move(rhs)) {}
 	};
+
+	static_assert(detail::trivial_tuples<Point, float>() && detail::trivial_tuples<Point, double>() && detail::trivial_tuples<Point, int>());
 }
\ No newline at end of file
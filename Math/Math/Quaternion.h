@@ -0,0 +1,270 @@
+#pragma once
+#include <cassert>
+#include <span>
+#include "Vector.h"
+#include "Matrix.h"
+#include "CoordinatesSoA.h"
+#include "Pack.h"
+
+namespace math
+{
+	template<typename T>
+	requires std::is_floating_point_v<T>
+	struct Quaternion;
+
+	namespace detail
+	{
+		// v' = v + w t + u x t with u the vector part and t = 2 u x v; written once over V = T or Pack<T, N>.
+		template<typename V>
+		static constexpr void quaternion_rotate(const V& qx, const V& qy, const V& qz, const V& qw, V& x, V& y, V& z)
+		{
+			const V tx = V(2) * (qy * z - qz * y);
+			const V ty = V(2) * (qz * x - qx * z);
+			const V tz = V(2) * (qx * y - qy * x);
+			x = x + qw * tx + (qy * tz - qz * ty);
+			y = y + qw * ty + (qz * tx - qx * tz);
+			z = z + qw * tz + (qx * ty - qy * tx);
+		}
+
+		template<typename V, typename T>
+		static void matrix_rotate(const Matrix<3, 3, T>& m, V& x, V& y, V& z)
+		{
+			const V rx = V(m.elements[0][0]) * x + V(m.elements[0][1]) * y + V(m.elements[0][2]) * z;
+			const V ry = V(m.elements[1][0]) * x + V(m.elements[1][1]) * y + V(m.elements[1][2]) * z;
+			z = V(m.elements[2][0]) * x + V(m.elements[2][1]) * y + V(m.elements[2][2]) * z;
+			x = rx;
+			y = ry;
+		}
+
+		// Moves lanes of consecutive Vector<3, T> in and out of one register per component.
+		template<typename V, typename T>
+		static void gather_vectors(const Vector<3, T>* vectors, V& x, V& y, V& z)
+		{
+			if constexpr (std::is_same_v<V, T>)
+			{
+				x = vectors->x;
+				y = vectors->y;
+				z = vectors->z;
+			}
+			else
+			{
+				T xs[V::lanes], ys[V::lanes], zs[V::lanes];
+				for (size_t i = 0; i < V::lanes; ++i)
+				{
+					xs[i] = vectors[i].x;
+					ys[i] = vectors[i].y;
+					zs[i] = vectors[i].z;
+				}
+				x = V::load(xs);
+				y = V::load(ys);
+				z = V::load(zs);
+			}
+		}
+		template<typename V, typename T>
+		static void scatter_vectors(Vector<3, T>* vectors, const V& x, const V& y, const V& z)
+		{
+			if constexpr (std::is_same_v<V, T>)
+			{
+				vectors->x = x;
+				vectors->y = y;
+				vectors->z = z;
+			}
+			else
+			{
+				T xs[V::lanes], ys[V::lanes], zs[V::lanes];
+				x.store(xs);
+				y.store(ys);
+				z.store(zs);
+				for (size_t i = 0; i < V::lanes; ++i)
+				{
+					vectors[i].x = xs[i];
+					vectors[i].y = ys[i];
+					vectors[i].z = zs[i];
+				}
+			}
+		}
+		template<typename V, typename T>
+		static void gather_quaternions(const Quaternion<T>* quaternions, V& x, V& y, V& z, V& w)
+		{
+			if constexpr (std::is_same_v<V, T>)
+			{
+				x = quaternions->x;
+				y = quaternions->y;
+				z = quaternions->z;
+				w = quaternions->w;
+			}
+			else
+			{
+				T xs[V::lanes], ys[V::lanes], zs[V::lanes], ws[V::lanes];
+				for (size_t i = 0; i < V::lanes; ++i)
+				{
+					xs[i] = quaternions[i].x;
+					ys[i] = quaternions[i].y;
+					zs[i] = quaternions[i].z;
+					ws[i] = quaternions[i].w;
+				}
+				x = V::load(xs);
+				y = V::load(ys);
+				z = V::load(zs);
+				w = V::load(ws);
+			}
+		}
+
+		template<typename T, typename K>
+		static void quaternion_span(size_t size, const K& kernel)
+		{
+			using V = widest_pack<T>;
+			size_t i = 0;
+			if constexpr (!std::is_same_v<V, T>)
+				for (; i + V::lanes <= size; i += V::lanes)
+					kernel(V(), i);
+			for (; i < size; ++i)
+				kernel(T(), i);
+		}
+	}
+
+	// Rotation quaternion (x, y, z) + w, with (x, y, z) the vector part. Default constructed it is the identity.
+	// Rotations assume a unit quaternion; compose and interpolate keep it unit up to rounding, normalise restores it.
+	template<typename T>
+	requires std::is_floating_point_v<T>
+	struct Quaternion : public VectorBase<4, T>
+	{
+		constexpr Quaternion() : VectorBase<4, T>((T)0, (T)0, (T)0, (T)1) {}
+		constexpr Quaternion(const T& x, const T& y, const T& z, const T& w) : VectorBase<4, T>(x, y, z, w) {}
+		constexpr Quaternion(const Coordinates<4, T>& coordinates) : VectorBase<4, T>(coordinates) {}
+		constexpr Quaternion(Coordinates<4, T>&& coordinates) : VectorBase<4, T>(std::move(coordinates)) {}
+		template<Angle A>
+		constexpr Quaternion(const Vector<3, T>& axis, const A& angle) : Quaternion(axis_angle<Precision::exact>(axis, angle)) {}
+
+		static constexpr Quaternion identity() { return Quaternion(); }
+
+		template<Precision P, Angle A>
+		static constexpr Quaternion axis_angle(const Vector<3, T>& axis, const A& angle)
+		{
+			const auto [sine, cosine] = sincos<P>(Radians<T>(angle.template radians<T>() / 2));
+			return Quaternion(axis.x * sine, axis.y * sine, axis.z * sine, cosine);
+		}
+
+		constexpr Quaternion conjugate() const { return Quaternion(-this->x, -this->y, -this->z, this->w); }
+		constexpr Quaternion inverse() const { return Quaternion(conjugate() / this->length_sq()); }
+
+		template<Precision P = Precision::exact>
+		constexpr Quaternion normalised() const { return Quaternion(VectorBase<4, T>::template normalised<P>()); }
+
+		constexpr Vector<3, T> rotate(const Vector<3, T>& vector) const
+		{
+			Vector<3, T> out = vector;
+			detail::quaternion_rotate(this->x, this->y, this->z, this->w, out.x, out.y, out.z);
+			return out;
+		}
+
+		constexpr Matrix<3, 3, T> matrix() const
+		{
+			const T& x = this->x;
+			const T& y = this->y;
+			const T& z = this->z;
+			const T& w = this->w;
+			return Matrix<3, 3, T>(
+				Coordinates<3, T>(1 - 2 * (y * y + z * z), 2 * (x * y - z * w), 2 * (x * z + y * w)),
+				Coordinates<3, T>(2 * (x * y + z * w), 1 - 2 * (x * x + z * z), 2 * (y * z - x * w)),
+				Coordinates<3, T>(2 * (x * z - y * w), 2 * (y * z + x * w), 1 - 2 * (x * x + y * y))
+			);
+		}
+	};
+
+	template<typename T>
+	static constexpr T dot(const Quaternion<T>& a, const Quaternion<T>& b)
+	{
+		return detail::vector_dot(a, b);
+	}
+
+	template<typename T>
+	static constexpr Quaternion<T> operator* (const Quaternion<T>& a, const Quaternion<T>& b)
+	{
+		return Quaternion<T>(
+			a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+			a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+			a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+		);
+	}
+	template<typename T>
+	static constexpr Quaternion<T>& operator*= (Quaternion<T>& a, const Quaternion<T>& b)
+	{
+		return a = a * b;
+	}
+	template<typename T>
+	static constexpr Vector<3, T> operator* (const Quaternion<T>& q, const Vector<3, T>& vector)
+	{
+		return q.rotate(vector);
+	}
+
+	template<Precision P = Precision::exact, typename T>
+	static constexpr Quaternion<T> nlerp(const Quaternion<T>& a, const Quaternion<T>& b, const std::type_identity_t<T>& t)
+	{
+		const T sign = dot(a, b) < 0 ? (T)-1 : (T)1;
+		return Quaternion<T>(a * (1 - t) + b * (sign * t)).template normalised<P>();
+	}
+	template<Precision P = Precision::exact, typename T>
+	static constexpr Quaternion<T> slerp(const Quaternion<T>& a, const Quaternion<T>& b, const std::type_identity_t<T>& t)
+	{
+		T cosine = dot(a, b);
+		T sign = 1;
+		if (cosine < 0)
+		{
+			cosine = -cosine;
+			sign = -1;
+		}
+		if (cosine > (T)0.9995)
+			return nlerp<P>(a, b, t);
+
+		const Radians<T> theta = arccos(cosine);
+		const T inverse_sine = 1 / sin<P>(theta);
+		const T weight_a = sin<P>(Radians<T>((1 - t) * theta.native())) * inverse_sine;
+		const T weight_b = sin<P>(Radians<T>(t * theta.native())) * inverse_sine * sign;
+		return Quaternion<T>(a * weight_a + b * weight_b);
+	}
+
+	template<typename T>
+	static void rotate(const Quaternion<T>& q, std::span<const std::type_identity_t<Vector<3, T>>> in, std::span<Vector<3, T>> out)
+	{
+		assert(in.size() == out.size());
+		const Matrix<3, 3, T> m = q.matrix();
+		detail::quaternion_span<T>(out.size(), [&]<typename V>(V, size_t i)
+		{
+			V x, y, z;
+			detail::gather_vectors(in.data() + i, x, y, z);
+			detail::matrix_rotate(m, x, y, z);
+			detail::scatter_vectors(out.data() + i, x, y, z);
+		});
+	}
+	template<typename T>
+	static void rotate(std::span<const Quaternion<T>> q, std::span<const std::type_identity_t<Vector<3, T>>> in, std::span<std::type_identity_t<Vector<3, T>>> out)
+	{
+		assert(q.size() == out.size() && in.size() == out.size());
+		detail::quaternion_span<T>(out.size(), [&]<typename V>(V, size_t i)
+		{
+			V qx, qy, qz, qw, x, y, z;
+			detail::gather_quaternions(q.data() + i, qx, qy, qz, qw);
+			detail::gather_vectors(in.data() + i, x, y, z);
+			detail::quaternion_rotate(qx, qy, qz, qw, x, y, z);
+			detail::scatter_vectors(out.data() + i, x, y, z);
+		});
+	}
+	template<typename T>
+	static void rotate(const Quaternion<T>& q, CoordinatesSoA<3, T>& soa)
+	{
+		const Matrix<3, 3, T> m = q.matrix();
+		T* xs = soa.data(0);
+		T* ys = soa.data(1);
+		T* zs = soa.data(2);
+		detail::quaternion_span<T>(soa.size(), [&]<typename V>(V, size_t i)
+		{
+			V x = detail::load<V>(xs + i), y = detail::load<V>(ys + i), z = detail::load<V>(zs + i);
+			detail::matrix_rotate(m, x, y, z);
+			detail::store(xs + i, x);
+			detail::store(ys + i, y);
+			detail::store(zs + i, z);
+		});
+	}
+}
@@ -0,0 +1,210 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include "Point.h"
+#include "Vector.h"
+#include "Pack.h"
+#include "AABB.h"
+
+namespace math
+{
+	namespace detail
+	{
+		template<Tuple P, Tuple V, size_t... C>
+		static constexpr void ray_at(P& out, const P& origin, const V& direction, const typename P::value_type& distance, std::index_sequence<C...>)
+		{
+			((out.template get_component<C>() = fused_multiply_add(direction.template get_component<C>(), distance, origin.template get_component<C>())), ...);
+		}
+		template<Tuple V, size_t... C>
+		static constexpr void ray_inverse(V& out, const V& direction, std::index_sequence<C...>)
+		{
+			((out.template get_component<C>() = typename V::value_type(1) / direction.template get_component<C>()), ...);
+		}
+	}
+
+	// The half line origin + t * direction for t >= 0. The direction need not be normalised; distances along the ray
+	// are then in multiples of its length.
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	struct Ray
+	{
+	public:
+		using point_type = Point<D, T>;
+		using vector_type = Vector<D, T>;
+
+		constexpr Ray() : origin(), direction() {}
+		constexpr Ray(const point_type& origin, const vector_type& direction) : origin(origin), direction(direction) {}
+
+		constexpr point_type at(const T& distance) const
+		{
+			point_type point;
+			detail::ray_at(point, origin, direction, distance, std::make_index_sequence<D>());
+			return point;
+		}
+		constexpr vector_type inverse_direction() const
+		{
+			vector_type inverse;
+			detail::ray_inverse(inverse, direction, std::make_index_sequence<D>());
+			return inverse;
+		}
+
+		point_type origin;
+		vector_type direction;
+	};
+
+	// N rays in SoA layout, traced together through the packet forms of intersect. Lanes that were never set hold
+	// a zero direction, which hits nothing.
+	template<size_t D, typename T, size_t N>
+	requires (std::is_floating_point_v<T> && N >= 1 && N <= 32)
+	struct RayPacket
+	{
+	public:
+		static constexpr size_t size = N;
+
+		constexpr RayPacket() : origin(), direction() {}
+		RayPacket(std::span<const Ray<D, T>> rays) : origin(), direction()
+		{
+			assert(rays.size() <= N);
+			for (size_t lane = 0; lane < rays.size(); ++lane)
+				set(lane, rays[lane]);
+		}
+
+		void set(size_t lane, const Ray<D, T>& ray)
+		{
+			set(lane, ray, std::make_index_sequence<D>());
+		}
+		Ray<D, T> ray(size_t lane) const
+		{
+			Ray<D, T> ray;
+			get(lane, ray, std::make_index_sequence<D>());
+			return ray;
+		}
+
+		alignas(64) T origin[D][N];
+		alignas(64) T direction[D][N];
+
+	private:
+		template<size_t... C>
+		void set(size_t lane, const Ray<D, T>& ray, std::index_sequence<C...>)
+		{
+			((origin[C][lane] = ray.origin.template get_component<C>()), ...);
+			((direction[C][lane] = ray.direction.template get_component<C>()), ...);
+		}
+		template<size_t... C>
+		void get(size_t lane, Ray<D, T>& ray, std::index_sequence<C...>) const
+		{
+			((ray.origin.template get_component<C>() = origin[C][lane]), ...);
+			((ray.direction.template get_component<C>() = direction[C][lane]), ...);
+		}
+	};
+
+	namespace detail
+	{
+		// The widest pack of at most N lanes, for N a power of two; T when there is none.
+		template<typename T, size_t N>
+		struct packet_pack_selector
+		{
+			using type = std::conditional_t<Pack<T, N>::enabled, Pack<T, N>, typename packet_pack_selector<T, N / 2>::type>;
+		};
+		template<typename T>
+		struct packet_pack_selector<T, 1>
+		{
+			using type = T;
+		};
+		template<typename T, size_t N>
+		using packet_pack = typename packet_pack_selector<T, N>::type;
+
+		// The intersection kernels work on rays and shapes held as arrays of components, one V per component,
+		// so the same code traces a single ray (V = T) or a packet (V = Pack<T, N>).
+		template<typename V, Tuple U, size_t... C>
+		static void soa_splat(V (&out)[U::dimensions], const U& tuple, std::index_sequence<C...>)
+		{
+			((out[C] = V(tuple.template get_component<C>())), ...);
+		}
+		template<typename V, Tuple U>
+		static void soa_splat(V (&out)[U::dimensions], const U& tuple)
+		{
+			soa_splat(out, tuple, std::make_index_sequence<U::dimensions>());
+		}
+		template<typename V, size_t D>
+		static V soa_dot(const V (&a)[D], const V (&b)[D])
+		{
+			V dot = a[0] * b[0];
+			for (size_t c = 1; c < D; ++c)
+				dot = dot + a[c] * b[c];
+			return dot;
+		}
+		template<typename V>
+		static void soa_cross(V (&out)[3], const V (&a)[3], const V (&b)[3])
+		{
+			out[0] = a[1] * b[2] - a[2] * b[1];
+			out[1] = a[2] * b[0] - a[0] * b[2];
+			out[2] = a[0] * b[1] - a[1] * b[0];
+		}
+
+		template<size_t D, typename T, typename K>
+		static bool ray_intersect(const Ray<D, T>& ray, T& distance, const K& kernel)
+		{
+			T origin[D], direction[D];
+			soa_splat(origin, ray.origin);
+			soa_splat(direction, ray.direction);
+			return kernel(origin, direction, distance);
+		}
+		// Runs the kernel on the lanes from i on, V at a time, as long as whole Vs fit.
+		template<typename V, size_t D, typename T, size_t N, typename K>
+		static void packet_lanes(const RayPacket<D, T, N>& rays, T (&distance)[N], T (&hits)[N], size_t& i, const K& kernel)
+		{
+			constexpr size_t lanes = pack_traits<V>::lanes;
+			for (; i + lanes <= N; i += lanes)
+			{
+				V origin[D], direction[D];
+				for (size_t c = 0; c < D; ++c)
+				{
+					origin[c] = load<V>(rays.origin[c] + i);
+					direction[c] = load<V>(rays.direction[c] + i);
+				}
+				V nearest = load<V>(distance + i);
+				const auto hit = kernel(origin, direction, nearest);
+				store(distance + i, nearest);
+				store(hits + i, select(hit, V(1), V(0)));
+			}
+		}
+		// Runs the kernel over the packet on the widest packs that fit, then on narrower ones for what is left, so a
+		// packet of 12 floats takes one pack of 8 and one of 4. Gathers the lanes that hit into a bit mask.
+		template<size_t D, typename T, size_t N, typename K>
+		static uint32_t packet_intersect(const RayPacket<D, T, N>& rays, T (&distance)[N], const K& kernel)
+		{
+			alignas(64) T hits[N];
+			size_t i = 0;
+			[&]<size_t... L>(std::index_sequence<L...>)
+			{
+				(packet_lanes<packet_pack<T, L>>(rays, distance, hits, i, kernel), ...);
+			}(std::index_sequence<16, 8, 4, 2, 1>());
+			uint32_t mask = 0;
+			for (size_t lane = 0; lane < N; ++lane)
+				if (hits[lane] != 0)
+					mask |= uint32_t(1) << lane;
+			return mask;
+		}
+	}
+
+	// The intersect functions share one contract: distance holds the farthest distance along the ray to accept, and
+	// on a hit it is narrowed to the distance of the first surface at or in front of the origin, so rays starting inside
+	// a sphere or box hit its far side. Tracing a ray through a list of shapes from distance = infinity leaves the
+	// closest hit. The packet forms do the same per lane and return a bit per lane that hit.
+	template<size_t D, typename T>
+	static bool intersect(const Ray<D, T>& ray, const AABB<D, T>& box, T& distance)
+	{
+		T near = -std::numeric_limits<T>::infinity();
+		T far = std::numeric_limits<T>::infinity();
+		if (!box.intersects(ray.origin, ray.inverse_direction(), near, far))
+			return false;
+		const T t = near < T(0) ? far : near;
+		if (t < T(0) || !(t < distance))
+			return false;
+		distance = t;
+		return true;
+	}
+}
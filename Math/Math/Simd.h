@@ -0,0 +1,248 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include "Tuple.h"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define MATH_ISA_NEON
+	#define MATH_ISA_FMA
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <immintrin.h>
+	#define MATH_ISA_SSE2
+	#if defined(__SSE4_1__) || defined(__AVX__)
+		#define MATH_ISA_SSE41
+	#endif
+	#if defined(__AVX__)
+		#define MATH_ISA_AVX
+	#endif
+	#if defined(__AVX2__)
+		#define MATH_ISA_AVX2
+	#endif
+	#if defined(__AVX512F__)
+		#define MATH_ISA_AVX512F
+	#endif
+	// MSVC has no FMA or F16C macro; /arch:AVX2 implies both.
+	#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+		#define MATH_ISA_FMA
+	#endif
+	#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+		#define MATH_ISA_F16C
+	#endif
+#endif
+
+namespace math
+{
+	template<size_t D, typename T>
+	struct Coordinates;
+
+	namespace detail
+	{
+		// One register holding the first D components of a Coordinates<D, T>.
+		// With MATH_SIMD, Coordinates<3, float>, Coordinates<4, float> and (with AVX) Coordinates<4, double>
+		// are over-aligned to the register width; the fourth lane of Coordinates<3, float> is padding,
+		// it is zeroed on load and never written back.
+		template<typename T, size_t D>
+		struct SimdRegister
+		{
+			static constexpr bool enabled = false;
+			static constexpr size_t alignment = alignof(T);
+		};
+
+#if defined(MATH_SIMD) && defined(MATH_ISA_SSE2)
+		template<size_t D>
+		requires (D == 3 || D == 4)
+		struct SimdRegister<float, D>
+		{
+			using type = __m128;
+			static constexpr bool enabled = true;
+			static constexpr size_t alignment = 16;
+			static constexpr int lanes_mask = (1 << D) - 1;
+
+			static type load(const float* pointer)
+			{
+				if constexpr (D == 4)
+					return _mm_load_ps(pointer);
+				else
+					return _mm_and_ps(_mm_load_ps(pointer), _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+			}
+			static void store(float* pointer, const type& value)
+			{
+				if constexpr (D == 4)
+					_mm_store_ps(pointer, value);
+				else
+				{
+					_mm_storel_pi(reinterpret_cast<__m64*>(pointer), value);
+					_mm_store_ss(pointer + 2, _mm_movehl_ps(value, value));
+				}
+			}
+			static type set(float value) { return _mm_set1_ps(value); }
+
+			static type add(const type& a, const type& b) { return _mm_add_ps(a, b); }
+			static type sub(const type& a, const type& b) { return _mm_sub_ps(a, b); }
+			static type mul(const type& a, const type& b) { return _mm_mul_ps(a, b); }
+			static type div(const type& a, const type& b) { return _mm_div_ps(a, b); }
+			static type sqrt(const type& a) { return _mm_sqrt_ps(a); }
+			static type fma(const type& a, const type& b, const type& c)
+			{
+#if defined(MATH_ISA_FMA)
+				return _mm_fmadd_ps(a, b, c);
+#else
+				return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+			}
+
+			static bool equals(const type& a, const type& b) { return (_mm_movemask_ps(_mm_cmpeq_ps(a, b)) & lanes_mask) == lanes_mask; }
+
+			static type dot_splat(const type& a, const type& b)
+			{
+#if defined(MATH_ISA_SSE41)
+				return _mm_dp_ps(a, b, 0xFF);
+#else
+				type product = _mm_mul_ps(a, b);
+				product = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+				return _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 0, 3, 2)));
+#endif
+			}
+			static float dot(const type& a, const type& b) { return _mm_cvtss_f32(dot_splat(a, b)); }
+			// Over x, y and z; w comes out zero.
+			static type cross(const type& a, const type& b)
+			{
+				const type a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+				const type b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+				const type c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+				return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+			}
+		};
+#endif
+
+#if defined(MATH_SIMD) && defined(MATH_ISA_AVX)
+		template<>
+		struct SimdRegister<double, 4>
+		{
+			using type = __m256d;
+			static constexpr bool enabled = true;
+			static constexpr size_t alignment = 32;
+
+			static type load(const double* pointer) { return _mm256_load_pd(pointer); }
+			static void store(double* pointer, const type& value) { _mm256_store_pd(pointer, value); }
+			static type set(double value) { return _mm256_set1_pd(value); }
+
+			static type add(const type& a, const type& b) { return _mm256_add_pd(a, b); }
+			static type sub(const type& a, const type& b) { return _mm256_sub_pd(a, b); }
+			static type mul(const type& a, const type& b) { return _mm256_mul_pd(a, b); }
+			static type div(const type& a, const type& b) { return _mm256_div_pd(a, b); }
+			static type sqrt(const type& a) { return _mm256_sqrt_pd(a); }
+			static type fma(const type& a, const type& b, const type& c)
+			{
+#if defined(MATH_ISA_FMA)
+				return _mm256_fmadd_pd(a, b, c);
+#else
+				return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+			}
+
+			static bool equals(const type& a, const type& b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)) == 0xF; }
+
+			static type dot_splat(const type& a, const type& b)
+			{
+				const type pairs = _mm256_hadd_pd(_mm256_mul_pd(a, b), _mm256_mul_pd(a, b));
+				return _mm256_add_pd(pairs, _mm256_permute2f128_pd(pairs, pairs, 1));
+			}
+			static double dot(const type& a, const type& b) { return _mm256_cvtsd_f64(dot_splat(a, b)); }
+#if defined(MATH_ISA_AVX2)
+			static type cross(const type& a, const type& b)
+			{
+				const type a_yzx = _mm256_permute4x64_pd(a, _MM_SHUFFLE(3, 0, 2, 1));
+				const type b_yzx = _mm256_permute4x64_pd(b, _MM_SHUFFLE(3, 0, 2, 1));
+				const type c = _mm256_sub_pd(_mm256_mul_pd(a, b_yzx), _mm256_mul_pd(a_yzx, b));
+				return _mm256_permute4x64_pd(c, _MM_SHUFFLE(3, 0, 2, 1));
+			}
+#endif
+		};
+#endif
+
+#if defined(MATH_SIMD) && defined(MATH_ISA_NEON)
+		template<size_t D>
+		requires (D == 3 || D == 4)
+		struct SimdRegister<float, D>
+		{
+			using type = float32x4_t;
+			static constexpr bool enabled = true;
+			static constexpr size_t alignment = 16;
+
+			static type load(const float* pointer)
+			{
+				if constexpr (D == 4)
+					return vld1q_f32(pointer);
+				else
+					return vsetq_lane_f32(0.0f, vld1q_f32(pointer), 3);
+			}
+			static void store(float* pointer, const type& value)
+			{
+				if constexpr (D == 4)
+					vst1q_f32(pointer, value);
+				else
+				{
+					vst1_f32(pointer, vget_low_f32(value));
+					vst1q_lane_f32(pointer + 2, value, 2);
+				}
+			}
+			static type set(float value) { return vdupq_n_f32(value); }
+
+			static type add(const type& a, const type& b) { return vaddq_f32(a, b); }
+			static type sub(const type& a, const type& b) { return vsubq_f32(a, b); }
+			static type mul(const type& a, const type& b) { return vmulq_f32(a, b); }
+			static type div(const type& a, const type& b) { return vdivq_f32(a, b); }
+			static type sqrt(const type& a) { return vsqrtq_f32(a); }
+			static type fma(const type& a, const type& b, const type& c) { return vfmaq_f32(c, a, b); }
+
+			static bool equals(const type& a, const type& b)
+			{
+				uint32x4_t equal = vceqq_f32(a, b);
+				if constexpr (D == 3)
+					equal = vsetq_lane_u32(0xFFFFFFFFu, equal, 3);
+				return vminvq_u32(equal) != 0;
+			}
+
+			static type dot_splat(const type& a, const type& b) { return vdupq_n_f32(dot(a, b)); }
+			static float dot(const type& a, const type& b) { return vaddvq_f32(vmulq_f32(a, b)); }
+			static type cross(const type& a, const type& b)
+			{
+				const type a_yzx = vcopyq_laneq_f32(vcopyq_laneq_f32(vextq_f32(a, a, 1), 2, a, 0), 3, a, 3);
+				const type b_yzx = vcopyq_laneq_f32(vcopyq_laneq_f32(vextq_f32(b, b, 1), 2, b, 0), 3, b, 3);
+				const type c = vsubq_f32(vmulq_f32(a, b_yzx), vmulq_f32(a_yzx, b));
+				return vcopyq_laneq_f32(vcopyq_laneq_f32(vextq_f32(c, c, 1), 2, c, 0), 3, c, 3);
+			}
+		};
+#endif
+
+		// a * b + c, rounded once where the hardware has a fused instruction. Elsewhere std::fma falls back to
+		// a slow software routine, so the product is rounded separately instead; long double always is.
+		template<typename T>
+		static constexpr T fused_multiply_add(const T& a, const T& b, const T& c)
+		{
+#if defined(MATH_ISA_FMA)
+			if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+				if (!std::is_constant_evaluated())
+					return std::fma(a, b, c);
+#endif
+			return a * b + c;
+		}
+
+		template<typename T>
+		concept simd_tuple = Tuple<T> && SimdRegister<typename T::value_type, T::dimensions>::enabled && std::is_base_of_v<Coordinates<T::dimensions, typename T::value_type>, T>;
+
+		template<simd_tuple T>
+		static auto simd_load(const T& tuple)
+		{
+			return SimdRegister<typename T::value_type, T::dimensions>::load(&tuple.template get_component<0>());
+		}
+		template<simd_tuple T>
+		static void simd_store(T& tuple, const typename SimdRegister<typename T::value_type, T::dimensions>::type& value)
+		{
+			SimdRegister<typename T::value_type, T::dimensions>::store(&tuple.template get_component<0>(), value);
+		}
+	}
+}
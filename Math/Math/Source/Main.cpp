@@ -1,6 +1,8 @@
 #include <iostream>
+#include <string>
 #include "Vector.h"
 #include "Angle.h"
+#include "Text.h"
 
 using namespace math;
 
@@ -10,25 +12,30 @@ static constexpr float foo()
 	Point<2, float> point2(3, 4);
 
 	VectorBase<1, float> vector(3);
+	Vector<2, float> diagonal = Vector<2, float>(45deg, 1.0f).normalised();
 
-	return vector.magnitude_sq();
+	return vector.magnitude_sq() + distance(point1, point2) + diagonal.length() + diagonal.angle<float>().degrees();
 }
 
+static_assert(foo() > 56.99f && foo() < 57.01f);
+
 template<int a>
 struct A
 {
 	static constexpr int value = a;
 };
 
+// Reads a line into x: a number, or an angle with an optional deg, rad or pi suffix.
 template<typename T>
 void prompt(const char* prompt, T& x)
 {
+	using std::from_chars;
+	std::string line;
 	std::cout << prompt;
-	std::cin >> x;
+	std::getline(std::cin, line);
+	from_chars(line.data(), line.data() + line.size(), x);
 }
 
-#define print(x) std::cout << #x << ": " << x << '\n'
-
 int main()
 {
 	Radians<double> radians;
@@ -39,13 +46,13 @@ int main()
 	{
 		Vector<2, float> vector;
 		Degrees<float> angle;
-		float length;
-		prompt("angle:   ", angle.native());
+		float length = 0;
+		prompt("angle:   ", angle);
 		prompt("length:  ", length);
 		vector = Vector<2, float>(angle, length);
-		print(vector.x);
-		print(vector.y);
-		std::cout << '\n';
+		char text[64];
+		*to_chars(text, text + sizeof(text) - 1, vector).ptr = '\0';
+		std::cout << "vector:  " << text << "\n\n";
 	}
 
 	std::cin.ignore();
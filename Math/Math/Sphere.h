@@ -0,0 +1,57 @@
+#pragma once
+#include "Ray.h"
+
+namespace math
+{
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	struct Sphere
+	{
+	public:
+		using point_type = Point<D, T>;
+
+		constexpr Sphere() : center(), radius(1) {}
+		constexpr Sphere(const point_type& center, const T& radius) : center(center), radius(radius) {}
+
+		constexpr bool contains(const point_type& point) const { return !(radius * radius < distance_sq(center, point)); }
+
+		point_type center;
+		T radius;
+	};
+
+	namespace detail
+	{
+		// Solves |origin + t * direction - center|^2 = radius^2 and keeps the nearer root that is not behind the origin,
+		// so rays starting inside hit the far side.
+		template<typename V, size_t D, typename T>
+		static auto sphere_intersect(const V (&origin)[D], const V (&direction)[D], const Sphere<D, T>& sphere, V& distance)
+		{
+			V center[D], offset[D];
+			soa_splat(center, sphere.center);
+			for (size_t c = 0; c < D; ++c)
+				offset[c] = origin[c] - center[c];
+			const V a = soa_dot(direction, direction);
+			const V b = soa_dot(offset, direction);
+			const V c = soa_dot(offset, offset) - V(sphere.radius * sphere.radius);
+			const V discriminant = b * b - a * c;
+			const V root = square_root(select(discriminant < V(0), V(0), discriminant));
+			const V near = (V(0) - b - root) / a;
+			const V far = (root - b) / a;
+			const V t = select(near < V(0), far, near);
+			const auto hit = (discriminant >= V(0)) & (t >= V(0)) & (t < distance);
+			distance = select(hit, t, distance);
+			return hit;
+		}
+	}
+
+	template<size_t D, typename T>
+	static bool intersect(const Ray<D, T>& ray, const Sphere<D, T>& sphere, T& distance)
+	{
+		return detail::ray_intersect(ray, distance, [&]<typename V>(const V (&origin)[D], const V (&direction)[D], V& nearest) { return detail::sphere_intersect(origin, direction, sphere, nearest); });
+	}
+	template<size_t D, typename T, size_t N>
+	static uint32_t intersect(const RayPacket<D, T, N>& rays, const Sphere<D, T>& sphere, T (&distance)[N])
+	{
+		return detail::packet_intersect(rays, distance, [&]<typename V>(const V (&origin)[D], const V (&direction)[D], V& nearest) { return detail::sphere_intersect(origin, direction, sphere, nearest); });
+	}
+}
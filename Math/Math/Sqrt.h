@@ -0,0 +1,226 @@
+#pragma once
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include "Simd.h"
+
+namespace math
+{
+	// Accuracy of sqrt, rsqrt and the lengths built on them, for normal positive finite inputs.
+	// Zero, denormal and infinite inputs always take the exact path.
+	//
+	//            rsqrt float   rsqrt double   sqrt float   sqrt double
+	// exact      1.5 ulp       1.5 ulp        0.5 ulp      0.5 ulp
+	// fast       2.8 ulp       2.2 ulp        2 ulp        3 ulp
+	// fastest    5 ulp         242 ulp        4.1 ulp      247 ulp
+	//
+	// Exact rsqrt rounds twice, in the square root and in the division, so it can miss by more than half an ulp;
+	// its worst float input is 0x1.019566p-126. The float columns are exhaustive, the double ones sampled.
+	// The fast modes refine the hardware reciprocal square root estimate with Newton-Raphson steps:
+	// float takes two (fast) or one (fastest) step, double seeds from the float estimate and takes three or two.
+	// The bounds above are measured on x86; AArch64 takes one extra step to make up for its coarser estimate.
+	// Without a hardware estimate, and during constant evaluation, every mode is exact.
+	enum class Precision
+	{
+		exact,
+		fast,
+		fastest
+	};
+
+	namespace detail
+	{
+		// Newton-Raphson in long double from above, after scaling into [1, 4); used during constant evaluation.
+		template<typename T>
+		static constexpr T constexpr_sqrt(const T& value)
+		{
+			if (value != value || value < 0)
+				return std::numeric_limits<T>::quiet_NaN();
+			if (value == 0 || value == std::numeric_limits<T>::infinity())
+				return value;
+
+			long double x = value;
+			long double scale = 1;
+			for (; x >= 4; x /= 4)
+				scale *= 2;
+			for (; x < 1; x *= 4)
+				scale /= 2;
+
+			long double root = 2;
+			for (long double next = (root + x / root) / 2; next < root; next = (root + x / root) / 2)
+				root = next;
+			return static_cast<T>(root * scale);
+		}
+	}
+
+	template<typename T>
+	requires std::is_arithmetic_v<T>
+	static constexpr T sqrt(const T& value)
+	{
+		if (std::is_constant_evaluated())
+		{
+			if constexpr (std::is_floating_point_v<T>)
+				return detail::constexpr_sqrt(value);
+			else
+				return static_cast<T>(detail::constexpr_sqrt(static_cast<float>(value)));
+		}
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			if constexpr (std::is_same_v<typename std::remove_cvref<T>::type, float>)
+				return ::sqrtf(value);
+			else if constexpr (std::is_same_v<typename std::remove_cvref<T>::type, double>)
+				return ::sqrt(value);
+			else
+				return ::sqrtl(static_cast<long double>(value));
+		}
+		else
+			return static_cast<T>(::sqrtf(static_cast<float>(value)));
+	}
+
+	namespace detail
+	{
+		template<typename T>
+		static constexpr bool rsqrt_estimate_available()
+		{
+#if defined(MATH_ISA_SSE2) || defined(MATH_ISA_NEON)
+			return std::is_same_v<T, float> || std::is_same_v<T, double>;
+#else
+			return false;
+#endif
+		}
+
+		template<Precision P, typename T>
+		static constexpr int rsqrt_newton_steps()
+		{
+#if defined(MATH_ISA_NEON)
+			constexpr int estimate_steps = 1;
+#else
+			constexpr int estimate_steps = 0;
+#endif
+			if constexpr (std::is_same_v<T, float>)
+				return estimate_steps + (P == Precision::fast ? 2 : 1);
+			else
+				return estimate_steps + (P == Precision::fast ? 3 : 2);
+		}
+
+		inline float rsqrt_estimate(float value)
+		{
+#if defined(MATH_ISA_SSE2)
+			return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+#elif defined(MATH_ISA_NEON)
+			return vrsqrtes_f32(value);
+#else
+			return 1.0f / ::sqrtf(value);
+#endif
+		}
+
+		template<typename T>
+		static T rsqrt_newton_step(const T& value, const T& estimate)
+		{
+			return estimate * ((T)1.5 - (T)0.5 * value * estimate * estimate);
+		}
+
+		template<Precision P, typename T>
+		static T rsqrt_approximate(const T& value)
+		{
+			T estimate = static_cast<T>(rsqrt_estimate(static_cast<float>(value)));
+			for (int step = 0; step < rsqrt_newton_steps<P, T>(); ++step)
+				estimate = rsqrt_newton_step(value, estimate);
+			return estimate;
+		}
+
+		template<typename T>
+		static bool rsqrt_in_range(const T& value)
+		{
+			return value >= static_cast<T>(std::numeric_limits<float>::min()) && value <= static_cast<T>(std::numeric_limits<float>::max());
+		}
+
+#if defined(MATH_ISA_SSE2)
+		template<Precision P>
+		static __m128 rsqrt_approximate(const __m128& value)
+		{
+			const __m128 half = _mm_mul_ps(value, _mm_set1_ps(0.5f));
+			__m128 estimate = _mm_rsqrt_ps(value);
+			for (int step = 0; step < rsqrt_newton_steps<P, float>(); ++step)
+				estimate = _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, _mm_mul_ps(estimate, estimate))));
+			return estimate;
+		}
+		inline __m128 rsqrt_in_range(const __m128& value)
+		{
+			return _mm_and_ps(_mm_cmpge_ps(value, _mm_set1_ps(std::numeric_limits<float>::min())), _mm_cmple_ps(value, _mm_set1_ps(std::numeric_limits<float>::max())));
+		}
+#endif
+#if defined(MATH_ISA_AVX)
+		template<Precision P>
+		static __m256 rsqrt_approximate(const __m256& value)
+		{
+			const __m256 half = _mm256_mul_ps(value, _mm256_set1_ps(0.5f));
+			__m256 estimate = _mm256_rsqrt_ps(value);
+			for (int step = 0; step < rsqrt_newton_steps<P, float>(); ++step)
+				estimate = _mm256_mul_ps(estimate, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(half, _mm256_mul_ps(estimate, estimate))));
+			return estimate;
+		}
+		inline __m256 rsqrt_in_range(const __m256& value)
+		{
+			return _mm256_and_ps(_mm256_cmp_ps(value, _mm256_set1_ps(std::numeric_limits<float>::min()), _CMP_GE_OQ), _mm256_cmp_ps(value, _mm256_set1_ps(std::numeric_limits<float>::max()), _CMP_LE_OQ));
+		}
+#endif
+	}
+
+	template<Precision P = Precision::exact, typename T>
+	requires std::is_floating_point_v<T>
+	static constexpr T rsqrt(const T& value)
+	{
+		if constexpr (P != Precision::exact && detail::rsqrt_estimate_available<T>())
+			if (!std::is_constant_evaluated() && detail::rsqrt_in_range(value))
+				return detail::rsqrt_approximate<P>(value);
+		return (T)1 / sqrt(value);
+	}
+
+	template<Precision P, typename T>
+	requires std::is_arithmetic_v<T>
+	static constexpr T sqrt(const T& value)
+	{
+		if constexpr (P != Precision::exact && detail::rsqrt_estimate_available<T>())
+			if (!std::is_constant_evaluated() && detail::rsqrt_in_range(value))
+				return value * detail::rsqrt_approximate<P>(value);
+		return sqrt(value);
+	}
+
+	template<Precision P = Precision::exact, typename T>
+	requires std::is_floating_point_v<T>
+	static void rsqrt(std::span<const std::type_identity_t<T>> values, std::span<T> out)
+	{
+		assert(values.size() == out.size());
+		const size_t size = out.size();
+		size_t i = 0;
+		if constexpr (P != Precision::exact && std::is_same_v<T, float>)
+		{
+#if defined(MATH_ISA_AVX)
+			for (; i + 8 <= size; i += 8)
+			{
+				const __m256 value = _mm256_loadu_ps(values.data() + i);
+				const __m256 in_range = detail::rsqrt_in_range(value);
+				__m256 result = detail::rsqrt_approximate<P>(value);
+				if (_mm256_movemask_ps(in_range) != 0xFF)
+					result = _mm256_blendv_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(value)), result, in_range);
+				_mm256_storeu_ps(out.data() + i, result);
+			}
+#endif
+#if defined(MATH_ISA_SSE2)
+			for (; i + 4 <= size; i += 4)
+			{
+				const __m128 value = _mm_loadu_ps(values.data() + i);
+				const __m128 in_range = detail::rsqrt_in_range(value);
+				__m128 result = detail::rsqrt_approximate<P>(value);
+				if (_mm_movemask_ps(in_range) != 0xF)
+					result = _mm_or_ps(_mm_and_ps(in_range, result), _mm_andnot_ps(in_range, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(value))));
+				_mm_storeu_ps(out.data() + i, result);
+			}
+#endif
+		}
+		for (; i < size; ++i)
+			out[i] = rsqrt<P>(values[i]);
+	}
+}
@@ -0,0 +1,342 @@
+#pragma once
+#include <bit>
+#include <cfloat>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <system_error>
+#include <utility>
+#include "Coordinates.h"
+#include "CoordinatesSoA.h"
+#include "Angle.h"
+#if __has_include(<format>)
+	#include <format>
+#endif
+
+namespace math
+{
+	// Tuples and angles as text, through std::from_chars and std::to_chars: no locale, no allocation, and the
+	// shortest text that reads back to the same value.
+	//
+	// A tuple is its components in order. Between and around them, any run of whitespace, commas, semicolons and
+	// parentheses separates, so "1 2 3", "1,2,3" and "(1, 2, 3)" all read as the same Coordinates<3, T>, and a file
+	// of such lines reads as consecutive tuples whatever its line breaks. An angle is a number with an optional unit
+	// suffix as in the literals, deg, rad or pi; without one it is in the unit of the angle type, and with another
+	// it is converted.
+	//
+	// Both directions follow std::from_chars and std::to_chars: the result holds where parsing or formatting
+	// stopped and std::errc() or the error, and on an error the output is left unspecified.
+	namespace detail
+	{
+		// Number types read and written through the nearest standard type: Half as float, Fixed as double.
+		template<typename T>
+		using text_type = std::conditional_t<std::is_arithmetic_v<T>, T, std::conditional_t<is_floating_point_v<T>, float, double>>;
+
+		static constexpr bool is_text_separator(char c)
+		{
+			return c == ' ' || c == ',' || c == '\n' || c == '\t' || c == '\r' || c == ';' || c == '(' || c == ')' || c == '\v' || c == '\f';
+		}
+		static constexpr const char* skip_text_separators(const char* first, const char* last)
+		{
+			while (first != last && is_text_separator(*first))
+				++first;
+			return first;
+		}
+
+		// Clinger's fast path: a plain decimal of at most 19 digits whose digits and power of ten are exact in double
+		// converts with one correctly rounded division. Floats round that double once more, which can only go wrong when
+		// it lands exactly halfway between two floats, so those, exponents and anything unusual go to std::from_chars,
+		// several times slower for floating point in libstdc++. Either way the value is the one std::from_chars gives.
+		template<typename T>
+		static std::from_chars_result floating_from_chars(const char* first, const char* last, T& value)
+		{
+#if FLT_EVAL_METHOD == 0
+			if constexpr ((std::is_same_v<T, float> || std::is_same_v<T, double>) && std::numeric_limits<double>::is_iec559)
+			{
+				constexpr double powers[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+				const char* p = first;
+				const bool negative = p != last && *p == '-';
+				p += negative;
+				uint64_t mantissa = 0;
+				int digits = 0;
+				int fraction = 0;
+				for (; p != last && static_cast<unsigned>(*p - '0') < 10; ++p, ++digits)
+					mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+				if (p != last && *p == '.')
+					for (++p; p != last && static_cast<unsigned>(*p - '0') < 10; ++p, ++digits, ++fraction)
+						mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+				if (digits > 0 && digits <= 19 && mantissa <= uint64_t(1) << 53 && fraction <= 22 && (p == last || (*p | 0x20) != 'e'))
+				{
+					const double magnitude = static_cast<double>(mantissa) / powers[fraction];
+					if constexpr (std::is_same_v<T, double>)
+					{
+						value = negative ? -magnitude : magnitude;
+						return { p, std::errc() };
+					}
+					else if (magnitude == 0 || (magnitude >= std::numeric_limits<float>::min() && magnitude <= std::numeric_limits<float>::max()
+						&& (std::bit_cast<uint64_t>(magnitude) & 0x1FFFFFFF) != 0x10000000))
+					{
+						value = static_cast<float>(negative ? -magnitude : magnitude);
+						return { p, std::errc() };
+					}
+				}
+			}
+#endif
+			return std::from_chars(first, last, value);
+		}
+
+		template<typename T>
+		static std::from_chars_result component_from_chars(const char* first, const char* last, T& value)
+		{
+			if constexpr (std::is_floating_point_v<T>)
+				return floating_from_chars(first, last, value);
+			else if constexpr (std::is_arithmetic_v<T>)
+				return std::from_chars(first, last, value);
+			else
+			{
+				text_type<T> number;
+				const std::from_chars_result result = component_from_chars(first, last, number);
+				if (result.ec == std::errc())
+					value = T(number);
+				return result;
+			}
+		}
+		template<typename T>
+		static std::to_chars_result component_to_chars(char* first, char* last, const T& value)
+		{
+			if constexpr (std::is_arithmetic_v<T>)
+				return std::to_chars(first, last, value);
+			else
+				return std::to_chars(first, last, static_cast<text_type<T>>(value));
+		}
+
+		template<Tuple U, size_t... C>
+		static std::from_chars_result tuple_from_chars(const char* first, const char* last, U& tuple, std::index_sequence<C...>)
+		{
+			std::from_chars_result result = { first, std::errc() };
+			((result.ec == std::errc() ? (result = component_from_chars(skip_text_separators(result.ptr, last), last, tuple.template get_component<C>()), 0) : 0), ...);
+			return result;
+		}
+		template<Tuple U, size_t... C>
+		static std::to_chars_result tuple_to_chars(char* first, char* last, const U& tuple, char separator, std::index_sequence<C...>)
+		{
+			std::to_chars_result result = { first, std::errc() };
+			const auto component = [&]<size_t I>()
+			{
+				if (result.ec != std::errc())
+					return;
+				if (I > 0)
+				{
+					if (result.ptr == last)
+					{
+						result = { last, std::errc::value_too_large };
+						return;
+					}
+					*result.ptr++ = separator;
+				}
+				result = component_to_chars(result.ptr, last, tuple.template get_component<I>());
+			};
+			(component.template operator()<C>(), ...);
+			return result;
+		}
+
+		enum class AngleUnit
+		{
+			none,
+			degrees,
+			radians,
+			pi_factor,
+		};
+
+		template<Angle A>
+		static constexpr AngleUnit angle_unit()
+		{
+			using T = typename A::angle_type;
+			if constexpr (std::is_same_v<A, Degrees<T>>)
+				return AngleUnit::degrees;
+			else if constexpr (std::is_same_v<A, PiFactor<T>>)
+				return AngleUnit::pi_factor;
+			else
+				return AngleUnit::radians;
+		}
+		template<Angle A>
+		static constexpr const char* angle_suffix()
+		{
+			return angle_unit<A>() == AngleUnit::degrees ? "deg" : angle_unit<A>() == AngleUnit::pi_factor ? "pi" : "rad";
+		}
+
+		static constexpr AngleUnit angle_unit_from_chars(const char*& first, const char* last)
+		{
+			const auto matches = [&](const char* suffix, size_t size)
+			{
+				if (static_cast<size_t>(last - first) < size)
+					return false;
+				for (size_t i = 0; i < size; ++i)
+					if (first[i] != suffix[i])
+						return false;
+				first += size;
+				return true;
+			};
+			if (matches("deg", 3))
+				return AngleUnit::degrees;
+			if (matches("rad", 3))
+				return AngleUnit::radians;
+			if (matches("pi", 2))
+				return AngleUnit::pi_factor;
+			return AngleUnit::none;
+		}
+	}
+
+	template<Tuple U>
+	static std::from_chars_result from_chars(const char* first, const char* last, U& tuple)
+	{
+		return detail::tuple_from_chars(first, last, tuple, std::make_index_sequence<U::dimensions>());
+	}
+	// Writes the components with separator between them and nothing around them.
+	template<Tuple U>
+	static std::to_chars_result to_chars(char* first, char* last, const U& tuple, char separator = ' ')
+	{
+		return detail::tuple_to_chars(first, last, tuple, separator, std::make_index_sequence<U::dimensions>());
+	}
+
+	template<Angle A>
+	static std::from_chars_result from_chars(const char* first, const char* last, A& angle)
+	{
+		using T = typename A::angle_type;
+		using F = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+		first = detail::skip_text_separators(first, last);
+		F value;
+		std::from_chars_result result = detail::floating_from_chars(first, last, value);
+		if (result.ec != std::errc())
+			return result;
+		const char* number_end = result.ptr;
+		const detail::AngleUnit unit = detail::angle_unit_from_chars(result.ptr, last);
+		if (unit == detail::AngleUnit::none || unit == detail::angle_unit<A>())
+		{
+			// In its own unit an integer angle takes integers only, rather than truncating.
+			if constexpr (std::is_integral_v<T>)
+			{
+				T integer;
+				const std::from_chars_result exact = std::from_chars(first, number_end, integer);
+				if (exact.ec != std::errc() || exact.ptr != number_end)
+					return { first, exact.ec != std::errc() ? exact.ec : std::errc::invalid_argument };
+				angle = A(integer);
+			}
+			else
+				angle = A(value);
+		}
+		else if (unit == detail::AngleUnit::degrees)
+			angle = A(Degrees<F>(value));
+		else if (unit == detail::AngleUnit::radians)
+			angle = A(Radians<F>(value));
+		else
+			angle = A(PiFactor<F>(value));
+		return result;
+	}
+	// Writes the angle in its own unit followed by the unit's suffix, e.g. 45deg, 1.5rad or 0.25pi.
+	template<Angle A>
+	static std::to_chars_result to_chars(char* first, char* last, const A& angle)
+	{
+		std::to_chars_result result = std::to_chars(first, last, angle.native());
+		if (result.ec != std::errc())
+			return result;
+		for (const char* suffix = detail::angle_suffix<A>(); *suffix != '\0'; ++suffix)
+		{
+			if (result.ptr == last)
+				return { last, std::errc::value_too_large };
+			*result.ptr++ = *suffix;
+		}
+		return result;
+	}
+
+	// The result of parsing tuples in bulk: where parsing stopped, std::errc() or the error there, and how many
+	// tuples were read before it.
+	struct TuplesFromCharsResult
+	{
+		const char* ptr;
+		std::errc ec;
+		size_t count;
+	};
+
+	// Reads consecutive tuples from [first, last) into out until the text or out runs out. On an error, ptr is where
+	// the failing tuple starts and count the tuples before it.
+	template<Tuple U>
+	static TuplesFromCharsResult tuples_from_chars(const char* first, const char* last, std::span<U> out)
+	{
+		size_t count = 0;
+		for (; count < out.size(); ++count)
+		{
+			first = detail::skip_text_separators(first, last);
+			if (first == last)
+				break;
+			const std::from_chars_result result = from_chars(first, last, out[count]);
+			if (result.ec != std::errc())
+				return { first, result.ec, count };
+			first = result.ptr;
+		}
+		return { first, std::errc(), count };
+	}
+	// Appends the tuples in [first, last) to out until the text runs out.
+	template<size_t D, typename T>
+	static TuplesFromCharsResult tuples_from_chars(const char* first, const char* last, CoordinatesSoA<D, T>& out)
+	{
+		size_t count = 0;
+		Coordinates<D, T> tuple;
+		while (true)
+		{
+			first = detail::skip_text_separators(first, last);
+			if (first == last)
+				break;
+			const std::from_chars_result result = from_chars(first, last, tuple);
+			if (result.ec != std::errc())
+				return { first, result.ec, count };
+			out.push_back(tuple);
+			first = result.ptr;
+			++count;
+		}
+		return { first, std::errc(), count };
+	}
+}
+
+#if defined(__cpp_lib_format)
+// std::format shows a tuple as (x, y, z) and an angle with its unit suffix, e.g. {:.2f} gives (1.00, 2.00, 3.00)
+// and 45.00deg: the format spec applies to each component or to the angle's value.
+template<typename U>
+requires math::Tuple<U>
+struct std::formatter<U, char>
+{
+	std::formatter<math::detail::text_type<typename U::value_type>, char> component;
+
+	constexpr auto parse(std::format_parse_context& context) { return component.parse(context); }
+
+	template<typename Context>
+	auto format(const U& tuple, Context& context) const
+	{
+		auto out = context.out();
+		*out++ = '(';
+		[&]<size_t... C>(std::index_sequence<C...>)
+		{
+			((out = (C == 0 ? out : std::format_to(out, ", ")), context.advance_to(out), out = component.format(static_cast<math::detail::text_type<typename U::value_type>>(tuple.template get_component<C>()), context)), ...);
+		}(std::make_index_sequence<U::dimensions>());
+		*out++ = ')';
+		return out;
+	}
+};
+
+template<typename A>
+requires math::Angle<A>
+struct std::formatter<A, char>
+{
+	std::formatter<typename A::angle_type, char> value;
+
+	constexpr auto parse(std::format_parse_context& context) { return value.parse(context); }
+
+	template<typename Context>
+	auto format(const A& angle, Context& context) const
+	{
+		auto out = value.format(angle.native(), context);
+		return std::format_to(out, "{}", math::detail::angle_suffix<A>());
+	}
+};
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+#include "Ray.h"
+
+namespace math
+{
+	template<typename T>
+	requires std::is_floating_point_v<T>
+	struct Triangle
+	{
+	public:
+		using point_type = Point<3, T>;
+
+		constexpr Triangle() : a(), b(), c() {}
+		constexpr Triangle(const point_type& a, const point_type& b, const point_type& c) : a(a), b(b), c(c) {}
+
+		point_type a;
+		point_type b;
+		point_type c;
+	};
+
+	namespace detail
+	{
+		// Moller-Trumbore, without culling: both faces hit, and rays in the plane of the triangle miss. Edges hit.
+		// Without a branch on the determinant, a zero one turns the barycentrics into infinities or NaNs that fail
+		// their range tests.
+		template<typename V, typename T>
+		static auto triangle_intersect(const V (&origin)[3], const V (&direction)[3], const Triangle<T>& triangle, V& distance)
+		{
+			V a[3], edge1[3], edge2[3];
+			soa_splat(a, triangle.a);
+			soa_splat(edge1, Vector<3, T>(triangle.a, triangle.b));
+			soa_splat(edge2, Vector<3, T>(triangle.a, triangle.c));
+
+			V p[3], s[3], q[3];
+			soa_cross(p, direction, edge2);
+			const V inverse = V(1) / soa_dot(edge1, p);
+			for (size_t c = 0; c < 3; ++c)
+				s[c] = origin[c] - a[c];
+			const V u = soa_dot(s, p) * inverse;
+			soa_cross(q, s, edge1);
+			const V v = soa_dot(direction, q) * inverse;
+			const V t = soa_dot(edge2, q) * inverse;
+
+			const auto hit = (u >= V(0)) & (v >= V(0)) & (u + v <= V(1)) & (t >= V(0)) & (t < distance);
+			distance = select(hit, t, distance);
+			return hit;
+		}
+	}
+
+	template<typename T>
+	static bool intersect(const Ray<3, T>& ray, const Triangle<T>& triangle, T& distance)
+	{
+		return detail::ray_intersect(ray, distance, [&]<typename V>(const V (&origin)[3], const V (&direction)[3], V& nearest) { return detail::triangle_intersect(origin, direction, triangle, nearest); });
+	}
+	template<typename T, size_t N>
+	static uint32_t intersect(const RayPacket<3, T, N>& rays, const Triangle<T>& triangle, T (&distance)[N])
+	{
+		return detail::packet_intersect(rays, distance, [&]<typename V>(const V (&origin)[3], const V (&direction)[3], V& nearest) { return detail::triangle_intersect(origin, direction, triangle, nearest); });
+	}
+}
@@ -1,10 +1,21 @@
 #pragma once
+#include <cstddef>
 #include <type_traits>
 
 namespace math
 {
+	// Component types: the built-in arithmetic types, and number types such as Half and Fixed that specialise these traits.
+	template<typename T>
+	struct is_arithmetic : std::is_arithmetic<T> {};
+	template<typename T>
+	struct is_floating_point : std::is_floating_point<T> {};
+	template<typename T>
+	inline constexpr bool is_arithmetic_v = is_arithmetic<T>::value;
+	template<typename T>
+	inline constexpr bool is_floating_point_v = is_floating_point<T>::value;
+
 	template<size_t D, typename T>
-	requires std::is_arithmetic_v<T>
+	requires is_arithmetic_v<T>
 	struct TupleBase
 	{
 		using value_type = T;
@@ -14,6 +25,27 @@ namespace math
 	template<typename T>
 	concept Tuple = std::is_base_of_v<TupleBase<T::dimensions, typename T::value_type>, T>;
 
+	namespace detail
+	{
+		// Tuples with more components than this hold them in an array, and their operations loop over it instead of
+		// unrolling one step per component.
+		static constexpr size_t unrolled_dimensions = 16;
+
+		template<typename T>
+		concept array_tuple = Tuple<T> && (T::dimensions > unrolled_dimensions) && std::is_same_v<decltype(T::components), typename T::value_type[T::dimensions]>;
+
+		// Tuples are plain components, copied as bytes by std::vector reallocation, std::copy and binary I/O.
+		// Checked for each of the layouts: the named 1 to 4, the unrolled array and the looped array.
+		template<typename T>
+		concept trivial_tuple = std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>;
+		template<template<size_t, typename> typename U, typename T>
+		static consteval bool trivial_tuples()
+		{
+			return trivial_tuple<U<1, T>> && trivial_tuple<U<2, T>> && trivial_tuple<U<3, T>> && trivial_tuple<U<4, T>>
+				&& trivial_tuple<U<unrolled_dimensions, T>> && trivial_tuple<U<unrolled_dimensions + 1, T>>;
+		}
+	}
+
 	template<typename T, size_t D, typename T2>
 	concept SameTuple = Tuple<T> && std::is_same_v<typename T::value_type, T2> && T::dimensions == D;
 }
\ No newline at end of file
@@ -0,0 +1,475 @@
+#pragma once
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <utility>
+#include <vector>
+#include "Coordinates.h"
+#include "CoordinatesSoA.h"
+#include "Half.h"
+#if defined(_WIN32)
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace math
+{
+	// Binary files of tuples, read back by mapping them into memory: the tuples or columns are used in place, so
+	// opening a file of any size costs a page fault per page touched and nothing up front.
+	//
+	// A file is a 64-byte header followed by the components in the byte order of the machine that wrote it: files are
+	// native-endian only and are not converted when read on a machine of the other byte order, which rejects them.
+	// AoS files hold the tuples back to back as packed records of D components, header.stride = D * sizeof(T) bytes
+	// whatever the padding of Coordinates under MATH_SIMD; SoA files hold the D columns one after another, each
+	// starting on a 64-byte boundary. A reader only opens files written for its own D, T, byte order and stride.
+	enum class TupleLayout : uint8_t
+	{
+		aos,
+		soa,
+	};
+
+	enum class ComponentType : uint8_t
+	{
+		int8,
+		uint8,
+		int16,
+		uint16,
+		int32,
+		uint32,
+		int64,
+		uint64,
+		float16,
+		float32,
+		float64,
+	};
+
+	struct TupleFileHeader
+	{
+		static constexpr char signature[4] = { 'M', 'T', 'U', 'P' };
+		static constexpr uint16_t current_version = 2;
+		static constexpr size_t size = 64;
+		static constexpr size_t column_alignment = 64;
+
+		char magic[4];
+		uint16_t version;
+		uint8_t big_endian;
+		TupleLayout layout;
+		ComponentType component;
+		uint8_t component_size;
+		uint16_t dimensions;
+		uint32_t stride;
+		uint64_t count;
+		// Bytes from the start of one SoA column to the next.
+		uint64_t column_stride;
+		uint8_t reserved[32];
+	};
+	static_assert(sizeof(TupleFileHeader) == TupleFileHeader::size && std::is_trivially_copyable_v<TupleFileHeader>);
+
+	namespace detail
+	{
+		template<typename T>
+		concept file_component = std::is_same_v<T, Half> || std::is_same_v<T, float> || std::is_same_v<T, double>
+			|| (std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 8);
+
+		template<file_component T>
+		static consteval ComponentType component_type()
+		{
+			if constexpr (std::is_same_v<T, Half>)
+				return ComponentType::float16;
+			else if constexpr (std::is_same_v<T, float>)
+				return ComponentType::float32;
+			else if constexpr (std::is_same_v<T, double>)
+				return ComponentType::float64;
+			else
+			{
+				constexpr uint8_t size_index = sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3;
+				return static_cast<ComponentType>(2 * size_index + (std::is_unsigned_v<T> ? 1 : 0));
+			}
+		}
+
+		// Bytes of one AoS record: the components without the padding a tuple type may carry.
+		template<size_t D, typename T>
+		static constexpr size_t tuple_file_record = D * sizeof(T);
+
+		// Tuple types whose components are laid out as one AoS record, so records are read and written in place.
+		template<typename U, size_t D, typename T>
+		concept packed_tuple = trivial_tuple<U> && sizeof(U) == tuple_file_record<D, T>;
+
+		template<Tuple U, size_t... C>
+		static void tuple_file_pack(typename U::value_type* out, const U& tuple, std::index_sequence<C...>)
+		{
+			((out[C] = tuple.template get_component<C>()), ...);
+		}
+		template<Tuple U, size_t... C>
+		static void tuple_file_unpack(U& tuple, const std::byte* in, std::index_sequence<C...>)
+		{
+			using T = typename U::value_type;
+			(std::memcpy(&tuple.template get_component<C>(), in + C * sizeof(T), sizeof(T)), ...);
+		}
+
+		template<size_t D, typename T>
+		static constexpr uint64_t tuple_file_column_stride(uint64_t count)
+		{
+			constexpr uint64_t alignment = TupleFileHeader::column_alignment;
+			return (count * sizeof(T) + alignment - 1) / alignment * alignment;
+		}
+
+		template<size_t D, typename T>
+		static constexpr TupleFileHeader tuple_file_header(TupleLayout layout, uint64_t count)
+		{
+			TupleFileHeader header = {};
+			for (size_t i = 0; i < sizeof(header.magic); ++i)
+				header.magic[i] = TupleFileHeader::signature[i];
+			header.version = TupleFileHeader::current_version;
+			header.big_endian = std::endian::native == std::endian::big ? 1 : 0;
+			header.layout = layout;
+			header.component = component_type<T>();
+			header.component_size = sizeof(T);
+			header.dimensions = static_cast<uint16_t>(D);
+			header.stride = layout == TupleLayout::aos ? tuple_file_record<D, T> : sizeof(T);
+			header.count = count;
+			header.column_stride = layout == TupleLayout::soa ? tuple_file_column_stride<D, T>(count) : 0;
+			return header;
+		}
+
+		static bool file_seek(std::FILE* file, uint64_t offset)
+		{
+#if defined(_WIN32)
+			return _fseeki64(file, static_cast<long long>(offset), SEEK_SET) == 0;
+#else
+			return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+		}
+	}
+
+	// A whole file mapped read-only. Closed, with no bytes, when the file cannot be opened or is empty.
+	class MappedFile
+	{
+	public:
+		MappedFile() : pointer(nullptr), length(0) {}
+		explicit MappedFile(const std::filesystem::path& path) : pointer(nullptr), length(0)
+		{
+#if defined(_WIN32)
+			const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				return;
+			LARGE_INTEGER size;
+			if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+			{
+				// The view keeps the mapping and the file open once their handles are closed.
+				const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping != nullptr)
+				{
+					pointer = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+					if (pointer != nullptr)
+						length = static_cast<size_t>(size.QuadPart);
+					CloseHandle(mapping);
+				}
+			}
+			CloseHandle(file);
+#else
+			const int file = ::open(path.c_str(), O_RDONLY);
+			if (file < 0)
+				return;
+			struct stat status;
+			if (fstat(file, &status) == 0 && status.st_size > 0)
+			{
+				// The mapping keeps the file open once the descriptor is closed.
+				void* mapped = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+				if (mapped != MAP_FAILED)
+				{
+					pointer = static_cast<const std::byte*>(mapped);
+					length = static_cast<size_t>(status.st_size);
+				}
+			}
+			::close(file);
+#endif
+		}
+		MappedFile(MappedFile&& rhs) noexcept : pointer(std::exchange(rhs.pointer, nullptr)), length(std::exchange(rhs.length, 0)) {}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator= (MappedFile&& rhs) noexcept
+		{
+			if (this != &rhs)
+			{
+				unmap();
+				pointer = std::exchange(rhs.pointer, nullptr);
+				length = std::exchange(rhs.length, 0);
+			}
+			return *this;
+		}
+		MappedFile& operator= (const MappedFile&) = delete;
+		~MappedFile() { unmap(); }
+
+		bool is_open() const { return pointer != nullptr; }
+		const std::byte* data() const { return pointer; }
+		size_t size() const { return length; }
+		std::span<const std::byte> bytes() const { return { pointer, length }; }
+
+	private:
+		void unmap()
+		{
+			if (pointer == nullptr)
+				return;
+#if defined(_WIN32)
+			UnmapViewOfFile(pointer);
+#else
+			munmap(const_cast<std::byte*>(pointer), length);
+#endif
+			pointer = nullptr;
+			length = 0;
+		}
+
+		const std::byte* pointer;
+		size_t length;
+	};
+
+	// A tuple file mapped into memory, its tuples or columns used in place. Closed when the file cannot be mapped or
+	// was not written for D, T and this machine; the spans stay valid while the reader is open.
+	template<size_t D, typename T>
+	requires detail::file_component<T>
+	class TupleFileReader
+	{
+	public:
+		TupleFileReader() : file(), header() {}
+		explicit TupleFileReader(const std::filesystem::path& path) : file(path), header()
+		{
+			if (file.size() >= TupleFileHeader::size)
+				std::memcpy(&header, file.data(), TupleFileHeader::size);
+			if (!valid())
+				file = MappedFile();
+		}
+
+		bool is_open() const { return file.is_open(); }
+		size_t size() const { return is_open() ? static_cast<size_t>(header.count) : 0; }
+		bool empty() const { return size() == 0; }
+		TupleLayout layout() const { return header.layout; }
+		const TupleFileHeader& file_header() const { return header; }
+
+		// AoS files: the tuples in place, as any tuple type without padding, such as Point<3, float> without MATH_SIMD.
+		template<SameTuple<D, T> U = Coordinates<D, T>>
+		requires detail::packed_tuple<U, D, T>
+		std::span<const U> tuples() const
+		{
+			assert(!is_open() || layout() == TupleLayout::aos);
+			if (!is_open())
+				return {};
+			return { reinterpret_cast<const U*>(file.data() + TupleFileHeader::size), size() };
+		}
+		// AoS files: one tuple, copied out as any tuple type, padded or not.
+		template<SameTuple<D, T> U = Coordinates<D, T>>
+		U tuple(size_t index) const
+		{
+			assert(layout() == TupleLayout::aos && index < size());
+			U out;
+			detail::tuple_file_unpack(out, file.data() + TupleFileHeader::size + index * header.stride, std::make_index_sequence<D>());
+			return out;
+		}
+
+		// SoA files: one component of every tuple.
+		const T* data(size_t component) const
+		{
+			assert(component < D && (!is_open() || layout() == TupleLayout::soa));
+			if (!is_open())
+				return nullptr;
+			return reinterpret_cast<const T*>(file.data() + TupleFileHeader::size + component * header.column_stride);
+		}
+		template<size_t C>
+		std::span<const T> component() const { static_assert(C < D, "component index out of range"); return { data(C), size() }; }
+
+	private:
+		bool valid() const
+		{
+			const TupleFileHeader expected = detail::tuple_file_header<D, T>(header.layout, header.count);
+			if (!file.is_open() || file.size() < TupleFileHeader::size || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0
+				|| header.version != expected.version || header.big_endian != expected.big_endian || header.component != expected.component
+				|| header.component_size != expected.component_size || header.dimensions != expected.dimensions)
+				return false;
+			const uint64_t available = file.size() - TupleFileHeader::size;
+			if (header.layout == TupleLayout::aos)
+				return header.stride == expected.stride && header.count <= available / header.stride;
+			if (header.layout == TupleLayout::soa)
+				return header.column_stride == expected.column_stride && (header.count == 0 || (D - 1) * header.column_stride + header.count * sizeof(T) <= available);
+			return false;
+		}
+
+		MappedFile file;
+		TupleFileHeader header;
+	};
+
+	// Writes a tuple file a batch at a time. An AoS file takes any number of tuples and records the count when it is
+	// closed; an SoA file is given its count up front, as each column is written in place, and must receive exactly
+	// that many: a write past the count fails the file and writes nothing. Every write returns false, and so does
+	// close, once anything has failed.
+	template<size_t D, typename T>
+	requires detail::file_component<T>
+	class TupleFileWriter
+	{
+	public:
+		TupleFileWriter(const std::filesystem::path& path, TupleLayout layout = TupleLayout::aos, size_t count = 0)
+			: file(open(path)), header(detail::tuple_file_header<D, T>(layout, layout == TupleLayout::soa ? count : 0)), written(0), failed(file == nullptr)
+		{
+			write_bytes(0, &header, sizeof(header));
+		}
+		TupleFileWriter(const TupleFileWriter&) = delete;
+		TupleFileWriter& operator= (const TupleFileWriter&) = delete;
+		~TupleFileWriter() { close(); }
+
+		bool is_open() const { return file != nullptr; }
+		size_t size() const { return written; }
+
+		template<SameTuple<D, T> U>
+		bool write(std::span<const U> tuples)
+		{
+			if (header.layout == TupleLayout::soa)
+			{
+				// More tuples than the count would run into the next column: fail the file and write nothing.
+				if (written + tuples.size() > header.count)
+					failed = true;
+				if (failed)
+					return false;
+				[&]<size_t... C>(std::index_sequence<C...>) { (write_column<C>(tuples), ...); }(std::make_index_sequence<D>());
+			}
+			else if constexpr (detail::packed_tuple<U, D, T>)
+				write_bytes(TupleFileHeader::size + written * header.stride, tuples.data(), tuples.size_bytes());
+			else
+				for (size_t first = 0; first < tuples.size(); first += batch)
+				{
+					const size_t count = tuples.size() - first < batch ? tuples.size() - first : batch;
+					T buffer[batch * D];
+					for (size_t i = 0; i < count; ++i)
+						detail::tuple_file_pack(buffer + i * D, tuples[first + i], std::make_index_sequence<D>());
+					write_bytes(TupleFileHeader::size + (written + first) * header.stride, buffer, count * header.stride);
+				}
+			written += tuples.size();
+			return !failed;
+		}
+		template<SameTuple<D, T> U>
+		bool write(const std::vector<U>& tuples) { return write(std::span<const U>(tuples)); }
+		template<SameTuple<D, T> U>
+		bool write(const U& tuple) { return write(std::span<const U>(&tuple, 1)); }
+		bool write(const CoordinatesSoA<D, T>& tuples)
+		{
+			if (header.layout == TupleLayout::aos)
+				for (size_t first = 0; first < tuples.size(); first += batch)
+				{
+					const size_t count = tuples.size() - first < batch ? tuples.size() - first : batch;
+					T buffer[batch * D];
+					for (size_t i = 0; i < count; ++i)
+						detail::tuple_file_pack(buffer + i * D, tuples[first + i].load(), std::make_index_sequence<D>());
+					write_bytes(TupleFileHeader::size + (written + first) * header.stride, buffer, count * header.stride);
+				}
+			else
+			{
+				if (written + tuples.size() > header.count)
+					failed = true;
+				if (failed)
+					return false;
+				for (size_t c = 0; c < D; ++c)
+					write_bytes(column_offset(c), tuples.data(c), tuples.size() * sizeof(T));
+			}
+			written += tuples.size();
+			return !failed;
+		}
+
+		// Records the count of an AoS file and closes it. False if any write failed or an SoA file is short.
+		bool close()
+		{
+			if (file == nullptr)
+				return !failed;
+			if (header.layout == TupleLayout::aos)
+			{
+				header.count = written;
+				write_bytes(offsetof(TupleFileHeader, count), &header.count, sizeof(header.count));
+			}
+			else if (written != header.count)
+				failed = true;
+			if (std::fclose(file) != 0)
+				failed = true;
+			file = nullptr;
+			return !failed;
+		}
+
+	private:
+		// Tuples packed per fwrite, in a stack buffer of about 16 KB.
+		static constexpr size_t batch = detail::tuple_file_record<D, T> < 16384 ? 16384 / detail::tuple_file_record<D, T> : 1;
+
+		static std::FILE* open(const std::filesystem::path& path)
+		{
+#if defined(_WIN32)
+			return _wfopen(path.c_str(), L"wb");
+#else
+			return std::fopen(path.c_str(), "wb");
+#endif
+		}
+
+		uint64_t column_offset(size_t component) const
+		{
+			return TupleFileHeader::size + component * header.column_stride + written * sizeof(T);
+		}
+
+		template<size_t C, typename U>
+		void write_column(std::span<const U> tuples)
+		{
+			T buffer[batch];
+			for (size_t first = 0; first < tuples.size(); first += batch)
+			{
+				const size_t count = tuples.size() - first < batch ? tuples.size() - first : batch;
+				for (size_t i = 0; i < count; ++i)
+					buffer[i] = tuples[first + i].template get_component<C>();
+				write_bytes(column_offset(C) + first * sizeof(T), buffer, count * sizeof(T));
+			}
+		}
+
+		void write_bytes(uint64_t offset, const void* bytes, size_t size)
+		{
+			if (failed || size == 0)
+				return;
+			if (!detail::file_seek(file, offset) || std::fwrite(bytes, 1, size, file) != size)
+				failed = true;
+		}
+
+		std::FILE* file;
+		TupleFileHeader header;
+		size_t written;
+		bool failed;
+	};
+
+	// Writes tuples to path as one AoS or SoA file.
+	template<Tuple U>
+	requires detail::file_component<typename U::value_type>
+	static bool write_tuple_file(const std::filesystem::path& path, std::span<const U> tuples, TupleLayout layout = TupleLayout::aos)
+	{
+		TupleFileWriter<U::dimensions, typename U::value_type> writer(path, layout, tuples.size());
+		writer.write(tuples);
+		return writer.close();
+	}
+	template<Tuple U>
+	requires detail::file_component<typename U::value_type>
+	static bool write_tuple_file(const std::filesystem::path& path, const std::vector<U>& tuples, TupleLayout layout = TupleLayout::aos)
+	{
+		return write_tuple_file(path, std::span<const U>(tuples), layout);
+	}
+	template<size_t D, typename T>
+	requires detail::file_component<T>
+	static bool write_tuple_file(const std::filesystem::path& path, const CoordinatesSoA<D, T>& tuples, TupleLayout layout = TupleLayout::soa)
+	{
+		TupleFileWriter<D, T> writer(path, layout, tuples.size());
+		writer.write(tuples);
+		return writer.close();
+	}
+}
@@ -1,26 +1,54 @@
 #pragma once
+#include <cassert>
+#include <span>
+#include <utility>
 #include "Tuple.h"
+#include "Simd.h"
+#include "Sqrt.h"
 
 namespace math
 {
 	namespace detail
 	{
-		template<Tuple T, size_t C = 0>
+		// The component kernels are fold expressions over std::index_sequence<C...>: one instantiation per tuple type
+		// instead of one per component, and straight-line code even unoptimised. Array tuples loop instead.
+		template<Tuple T, size_t... C>
+		static constexpr bool tuple_equals(const T& a, const T& b, std::index_sequence<C...>)
+		{
+			return ((a.template get_component<C>() == b.template get_component<C>()) && ...);
+		}
+		template<Tuple T>
 		static constexpr bool tuple_equals(const T& a, const T& b)
 		{
-			bool equals = a.get_component<C>() == b.get_component<C>();
-			if constexpr (C < T::dimensions - 1)
-				equals = equals && tuple_equals<T, C + 1>(a, b);
-			return equals;
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+					return SimdRegister<typename T::value_type, T::dimensions>::equals(simd_load(a), simd_load(b));
+			if constexpr (array_tuple<T>)
+			{
+				for (size_t i = 0; i < T::dimensions; ++i)
+					if (!(a.components[i] == b.components[i]))
+						return false;
+				return true;
+			}
+			else
+				return tuple_equals(a, b, std::make_index_sequence<T::dimensions>());
 		}
 
-		template<Tuple T, size_t C = 0>
+		template<Tuple T, size_t... C>
+		static constexpr bool tuple_not_equals(const T& a, const T& b, std::index_sequence<C...>)
+		{
+			return ((a.template get_component<C>() != b.template get_component<C>()) || ...);
+		}
+		template<Tuple T>
 		static constexpr bool tuple_not_equals(const T& a, const T& b)
 		{
-			bool not_equals = a.get_component<C>() != b.get_component<C>();
-			if constexpr (C < T::dimensions - 1)
-				not_equals = not_equals || tuple_not_equals<T, C + 1>(a, b);
-			return not_equals;
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+					return !SimdRegister<typename T::value_type, T::dimensions>::equals(simd_load(a), simd_load(b));
+			if constexpr (array_tuple<T>)
+				return !tuple_equals(a, b);
+			else
+				return tuple_not_equals(a, b, std::make_index_sequence<T::dimensions>());
 		}
 	}
 
@@ -41,58 +69,106 @@ namespace math
 		struct TupleAddition
 		{
 			using value_type = typename T::value_type;
+			using simd = SimdRegister<value_type, T::dimensions>;
 			static constexpr value_type  operation(const value_type& a, const value_type& b) { return a + b; }
 			static constexpr value_type& operation_self(value_type& a, const value_type& b) { return a += b; }
+			static auto simd_operation(const auto& a, const auto& b) { return simd::add(a, b); }
 		};
 		template<Tuple T>
 		struct TupleSubtraction
 		{
 			using value_type = typename T::value_type;
+			using simd = SimdRegister<value_type, T::dimensions>;
 			static constexpr value_type  operation(const value_type& a, const value_type& b) { return a - b; }
 			static constexpr value_type& operation_self(value_type& a, const value_type& b) { return a -= b; }
+			static auto simd_operation(const auto& a, const auto& b) { return simd::sub(a, b); }
 		};
 		template<Tuple T>
 		struct TupleDivision
 		{
 			using value_type = typename T::value_type;
+			using simd = SimdRegister<value_type, T::dimensions>;
 			static constexpr value_type  operation(const value_type& a, const value_type& b) { return a / b; }
 			static constexpr value_type& operation_self(value_type& a, const value_type& b) { return a /= b; }
+			static auto simd_operation(const auto& a, const auto& b) { return simd::div(a, b); }
 		};
 		template<Tuple T>
 		struct TupleMultiplication
 		{
 			using value_type = typename T::value_type;
+			using simd = SimdRegister<value_type, T::dimensions>;
 			static constexpr value_type  operation(const value_type& a, const value_type& b) { return a * b; }
 			static constexpr value_type& operation_self(value_type& a, const value_type& b) { return a *= b; }
+			static auto simd_operation(const auto& a, const auto& b) { return simd::mul(a, b); }
 		};
 
-		template<typename O, Tuple T, size_t C = 0>
+		template<typename O, Tuple T, size_t... C>
+		static constexpr void tuple_operation(T& out, const T& a, const T& b, std::index_sequence<C...>)
+		{
+			((out.template get_component<C>() = O::operation(a.template get_component<C>(), b.template get_component<C>())), ...);
+		}
+		template<typename O, Tuple T>
 		static constexpr void tuple_operation(T& out, const T& a, const T& b)
 		{
-			out.get_component<C>() = O::operation(a.get_component<C>(), b.get_component<C>());
-			if constexpr (C < T::dimensions - 1)
-				tuple_operation<O, T, C + 1>(out, a, b);
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+					return simd_store(out, O::simd_operation(simd_load(a), simd_load(b)));
+			if constexpr (array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+					out.components[i] = O::operation(a.components[i], b.components[i]);
+			else
+				tuple_operation<O>(out, a, b, std::make_index_sequence<T::dimensions>());
 		}
-		template<typename O, Tuple T, size_t C = 0>
+		template<typename O, Tuple T, size_t... C>
+		static constexpr void tuple_operation_self(T& a, const T& b, std::index_sequence<C...>)
+		{
+			(O::operation_self(a.template get_component<C>(), b.template get_component<C>()), ...);
+		}
+		template<typename O, Tuple T>
 		static constexpr void tuple_operation_self(T& a, const T& b)
 		{
-			O::operation_self(a.get_component<C>(), b.get_component<C>());
-			if constexpr (C < T::dimensions - 1)
-				tuple_operation_self<O, T, C + 1>(a, b);
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+					return simd_store(a, O::simd_operation(simd_load(a), simd_load(b)));
+			if constexpr (array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+					O::operation_self(a.components[i], b.components[i]);
+			else
+				tuple_operation_self<O>(a, b, std::make_index_sequence<T::dimensions>());
+		}
+		template<typename O, Tuple T, size_t... C>
+		static constexpr void tuple_operation_scalar(T& out, const T& tuple, const typename T::value_type& scalar, std::index_sequence<C...>)
+		{
+			((out.template get_component<C>() = O::operation(tuple.template get_component<C>(), scalar)), ...);
 		}
-		template<typename O, Tuple T, size_t C = 0>
+		template<typename O, Tuple T>
 		static constexpr void tuple_operation_scalar(T& out, const T& tuple, const typename T::value_type& scalar)
 		{
-			out.get_component<C>() = O::operation(tuple.get_component<C>(), scalar);
-			if constexpr (C < T::dimensions - 1)
-				tuple_operation_scalar<O, T, C + 1>(out, tuple, scalar);
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+					return simd_store(out, O::simd_operation(simd_load(tuple), O::simd::set(scalar)));
+			if constexpr (array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+					out.components[i] = O::operation(tuple.components[i], scalar);
+			else
+				tuple_operation_scalar<O>(out, tuple, scalar, std::make_index_sequence<T::dimensions>());
 		}
-		template<typename O, Tuple T, size_t C = 0>
+		template<typename O, Tuple T, size_t... C>
+		static constexpr void tuple_operation_scalar_self(T& tuple, const typename T::value_type& scalar, std::index_sequence<C...>)
+		{
+			(O::operation_self(tuple.template get_component<C>(), scalar), ...);
+		}
+		template<typename O, Tuple T>
 		static constexpr void tuple_operation_scalar_self(T& tuple, const typename T::value_type& scalar)
 		{
-			O::operation_self(tuple.get_component<C>(), scalar);
-			if constexpr (C < T::dimensions - 1)
-				tuple_operation_scalar_self<O, T, C + 1>(tuple, scalar);
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+					return simd_store(tuple, O::simd_operation(simd_load(tuple), O::simd::set(scalar)));
+			if constexpr (array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+					O::operation_self(tuple.components[i], scalar);
+			else
+				tuple_operation_scalar_self<O>(tuple, scalar, std::make_index_sequence<T::dimensions>());
 		}
 	}
 
@@ -160,43 +236,199 @@ namespace math
 
 	namespace detail
 	{
-		template<Tuple T1, SameTuple<T1::dimensions, typename T1::value_type> T2, size_t C = 0>
-		static constexpr typename T1::value_type tuple_distance_sq(const T1& a, const T2& b)
+		template<Tuple T, size_t... C>
+		static constexpr void tuple_fma(T& out, const T& a, const T& b, const T& c, std::index_sequence<C...>)
+		{
+			((out.template get_component<C>() = fused_multiply_add(a.template get_component<C>(), b.template get_component<C>(), c.template get_component<C>())), ...);
+		}
+		template<Tuple T>
+		static constexpr void tuple_fma(T& out, const T& a, const T& b, const T& c)
+		{
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+				{
+					using simd = SimdRegister<typename T::value_type, T::dimensions>;
+					return simd_store(out, simd::fma(simd_load(a), simd_load(b), simd_load(c)));
+				}
+			if constexpr (array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+					out.components[i] = fused_multiply_add(a.components[i], b.components[i], c.components[i]);
+			else
+				tuple_fma(out, a, b, c, std::make_index_sequence<T::dimensions>());
+		}
+		template<Tuple T, size_t... C>
+		static constexpr void tuple_fma_scalar(T& out, const T& a, const typename T::value_type& scalar, const T& c, std::index_sequence<C...>)
+		{
+			((out.template get_component<C>() = fused_multiply_add(a.template get_component<C>(), scalar, c.template get_component<C>())), ...);
+		}
+		template<Tuple T>
+		static constexpr void tuple_fma_scalar(T& out, const T& a, const typename T::value_type& scalar, const T& c)
 		{
-			auto distance = b.get_component<C>() - a.get_component<C>();
-			distance = distance * distance;
-			if constexpr (C < T1::dimensions - 1)
-				distance += tuple_distance_sq<T1, T2, C + 1>(a, b);
-			return distance;
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+				{
+					using simd = SimdRegister<typename T::value_type, T::dimensions>;
+					return simd_store(out, simd::fma(simd_load(a), simd::set(scalar), simd_load(c)));
+				}
+			if constexpr (array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+					out.components[i] = fused_multiply_add(a.components[i], scalar, c.components[i]);
+			else
+				tuple_fma_scalar(out, a, scalar, c, std::make_index_sequence<T::dimensions>());
 		}
 	}
 
-	template<Tuple T1, SameTuple<T1::dimensions, typename T1::value_type> T2>
-	static constexpr typename T1::value_type distance_sq(const T1& a, const T2& b)
+	// a * b + c per component, with a single rounding where the hardware has fused multiply-add.
+	template<Tuple T>
+	static constexpr T fma(const T& a, const T& b, const T& c)
 	{
-		return detail::tuple_distance_sq(a, b);
+		T result;
+		detail::tuple_fma(result, a, b, c);
+		return result;
+	}
+	template<Tuple T>
+	static constexpr T fma(const T& a, const typename T::value_type& scalar, const T& c)
+	{
+		T result;
+		detail::tuple_fma_scalar(result, a, scalar, c);
+		return result;
+	}
+	template<Tuple T>
+	static constexpr T axpy(const typename T::value_type& alpha, const T& x, const T& y)
+	{
+		return fma(x, alpha, y);
+	}
+	// Exact at both ends: lerp(a, b, 0) == a and lerp(a, b, 1) == b.
+	template<Tuple T>
+	requires is_floating_point_v<typename T::value_type>
+	static constexpr T lerp(const T& a, const T& b, const typename T::value_type& t)
+	{
+		return fma(b, t, fma(a, -t, a));
+	}
+
+	// The span forms need every span to hold the same number of tuples; out may alias an input.
+	template<Tuple T>
+	static void fma(std::span<const std::type_identity_t<T>> a, std::span<const std::type_identity_t<T>> b, std::span<const std::type_identity_t<T>> c, std::span<T> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size() && c.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			detail::tuple_fma(out[i], a[i], b[i], c[i]);
+	}
+	template<Tuple T>
+	static void fma(std::span<const std::type_identity_t<T>> a, const typename T::value_type& scalar, std::span<const std::type_identity_t<T>> c, std::span<T> out)
+	{
+		assert(a.size() == out.size() && c.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			detail::tuple_fma_scalar(out[i], a[i], scalar, c[i]);
+	}
+	// y += alpha * x, in place.
+	template<Tuple T>
+	static void axpy(const typename T::value_type& alpha, std::span<const std::type_identity_t<T>> x, std::span<T> y)
+	{
+		assert(x.size() == y.size());
+		for (size_t i = 0; i < y.size(); ++i)
+			detail::tuple_fma_scalar(y[i], x[i], alpha, y[i]);
+	}
+	template<Tuple T>
+	requires is_floating_point_v<typename T::value_type>
+	static void lerp(std::span<const std::type_identity_t<T>> a, std::span<const std::type_identity_t<T>> b, const typename T::value_type& t, std::span<T> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+		{
+			T from;
+			detail::tuple_fma_scalar(from, a[i], -t, a[i]);
+			detail::tuple_fma_scalar(out[i], b[i], t, from);
+		}
+	}
+
+	namespace detail
+	{
+		template<Tuple U, Tuple T, size_t... C>
+		static constexpr void tuple_convert(U& out, const T& tuple, std::index_sequence<C...>)
+		{
+			((out.template get_component<C>() = static_cast<typename U::value_type>(tuple.template get_component<C>())), ...);
+		}
+		template<Tuple U, Tuple T>
+		static constexpr void tuple_convert(U& out, const T& tuple)
+		{
+			if constexpr (array_tuple<U> && array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+					out.components[i] = static_cast<typename U::value_type>(tuple.components[i]);
+			else
+				tuple_convert(out, tuple, std::make_index_sequence<T::dimensions>());
+		}
+	}
+
+	// Converts every component to another value type, e.g. tuple_cast<Vector<3, Half>>(normal).
+	template<Tuple U, Tuple T>
+	requires (U::dimensions == T::dimensions)
+	static constexpr U tuple_cast(const T& tuple)
+	{
+		U result;
+		detail::tuple_convert(result, tuple);
+		return result;
+	}
+	template<Tuple T, Tuple U>
+	requires (U::dimensions == T::dimensions)
+	static void tuple_cast(std::span<const T> tuples, std::span<U> out)
+	{
+		assert(tuples.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			detail::tuple_convert(out[i], tuples[i]);
 	}
 
-	template<typename T>
-	requires std::is_arithmetic_v<T>
-	static T sqrt(const T& value)
+	namespace detail
 	{
-		if constexpr (std::is_floating_point_v<T>)
+		template<typename T>
+		static constexpr T square(const T& value)
+		{
+			return value * value;
+		}
+		template<Tuple T1, SameTuple<T1::dimensions, typename T1::value_type> T2, size_t... C>
+		static constexpr typename T1::value_type tuple_distance_sq(const T1& a, const T2& b, std::index_sequence<C...>)
 		{
-			if constexpr (std::is_same_v<typename std::remove_cvref<T>::type, float>)
-				return ::sqrtf(value);
-			else if constexpr (std::is_same_v<typename std::remove_cvref<T>::type, double>)
-				return ::sqrt(value);
+			return (square(b.template get_component<C>() - a.template get_component<C>()) + ...);
+		}
+		template<Tuple T1, SameTuple<T1::dimensions, typename T1::value_type> T2>
+		static constexpr typename T1::value_type tuple_distance_sq(const T1& a, const T2& b)
+		{
+			if constexpr (simd_tuple<T1> && simd_tuple<T2>)
+				if (!std::is_constant_evaluated())
+				{
+					using simd = SimdRegister<typename T1::value_type, T1::dimensions>;
+					const auto distance = simd::sub(simd_load(b), simd_load(a));
+					return simd::dot(distance, distance);
+				}
+			if constexpr (array_tuple<T1> && array_tuple<T2>)
+			{
+				typename T1::value_type distance = 0;
+				for (size_t i = 0; i < T1::dimensions; ++i)
+				{
+					const auto component = b.components[i] - a.components[i];
+					distance = square(component) + distance;
+				}
+				return distance;
+			}
 			else
-				return ::sqrtl(static_cast<long double>(value));
+				return tuple_distance_sq(a, b, std::make_index_sequence<T1::dimensions>());
 		}
-		else
-			return static_cast<T>(::sqrtf(static_cast<float>(value)));
 	}
 
 	template<Tuple T1, SameTuple<T1::dimensions, typename T1::value_type> T2>
-	static typename T1::value_type distance(const T1& a, const T2& b)
+	static constexpr typename T1::value_type distance_sq(const T1& a, const T2& b)
+	{
+		return detail::tuple_distance_sq(a, b);
+	}
+
+	template<Tuple T1, SameTuple<T1::dimensions, typename T1::value_type> T2>
+	static constexpr typename T1::value_type distance(const T1& a, const T2& b)
 	{
 		return sqrt(distance_sq(a, b));
 	}
+	template<Precision P, Tuple T1, SameTuple<T1::dimensions, typename T1::value_type> T2>
+	static constexpr typename T1::value_type distance(const T1& a, const T2& b)
+	{
+		return sqrt<P>(distance_sq(a, b));
+	}
 }
\ No newline at end of file
@@ -1,57 +1,177 @@
 #pragma once
 #include "Point.h"
 #include "Angle.h"
+#include "Accumulation.h"
+#include <span>
 
 namespace math
 {
 	namespace detail
 	{
-		template<typename M, Tuple T, size_t C = 0>
-		static constexpr void vector_magnitude_sq_helper(typename ranked_type<M, typename T::value_type>::higher& magnitude, const T& vector)
+		// a * b + c; Fused rounds once where the hardware has fused multiply-add, so the result depends on the target.
+		template<bool Fused, typename T>
+		static constexpr T multiply_add(const T& a, const T& b, const T& c)
 		{
-			auto component = high_cast<M, typename T::value_type>(vector.get_component<C>());
-			magnitude += component * component;
-			if constexpr (C < T::dimensions - 1)
-				vector_magnitude_sq_helper<M, T, C + 1>(magnitude, vector);
+			if constexpr (Fused)
+				return fused_multiply_add(a, b, c);
+			else
+				return a * b + c;
 		}
 
-		template<typename M, Tuple T, size_t C = 0>
+		template<typename M, bool Fused, Tuple T, size_t... C>
+		static constexpr void vector_magnitude_sq(typename ranked_type<M, typename T::value_type>::higher& magnitude, const T& vector, std::index_sequence<C...>)
+		{
+			using U = typename T::value_type;
+			((magnitude = multiply_add<Fused>(high_cast<M, U>(vector.template get_component<C>()), high_cast<M, U>(vector.template get_component<C>()), magnitude)), ...);
+		}
+		template<typename M, bool Fused = false, Tuple T>
 		static constexpr M vector_magnitude_sq(const T& vector)
 		{
+			if constexpr (simd_tuple<T> && std::is_same_v<M, typename T::value_type>)
+				if (!std::is_constant_evaluated())
+				{
+					const auto components = simd_load(vector);
+					return SimdRegister<M, T::dimensions>::dot(components, components);
+				}
 			typename ranked_type<M, typename T::value_type>::higher magnitude = 0;
-			vector_magnitude_sq_helper<M>(magnitude, vector);
+			if constexpr (array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+				{
+					const auto component = high_cast<M, typename T::value_type>(vector.components[i]);
+					magnitude = multiply_add<Fused>(component, component, magnitude);
+				}
+			else
+				vector_magnitude_sq<M, Fused>(magnitude, vector, std::make_index_sequence<T::dimensions>());
 			return static_cast<M>(magnitude);
 		}
 
-		template<Tuple T, size_t C = 0>
-		static constexpr T vector_normalised(T& out, const T& vector, const typename T::value_type& length)
+		template<Tuple T, size_t... C>
+		static constexpr void vector_normalised(T& out, const T& vector, const typename T::value_type& length, std::index_sequence<C...>)
 		{
-			out.get_component<C>() = vector.get_component<C>() / length;
-			if constexpr (C < T::dimensions - 1)
-				vector_normalised<T, C + 1>(out, vector, length);
+			((out.template get_component<C>() = vector.template get_component<C>() / length), ...);
 		}
-		template<Tuple T, size_t C = 0>
-		static constexpr T vector_normalised_inv(T& out, const T& vector, const typename T::value_type& inv_length)
+		template<Tuple T>
+		static constexpr void vector_normalised(T& out, const T& vector, const typename T::value_type& length)
 		{
-			out.get_component<C>() = vector.get_component<C>() * inv_length;
-			if constexpr (C < T::dimensions - 1)
-				vector_normalised_inv<T, C + 1>(out, vector, inv_length);
+			if constexpr (array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+					out.components[i] = vector.components[i] / length;
+			else
+				vector_normalised(out, vector, length, std::make_index_sequence<T::dimensions>());
+		}
+		template<Tuple T, size_t... C>
+		static constexpr void vector_normalised_inv(T& out, const T& vector, const typename T::value_type& inv_length, std::index_sequence<C...>)
+		{
+			((out.template get_component<C>() = vector.template get_component<C>() * inv_length), ...);
+		}
+		template<Tuple T>
+		static constexpr void vector_normalised_inv(T& out, const T& vector, const typename T::value_type& inv_length)
+		{
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+				{
+					using simd = SimdRegister<typename T::value_type, T::dimensions>;
+					return simd_store(out, simd::mul(simd_load(vector), simd::set(inv_length)));
+				}
+			if constexpr (array_tuple<T>)
+				for (size_t i = 0; i < T::dimensions; ++i)
+					out.components[i] = vector.components[i] * inv_length;
+			else
+				vector_normalised_inv(out, vector, inv_length, std::make_index_sequence<T::dimensions>());
 		}
 
-		template<Tuple T, size_t C = 0>
+		// Accumulates from the last component down, adding each product to the sum of the ones after it.
+		template<bool Fused, Tuple T, size_t... C>
+		static constexpr typename T::value_type vector_dot(const T& a, const T& b, std::index_sequence<C...>)
+		{
+			constexpr size_t last = T::dimensions - 1;
+			typename T::value_type dot = a.template get_component<last>() * b.template get_component<last>();
+			((dot = multiply_add<Fused>(a.template get_component<last - 1 - C>(), b.template get_component<last - 1 - C>(), dot)), ...);
+			return dot;
+		}
+		template<bool Fused = false, Tuple T>
 		static constexpr typename T::value_type vector_dot(const T& a, const T& b)
 		{
-			auto value = a.get_component<C>() * b.get_component<C>();
-			if constexpr (C < T::dimensions - 1)
-				value += vector_dot<T, C + 1>(a, b);
-			return value;
+			if constexpr (simd_tuple<T>)
+				if (!std::is_constant_evaluated())
+					return SimdRegister<typename T::value_type, T::dimensions>::dot(simd_load(a), simd_load(b));
+			if constexpr (array_tuple<T>)
+			{
+				if constexpr (Fused)
+					if (!std::is_constant_evaluated())
+						return naive_sum<true>(a.components, b.components, T::dimensions);
+				typename T::value_type dot = 0;
+				for (size_t i = T::dimensions; i-- > 0;)
+					dot = multiply_add<Fused>(a.components[i], b.components[i], dot);
+				return dot;
+			}
+			else
+				return vector_dot<Fused>(a, b, std::make_index_sequence<T::dimensions - 1>());
+		}
+
+		// The dot product under an accumulation policy, in M. Pairwise sums the halves of the components recursively.
+		template<typename M, Tuple T, size_t First, size_t Last>
+		static constexpr M vector_dot_pairwise(const T& a, const T& b)
+		{
+			if constexpr (Last - First == 1)
+				return static_cast<M>(a.template get_component<First>()) * static_cast<M>(b.template get_component<First>());
+			else
+			{
+				constexpr size_t middle = First + (Last - First) / 2;
+				return vector_dot_pairwise<M, T, First, middle>(a, b) + vector_dot_pairwise<M, T, middle, Last>(a, b);
+			}
+		}
+		template<Accumulation A, typename M, Tuple T, size_t... C>
+		static constexpr void vector_dot_accumulate(Accumulator<A, M>& sum, const T& a, const T& b, std::index_sequence<C...>)
+		{
+			(sum.add_product(static_cast<M>(a.template get_component<C>()), static_cast<M>(b.template get_component<C>())), ...);
+		}
+		template<Accumulation A, typename M, Tuple T>
+		static constexpr M vector_dot_accumulated(const T& a, const T& b)
+		{
+			if constexpr (array_tuple<T>)
+			{
+				Accumulator<A, M> sum;
+				if constexpr (std::is_same_v<M, typename T::value_type>)
+					if (!std::is_constant_evaluated())
+					{
+						sum.add_products(a.components, b.components);
+						return sum.result();
+					}
+				for (size_t i = 0; i < T::dimensions; ++i)
+					sum.add_product(static_cast<M>(a.components[i]), static_cast<M>(b.components[i]));
+				return sum.result();
+			}
+			else if constexpr (Accumulator<A, M>::accumulation == Accumulation::pairwise)
+				return vector_dot_pairwise<M, T, 0, T::dimensions>(a, b);
+			else
+			{
+				Accumulator<A, M> sum;
+				vector_dot_accumulate(sum, a, b, std::make_index_sequence<T::dimensions>());
+				return sum.result();
+			}
 		}
 
-		template<typename A, Tuple T>
-		static Radians<A> vector_angle_helper(const T& a)
+		template<Precision P, typename A, Tuple T>
+		static constexpr Radians<A> vector_angle_helper(const T& a)
 		{
 			static_assert(T::dimensions == 2, "helper only used in 2 dimensions");
-			return arctan<A>(static_cast<A>(a.get_component<0>()), static_cast<A>(a.get_component<1>()) );
+			return arctan<P, A>(static_cast<A>(a.template get_component<0>()), static_cast<A>(a.template get_component<1>()) );
+		}
+
+		template<Tuple T>
+		static constexpr void vector_cross(T& out, const T& a, const T& b)
+		{
+			using simd = SimdRegister<typename T::value_type, T::dimensions>;
+			if constexpr (simd_tuple<T> && requires(const typename simd::type& r) { simd::cross(r, r); })
+				if (!std::is_constant_evaluated())
+					return simd_store(out, simd::cross(simd_load(a), simd_load(b)));
+			const auto x = a.template get_component<1>() * b.template get_component<2>() - a.template get_component<2>() * b.template get_component<1>();
+			const auto y = a.template get_component<2>() * b.template get_component<0>() - a.template get_component<0>() * b.template get_component<2>();
+			const auto z = a.template get_component<0>() * b.template get_component<1>() - a.template get_component<1>() * b.template get_component<0>();
+			out.template get_component<0>() = x;
+			out.template get_component<1>() = y;
+			out.template get_component<2>() = z;
 		}
 
 		template<typename T, typename F, typename... Args>
@@ -81,29 +201,51 @@ namespace math
 
 		template<typename M = T>
 		constexpr M magnitude_sq() const { return detail::vector_magnitude_sq<M>(*this); }
+		// As magnitude_sq, with each square fused into the running sum where the hardware has fused multiply-add.
+		template<typename M = T>
+		constexpr M fused_magnitude_sq() const { return detail::vector_magnitude_sq<M, true>(*this); }
 		template<typename L = T>
 		constexpr L length_sq() const { return magnitude_sq<L>(); }
 
 		template<typename M = T>
-		M magnitude() const { return sqrt(magnitude_sq<M>()); }
+		constexpr M magnitude() const { return sqrt(magnitude_sq<M>()); }
+		template<Precision P, typename M = T>
+		constexpr M magnitude() const { return sqrt<P>(magnitude_sq<M>()); }
 		template<typename L = T>
-		L length() const { return sqrt(length_sq<L>()); }
+		constexpr L length() const { return sqrt(length_sq<L>()); }
+		template<Precision P, typename L = T>
+		constexpr L length() const { return sqrt<P>(length_sq<L>()); }
+
+		template<Accumulation A, typename M = T>
+		constexpr M magnitude_sq() const { return detail::vector_dot_accumulated<A, M>(*this, *this); }
+		template<Accumulation A, typename L = T>
+		constexpr L length_sq() const { return magnitude_sq<A, L>(); }
+		template<Accumulation A, typename M = T>
+		constexpr M magnitude() const { return sqrt(magnitude_sq<A, M>()); }
+		template<Precision P, Accumulation A, typename M = T>
+		constexpr M magnitude() const { return sqrt<P>(magnitude_sq<A, M>()); }
+		template<Accumulation A, typename L = T>
+		constexpr L length() const { return sqrt(length_sq<A, L>()); }
+		template<Precision P, Accumulation A, typename L = T>
+		constexpr L length() const { return sqrt<P>(length_sq<A, L>()); }
 
-		VectorBase normalised() const 
+		template<Precision P = Precision::exact>
+		constexpr VectorBase normalised() const
 		{
 			VectorBase out;
 			if constexpr (std::is_integral_v<T>)
 				detail::vector_normalised(out, *this, length());
 			else
-				detail::vector_normalised_inv(out, *this, (T)1 / length());
+				detail::vector_normalised_inv(out, *this, rsqrt<P>(length_sq()));
 			return out;
 		}
-		void normalise()
+		template<Precision P = Precision::exact>
+		constexpr void normalise()
 		{
 			if constexpr (std::is_integral_v<T>)
 				*this /= length();
 			else
-				*this *= ((T)1 / length());
+				*this *= rsqrt<P>(length_sq());
 		}
 	};
 
@@ -126,8 +268,8 @@ namespace math
 		constexpr Vector(Coordinates<1, T>&& coordinates) : VectorBase<1, T>(std::move(coordinates)) {}
 		constexpr Vector(const Coordinates<1, T>& a, const Coordinates<1, T>& b) : VectorBase<1, T>(b - a) {}
 
-		T magnitude() const { return get_component<0>(); }
-		T length() const { return get_component<0>(); }
+		constexpr T magnitude() const { return this->template get_component<0>(); }
+		constexpr T length() const { return this->template get_component<0>(); }
 	};
 
 	template<typename T>
@@ -140,10 +282,19 @@ namespace math
 		constexpr Vector(Coordinates<2, T>&& coordinates) : VectorBase<2, T>(std::move(coordinates)) {}
 		constexpr Vector(const Coordinates<2, T>& a, const Coordinates<2, T>& b) : VectorBase<2, T>(b - a) {}
 		template<Angle A>
-		Vector(const A& angle, const T& length) : VectorBase<2, T>(static_cast<T>(cos(angle)) * length, static_cast<T>(sin(angle))* length) {}
+		constexpr Vector(const A& angle, const T& length) : Vector(polar<Precision::exact>(angle, length)) {}
+
+		template<Precision P, Angle A>
+		static constexpr Vector polar(const A& angle, const T& length)
+		{
+			const auto [sine, cosine] = sincos<P>(angle);
+			return Vector(static_cast<T>(cosine) * length, static_cast<T>(sine) * length);
+		}
 
 		template<typename A = double>
-		Radians<A> angle() const { return detail::vector_angle_helper<A>(*this); }
+		constexpr Radians<A> angle() const { return detail::vector_angle_helper<Precision::exact, A>(*this); }
+		template<Precision P, typename A = double>
+		constexpr Radians<A> angle() const { return detail::vector_angle_helper<P, A>(*this); }
 	};
 
 	template<typename T>
@@ -168,15 +319,163 @@ namespace math
 		constexpr Vector(const Coordinates<4, T>& a, const Coordinates<4, T>& b) : VectorBase<4, T>(b - a) {}
 	};
 
+	static_assert(detail::trivial_tuples<Vector, float>() && detail::trivial_tuples<Vector, double>() && detail::trivial_tuples<Vector, int>());
+
 	template<size_t D, typename T>
 	static constexpr T dot(const Vector<D, T>& a, const Vector<D, T>& b)
 	{
 		return detail::vector_dot(a, b);
 	}
+	// As dot, with each product fused into the running sum where the hardware has fused multiply-add: one rounding
+	// less per component, but the result then differs between targets. SIMD tuples use the register dot product in both.
+	template<size_t D, typename T>
+	static constexpr T fused_dot(const Vector<D, T>& a, const Vector<D, T>& b)
+	{
+		return detail::vector_dot<true>(a, b);
+	}
+	template<Accumulation A, size_t D, typename T>
+	static constexpr T dot(const Vector<D, T>& a, const Vector<D, T>& b)
+	{
+		return detail::vector_dot_accumulated<A, T>(a, b);
+	}
+	template<typename T>
+	static constexpr Vector<3, T> cross(const Vector<3, T>& a, const Vector<3, T>& b)
+	{
+		Vector<3, T> out;
+		detail::vector_cross(out, a, b);
+		return out;
+	}
+	// dot(a, cross(b, c)): the signed volume of the parallelepiped on a, b and c.
+	template<typename T>
+	static constexpr T triple_product(const Vector<3, T>& a, const Vector<3, T>& b, const Vector<3, T>& c)
+	{
+		return dot(a, cross(b, c));
+	}
+	// The component of a along onto, and the rest of it; onto need not be normalised but must not be zero.
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static constexpr Vector<D, T> project(const Vector<D, T>& a, const Vector<D, T>& onto)
+	{
+		return onto * (dot(a, onto) / dot(onto, onto));
+	}
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static constexpr Vector<D, T> reject(const Vector<D, T>& a, const Vector<D, T>& onto)
+	{
+		return fma(onto, -(dot(a, onto) / dot(onto, onto)), a);
+	}
+	// Mirrors incident in the plane with the given normal, which must be normalised.
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static constexpr Vector<D, T> reflect(const Vector<D, T>& incident, const Vector<D, T>& normal)
+	{
+		return fma(normal, T(-2) * dot(incident, normal), incident);
+	}
+	// Bends the normalised incident through a surface with normalised normal facing it, where eta is the ratio of the
+	// refractive indices on the incident side over the far side. Total internal reflection gives the zero vector.
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static constexpr Vector<D, T> refract(const Vector<D, T>& incident, const Vector<D, T>& normal, const T& eta)
+	{
+		const T cosine = dot(incident, normal);
+		const T k = T(1) - eta * eta * (T(1) - cosine * cosine);
+		if (k < T(0))
+			return Vector<D, T>(T(0));
+		return fma(normal, -(eta * cosine + sqrt(k)), incident * eta);
+	}
+	// Completes the normalised normal to a right-handed orthonormal basis (tangent, bitangent, normal), without
+	// branches and continuous everywhere but where the normal crosses z = 0 (Duff et al., "Building an Orthonormal
+	// Basis, Revisited").
+	template<typename T>
+	requires std::is_floating_point_v<T>
+	static constexpr void orthonormal_basis(const Vector<3, T>& normal, Vector<3, T>& tangent, Vector<3, T>& bitangent)
+	{
+		const T x = normal.template get_component<0>();
+		const T y = normal.template get_component<1>();
+		const T z = normal.template get_component<2>();
+		const T sign = z < T(0) ? T(-1) : T(1);
+		const T a = T(-1) / (sign + z);
+		const T b = x * y * a;
+		tangent = Vector<3, T>(T(1) + sign * x * x * a, sign * b, -sign * x);
+		bitangent = Vector<3, T>(b, sign + y * y * a, -y);
+	}
+
+	// The span forms need every span to hold the same number of vectors; out may alias an input.
+	template<typename T>
+	static void cross(std::span<const std::type_identity_t<Vector<3, T>>> a, std::span<const std::type_identity_t<Vector<3, T>>> b, std::span<Vector<3, T>> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			detail::vector_cross(out[i], a[i], b[i]);
+	}
+	template<typename T>
+	static void triple_product(std::span<const std::type_identity_t<Vector<3, T>>> a, std::span<const std::type_identity_t<Vector<3, T>>> b, std::span<const std::type_identity_t<Vector<3, T>>> c, std::span<T> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size() && c.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			out[i] = triple_product(a[i], b[i], c[i]);
+	}
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static void project(std::span<const std::type_identity_t<Vector<D, T>>> a, std::span<const std::type_identity_t<Vector<D, T>>> onto, std::span<Vector<D, T>> out)
+	{
+		assert(a.size() == out.size() && onto.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			out[i] = project(a[i], onto[i]);
+	}
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static void reject(std::span<const std::type_identity_t<Vector<D, T>>> a, std::span<const std::type_identity_t<Vector<D, T>>> onto, std::span<Vector<D, T>> out)
+	{
+		assert(a.size() == out.size() && onto.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			out[i] = reject(a[i], onto[i]);
+	}
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static void reflect(std::span<const std::type_identity_t<Vector<D, T>>> incident, std::span<const std::type_identity_t<Vector<D, T>>> normal, std::span<Vector<D, T>> out)
+	{
+		assert(incident.size() == out.size() && normal.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			out[i] = reflect(incident[i], normal[i]);
+	}
+	template<size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static void refract(std::span<const std::type_identity_t<Vector<D, T>>> incident, std::span<const std::type_identity_t<Vector<D, T>>> normal, const T& eta, std::span<Vector<D, T>> out)
+	{
+		assert(incident.size() == out.size() && normal.size() == out.size());
+		for (size_t i = 0; i < out.size(); ++i)
+			out[i] = refract(incident[i], normal[i], eta);
+	}
+	template<typename T>
+	requires std::is_floating_point_v<T>
+	static void orthonormal_basis(std::span<const std::type_identity_t<Vector<3, T>>> normals, std::span<Vector<3, T>> tangents, std::span<Vector<3, T>> bitangents)
+	{
+		assert(normals.size() == tangents.size() && normals.size() == bitangents.size());
+		for (size_t i = 0; i < normals.size(); ++i)
+			orthonormal_basis(normals[i], tangents[i], bitangents[i]);
+	}
+
+	template<Precision P = Precision::exact, size_t D, typename T>
+	requires std::is_floating_point_v<T>
+	static void normalise(std::span<Vector<D, T>> vectors)
+	{
+		constexpr size_t chunk = 256;
+		T scales[chunk];
+		for (size_t first = 0; first < vectors.size(); first += chunk)
+		{
+			const size_t count = vectors.size() - first < chunk ? vectors.size() - first : chunk;
+			for (size_t i = 0; i < count; ++i)
+				scales[i] = vectors[first + i].length_sq();
+			rsqrt<P>(std::span<const T>(scales, count), std::span<T>(scales, count));
+			for (size_t i = 0; i < count; ++i)
+				vectors[first + i] *= scales[i];
+		}
+	}
 	template<typename A = double, size_t D, typename T>
-	static Radians<A> angle(const Vector<D, T>& a, const Vector<D, T>& b)
+	static constexpr Radians<A> angle(const Vector<D, T>& a, const Vector<D, T>& b)
 	{
 		using highest = detail::ranked_type<A, T>::higher;
-		return arccos<A>(static_cast<A>(static_cast<highest>(dot(a, b)) / (a.length<highest>() * b.length<highest>()))).angle;
+		return arccos<A>(static_cast<A>(static_cast<highest>(dot(a, b)) / (a.template length<highest>() * b.template length<highest>())));
 	}
 }
\ No newline at end of file
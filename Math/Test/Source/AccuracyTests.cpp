@@ -0,0 +1,257 @@
+#include "Test.h"
+#include "Accumulation.h"
+#include "Angle.h"
+#include "Sqrt.h"
+#include <bit>
+#include <vector>
+
+namespace math
+{
+	namespace test
+	{
+		namespace
+		{
+			// The documented bounds, in ulp; a sweep fails when its worst input exceeds them.
+			struct Bounds
+			{
+				double rsqrt;
+				double sqrt;
+			};
+
+			template<typename T, Precision P>
+			constexpr Bounds sqrt_bounds()
+			{
+				if constexpr (std::is_same_v<T, float>)
+					return P == Precision::exact ? Bounds{ 1.5, 0.5 } : P == Precision::fast ? Bounds{ 2.8, 2 } : Bounds{ 5, 4.1 };
+				else
+					return P == Precision::exact ? Bounds{ 1.5, 0.5 } : P == Precision::fast ? Bounds{ 2.2, 3 } : Bounds{ 242, 247 };
+			}
+
+			// The unit in the last place of a float near the normal double exact, read from its exponent bits.
+			double float_ulp(double exact)
+			{
+				const uint64_t exponent = (std::bit_cast<uint64_t>(exact) >> 52) & 0x7FF;
+				return std::bit_cast<double>((exponent - (std::numeric_limits<float>::digits - 1)) << 52);
+			}
+
+			// Every normal positive float through the scalar and span forms, against the square root in double, which is
+			// exact to well below a float ulp.
+			template<Precision P>
+			void sqrt_float(Context& context)
+			{
+				constexpr Bounds bounds = sqrt_bounds<float, P>();
+				constexpr uint32_t first = 0x00800000u, last = 0x7F800000u, chunk = 1 << 16;
+				std::vector<float> values(chunk), spanned(chunk);
+				double worst_rsqrt = 0, worst_sqrt = 0, worst_span = 0;
+				float worst_rsqrt_input = 0, worst_sqrt_input = 0, worst_span_input = 0;
+				for (uint32_t begin = first; begin < last; begin += chunk)
+				{
+					const uint32_t count = last - begin < chunk ? last - begin : chunk;
+					for (uint32_t i = 0; i < count; ++i)
+						values[i] = std::bit_cast<float>(begin + i);
+					rsqrt<P>(std::span<const float>(values.data(), count), std::span<float>(spanned.data(), count));
+
+					for (uint32_t i = 0; i < count; ++i)
+					{
+						const float value = values[i];
+						const double root = std::sqrt(static_cast<double>(value)), inverse = 1 / root;
+						const double rsqrt_error = std::fabs(rsqrt<P>(value) - inverse) / float_ulp(inverse);
+						const double sqrt_error = std::fabs(sqrt<P>(value) - root) / float_ulp(root);
+						const double span_error = std::fabs(spanned[i] - inverse) / float_ulp(inverse);
+						if (rsqrt_error > worst_rsqrt)
+							worst_rsqrt = rsqrt_error, worst_rsqrt_input = value;
+						if (sqrt_error > worst_sqrt)
+							worst_sqrt = sqrt_error, worst_sqrt_input = value;
+						if (span_error > worst_span)
+							worst_span = span_error, worst_span_input = value;
+					}
+				}
+				if (worst_rsqrt > bounds.rsqrt)
+					context.fail("rsqrt is off by %.3f ulp at %a, above %.1f", worst_rsqrt, worst_rsqrt_input, bounds.rsqrt);
+				if (worst_span > bounds.rsqrt)
+					context.fail("span rsqrt is off by %.3f ulp at %a, above %.1f", worst_span, worst_span_input, bounds.rsqrt);
+				if (worst_sqrt > bounds.sqrt)
+					context.fail("sqrt is off by %.3f ulp at %a, above %.1f", worst_sqrt, worst_sqrt_input, bounds.sqrt);
+			}
+
+			// Random normal positive doubles with uniformly distributed bits, against the square root in long double.
+			template<Precision P>
+			void sqrt_double(Context& context)
+			{
+				if constexpr (std::numeric_limits<long double>::digits <= std::numeric_limits<double>::digits)
+					return;
+				constexpr Bounds bounds = sqrt_bounds<double, P>();
+				Random random(40);
+				double worst_rsqrt = 0, worst_sqrt = 0;
+				double worst_rsqrt_input = 0, worst_sqrt_input = 0;
+				for (size_t sample = 0; sample < 2000000; ++sample)
+				{
+					const double value = std::bit_cast<double>(random.uniform<uint64_t>(0x0010000000000000ull, 0x7FF0000000000000ull));
+					const long double root = std::sqrt(static_cast<long double>(value)), inverse = 1 / root;
+					const double rsqrt_error = ulp_error(rsqrt<P>(value), inverse);
+					const double sqrt_error = ulp_error(sqrt<P>(value), root);
+					if (rsqrt_error > worst_rsqrt)
+						worst_rsqrt = rsqrt_error, worst_rsqrt_input = value;
+					if (sqrt_error > worst_sqrt)
+						worst_sqrt = sqrt_error, worst_sqrt_input = value;
+				}
+				if (worst_rsqrt > bounds.rsqrt)
+					context.fail("rsqrt is off by %.3f ulp at %a, above %.1f", worst_rsqrt, worst_rsqrt_input, bounds.rsqrt);
+				if (worst_sqrt > bounds.sqrt)
+					context.fail("sqrt is off by %.3f ulp at %a, above %.1f", worst_sqrt, worst_sqrt_input, bounds.sqrt);
+			}
+
+			// The fast polynomials against libm one type wider, on random inputs: sin and cos across the reduction range and
+			// a little past it, where libm takes over, and atan2 on arguments of similar and of very different magnitudes.
+			template<typename T>
+			void goniometric(Context& context)
+			{
+				using W = std::conditional_t<std::is_same_v<T, float>, double, long double>;
+				if constexpr (std::numeric_limits<W>::digits <= std::numeric_limits<T>::digits)
+					return;
+				constexpr double sin_bound = std::is_same_v<T, float> ? 2.4 : 2, atan2_bound = std::is_same_v<T, float> ? 3.3 : 2;
+				const T limit = detail::goniometric_coefficients<T>::reduction_limit;
+				Random random(41);
+				double worst_sin = 0, worst_cos = 0, worst_atan2 = 0;
+				T worst_sin_input = 0, worst_cos_input = 0, worst_atan2_x = 0, worst_atan2_y = 0;
+				for (size_t sample = 0; sample < 2000000; ++sample)
+				{
+					const T x = sample % 2 ? random.uniform(T(-10), T(10)) : random.uniform(-limit * T(1.1), limit * T(1.1));
+					const double sin_error = ulp_error(sin<Precision::fast>(Radians<T>(x)), std::sin(static_cast<W>(x)));
+					const double cos_error = ulp_error(cos<Precision::fast>(Radians<T>(x)), std::cos(static_cast<W>(x)));
+					if (sin_error > worst_sin)
+						worst_sin = sin_error, worst_sin_input = x;
+					if (cos_error > worst_cos)
+						worst_cos = cos_error, worst_cos_input = x;
+
+					const int spread = sample % 2 ? 2 : 40;
+					const T a = std::ldexp(random.uniform(T(-1), T(1)), static_cast<int>(random.next() % spread) - spread / 2);
+					const T b = std::ldexp(random.uniform(T(-1), T(1)), static_cast<int>(random.next() % spread) - spread / 2);
+					const double atan2_error = ulp_error(arctan2<Precision::fast>(a, b).native(), std::atan2(static_cast<W>(b), static_cast<W>(a)));
+					if (atan2_error > worst_atan2)
+						worst_atan2 = atan2_error, worst_atan2_x = a, worst_atan2_y = b;
+				}
+				if (worst_sin > sin_bound)
+					context.fail("sin is off by %.3f ulp at %a, above %.1f", worst_sin, static_cast<double>(worst_sin_input), sin_bound);
+				if (worst_cos > sin_bound)
+					context.fail("cos is off by %.3f ulp at %a, above %.1f", worst_cos, static_cast<double>(worst_cos_input), sin_bound);
+				if (worst_atan2 > atan2_bound)
+					context.fail("atan2 is off by %.3f ulp at x = %a, y = %a, above %.1f", worst_atan2, static_cast<double>(worst_atan2_x), static_cast<double>(worst_atan2_y), atan2_bound);
+			}
+
+			// The pack rounding that the range reductions are built on, against nearbyint and floor lane by lane, from
+			// fractions up past the range of int32 and int64, with signed zeros, infinities and NaNs.
+			template<typename T, size_t N>
+			void pack_rounding(Context& context)
+			{
+				if constexpr (Pack<T, N>::enabled)
+				{
+					Random random(42);
+					std::vector<T> values = { T(0), -T(0), T(0.5), T(-0.5), T(1.5), T(2.5), T(-2.5), T(0.49999997), std::numeric_limits<T>::infinity(),
+						-std::numeric_limits<T>::infinity(), std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest() };
+					for (size_t i = 0; i < 4000; ++i)
+						values.push_back(std::ldexp(random.uniform(T(-1), T(1)), static_cast<int>(random.next() % 70) - 4));
+					values.resize((values.size() + N - 1) / N * N, T(0.75));
+
+					bool same = true;
+					for (size_t i = 0; i < values.size(); i += N)
+					{
+						T rounded[N], floored[N];
+						const Pack<T, N> value = Pack<T, N>::load(values.data() + i);
+						detail::round_nearest(value).store(rounded);
+						detail::floor(value).store(floored);
+						for (size_t lane = 0; lane < N; ++lane)
+						{
+							const T expected = std::nearbyint(values[i + lane]), expected_floor = std::floor(values[i + lane]);
+							same = same && std::bit_cast<std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>(rounded[lane]) == std::bit_cast<std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>(expected);
+							same = same && (floored[lane] == expected_floor || (floored[lane] != floored[lane] && expected_floor != expected_floor));
+							if (!same)
+							{
+								context.fail("%a rounds to %a and floors to %a", static_cast<double>(values[i + lane]), static_cast<double>(rounded[lane]), static_cast<double>(floored[lane]));
+								return;
+							}
+						}
+					}
+				}
+			}
+
+			// Span sums of values and of products under each policy, against a compensated sum in long double, at sizes
+			// around every pack width and partial count. The documented bounds are relative to the sum of magnitudes.
+			template<Accumulation A, typename T>
+			void accumulation(Context& context)
+			{
+				constexpr double u = std::numeric_limits<T>::epsilon() / 2;
+				constexpr double wide_u = std::numeric_limits<detail::widened_type<T>>::epsilon() / 2;
+				constexpr size_t lanes = detail::pack_traits<detail::widest_pack<T>>::lanes;
+				Random random(43);
+				for (size_t size : { 0, 1, 3, 7, 8, 9, 15, 17, 31, 33, 63, 255, 257, 1000, 4099, 100003 })
+				{
+					std::vector<T> a(size), b(size);
+					long double sum = 0, sum_compensation = 0, products = 0, products_compensation = 0, magnitudes = 0, product_magnitudes = 0;
+					const auto add = [](long double& total, long double& compensation, long double value)
+					{
+						const long double next = total + value;
+						compensation += std::fabs(value) <= std::fabs(total) ? (total - next) + value : (value - next) + total;
+						total = next;
+					};
+					for (size_t i = 0; i < size; ++i)
+					{
+						// Mixed signs and magnitudes, so the sums cancel.
+						a[i] = std::ldexp(random.uniform(T(-1), T(1)), static_cast<int>(random.next() % 20));
+						b[i] = random.uniform(T(-1), T(1));
+						add(sum, sum_compensation, a[i]);
+						add(products, products_compensation, static_cast<long double>(a[i]) * b[i]);
+						magnitudes += std::fabs(static_cast<long double>(a[i]));
+						product_magnitudes += std::fabs(static_cast<long double>(a[i]) * b[i]);
+					}
+					sum += sum_compensation;
+					products += products_compensation;
+
+					const double n = static_cast<double>(size);
+					const double bound = A == Accumulation::naive ? (n / lanes + 2 * lanes) * u : A == Accumulation::pairwise ? (std::log2(n / detail::pairwise_block + 1) + double(detail::pairwise_block) / lanes + 2 * lanes) * u
+						: A == Accumulation::compensated ? 2 * u : u + n * wide_u;
+					Accumulator<A, T> values, dot;
+					values.add(std::span<const T>(a));
+					dot.add_products(std::span<const T>(a), std::span<const T>(b));
+					const long double value_error = std::fabs(values.result() - sum), product_error = std::fabs(dot.result() - products);
+					if (value_error > bound * magnitudes + std::numeric_limits<T>::denorm_min() || product_error > (bound + 2 * u) * product_magnitudes + std::numeric_limits<T>::denorm_min())
+						context.fail("%zu terms are off by %.3g and %.3g times the magnitudes, above %.3g", size, static_cast<double>(value_error / magnitudes),
+							static_cast<double>(product_error / product_magnitudes), bound);
+
+					// One at a time, in order, the running sum agrees to the same bound.
+					Accumulator<A, T> single;
+					for (size_t i = 0; i < size; ++i)
+						single.add(a[i]);
+					if (std::fabs(single.result() - sum) > (A == Accumulation::compensated || A == Accumulation::widened ? bound : n * u) * magnitudes + std::numeric_limits<T>::denorm_min())
+						context.fail("%zu terms added one at a time are off by %.3g times the magnitudes", size, static_cast<double>(std::fabs(single.result() - sum) / magnitudes));
+				}
+			}
+		}
+
+		void register_accuracy_tests(Registry& registry)
+		{
+			registry.add("sqrt/accuracy/float/exact", &sqrt_float<Precision::exact>);
+			registry.add("sqrt/accuracy/float/fast", &sqrt_float<Precision::fast>);
+			registry.add("sqrt/accuracy/float/fastest", &sqrt_float<Precision::fastest>);
+			registry.add("sqrt/accuracy/double/exact", &sqrt_double<Precision::exact>);
+			registry.add("sqrt/accuracy/double/fast", &sqrt_double<Precision::fast>);
+			registry.add("sqrt/accuracy/double/fastest", &sqrt_double<Precision::fastest>);
+			registry.add("goniometric/accuracy/float", &goniometric<float>);
+			registry.add("goniometric/accuracy/double", &goniometric<double>);
+			registry.add("accumulation/naive/float", &accumulation<Accumulation::naive, float>);
+			registry.add("accumulation/pairwise/float", &accumulation<Accumulation::pairwise, float>);
+			registry.add("accumulation/compensated/float", &accumulation<Accumulation::compensated, float>);
+			registry.add("accumulation/widened/float", &accumulation<Accumulation::widened, float>);
+			registry.add("accumulation/naive/double", &accumulation<Accumulation::naive, double>);
+			registry.add("accumulation/pairwise/double", &accumulation<Accumulation::pairwise, double>);
+			registry.add("accumulation/compensated/double", &accumulation<Accumulation::compensated, double>);
+			registry.add("accumulation/widened/double", &accumulation<Accumulation::widened, double>);
+			registry.add("pack/rounding/float/4", &pack_rounding<float, 4>);
+			registry.add("pack/rounding/float/8", &pack_rounding<float, 8>);
+			registry.add("pack/rounding/float/16", &pack_rounding<float, 16>);
+			registry.add("pack/rounding/double/2", &pack_rounding<double, 2>);
+			registry.add("pack/rounding/double/4", &pack_rounding<double, 4>);
+			registry.add("pack/rounding/double/8", &pack_rounding<double, 8>);
+		}
+	}
+}
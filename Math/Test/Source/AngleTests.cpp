@@ -0,0 +1,131 @@
+#include "Test.h"
+#include "Angle.h"
+#include <vector>
+
+namespace math
+{
+	namespace test
+	{
+		namespace
+		{
+			template<typename T>
+			std::vector<T> random_values(size_t count, uint64_t seed, const T& low, const T& high)
+			{
+				Random random(seed);
+				std::vector<T> values(count);
+				for (T& value : values)
+					value = random.uniform(low, high);
+				return values;
+			}
+
+			// The span kernels run the polynomials on the widest pack and the tail on T; both must agree with the
+			// scalar polynomial to within rounding, since the compiler may contract the scalar code differently.
+			template<typename T>
+			void goniometric_span(Context& context)
+			{
+				const std::vector<T> x = random_values<T>(1027, 12, T(-100), T(100));
+				const std::vector<T> y = random_values<T>(1027, 13, T(-100), T(100));
+				std::vector<T> sines(x.size()), cosines(x.size()), sincos_sines(x.size()), sincos_cosines(x.size()), angles(x.size());
+				sin<Precision::fast>(std::span<const T>(x), std::span<T>(sines));
+				cos<Precision::fast>(std::span<const T>(x), std::span<T>(cosines));
+				sincos<Precision::fast>(std::span<const T>(x), std::span<T>(sincos_sines), std::span<T>(sincos_cosines));
+				arctan2<Precision::fast>(std::span<const T>(x), std::span<const T>(y), std::span<T>(angles));
+
+				const T tolerance = 2 * std::numeric_limits<T>::epsilon();
+				bool same = true;
+				for (size_t i = 0; i < x.size(); ++i)
+				{
+					const Radians<T> angle(x[i]);
+					same = same && near(sines[i], sin<Precision::fast>(angle), tolerance) && near(cosines[i], cos<Precision::fast>(angle), tolerance);
+					same = same && sincos_sines[i] == sines[i] && sincos_cosines[i] == cosines[i];
+					same = same && near(angles[i], arctan2<Precision::fast>(x[i], y[i]).native(), tolerance);
+				}
+				MATH_CHECK(context, same);
+			}
+
+			// Span conversion and wrapping against the one-by-one forms, and the wrapped ranges.
+			template<typename T>
+			void angle_span(Context& context)
+			{
+				const std::vector<T> values = random_values<T>(1031, 14, T(-2000), T(2000));
+				std::vector<Degrees<T>> degrees(values.begin(), values.end());
+				std::vector<Radians<T>> radians(degrees.size());
+				std::vector<Degrees<T>> positive(degrees.size()), signed_(degrees.size()), differences(degrees.size()), lerped(degrees.size());
+				angle_cast(std::span<const Degrees<T>>(degrees), std::span<Radians<T>>(radians));
+				wrap_positive(std::span<const Degrees<T>>(degrees), std::span<Degrees<T>>(positive));
+				wrap_signed(std::span<const Degrees<T>>(degrees), std::span<Degrees<T>>(signed_));
+				difference(std::span<const Degrees<T>>(degrees), std::span<const Degrees<T>>(positive), std::span<Degrees<T>>(differences));
+				lerp(std::span<const Degrees<T>>(degrees), std::span<const Degrees<T>>(signed_), T(0.5), std::span<Degrees<T>>(lerped));
+
+				const T tolerance = 4 * std::numeric_limits<T>::epsilon();
+				bool same = true;
+				for (size_t i = 0; i < degrees.size(); ++i)
+				{
+					same = same && near(radians[i].native(), Radians<T>(degrees[i]).native(), tolerance);
+					same = same && T(0) <= positive[i].native() && positive[i].native() < T(360) && T(-180) < signed_[i].native() && signed_[i].native() <= T(180);
+					same = same && near(positive[i].native(), wrap_positive(degrees[i]).native(), tolerance) && near(signed_[i].native(), wrap_signed(degrees[i]).native(), tolerance);
+					same = same && near(differences[i].native(), difference(degrees[i], positive[i]).native(), T(2000) * tolerance);
+					same = same && near(lerped[i].native(), lerp(degrees[i], signed_[i], T(0.5)).native(), T(2000) * tolerance);
+				}
+				MATH_CHECK(context, same);
+			}
+
+			// Wrapping removes whole turns exactly: against std::fmod by the same turn, from fractions of a turn to the
+			// largest finite values, and the span forms give the same bits as the single ones.
+			template<typename A>
+			void angle_wrap(Context& context)
+			{
+				using T = typename A::angle_type;
+				const T turn = static_cast<T>(2 * detail::half_turn<A>);
+				std::vector<T> values = { T(0), -T(0), turn, -turn, turn / 2, -turn / 2, T(1e8), T(-1e8), T(1.3e10), T(8.9e10), T(-8.9e10),
+					std::nextafter(turn, T(0)), -std::nextafter(turn, T(0)), std::numeric_limits<T>::denorm_min(), -std::numeric_limits<T>::denorm_min(),
+					std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest() };
+				Random random(15);
+				for (size_t i = 0; i < 20000; ++i)
+					values.push_back(std::ldexp(random.uniform(T(-1), T(1)), static_cast<int>(random.next() % (std::numeric_limits<T>::max_exponent + 40)) - 40));
+				for (size_t i = 0; i < 1000; ++i)
+					values.push_back(static_cast<T>(static_cast<int64_t>(random.next() % 2000001) - 1000000) * turn / 2);
+
+				std::vector<A> angles(values.begin(), values.end()), positive(values.size()), signed_(values.size());
+				wrap_positive(std::span<const A>(angles), std::span<A>(positive));
+				wrap_signed(std::span<const A>(angles), std::span<A>(signed_));
+
+				bool same = true;
+				for (size_t i = 0; i < values.size(); ++i)
+				{
+					const T remainder = std::fmod(values[i], turn);
+					T expected_positive = remainder < 0 ? remainder + turn : remainder;
+					expected_positive = expected_positive == turn ? T(0) : expected_positive;
+					const T expected_signed = remainder > turn / 2 ? remainder - turn : remainder <= -turn / 2 ? remainder + turn : remainder;
+					const T single_positive = wrap_positive(angles[i]).native(), single_signed = wrap_signed(angles[i]).native();
+					same = same && T(0) <= single_positive && single_positive < turn && -turn / 2 < single_signed && single_signed <= turn / 2;
+					same = same && single_positive == expected_positive && single_signed == expected_signed;
+					same = same && positive[i].native() == single_positive && std::signbit(positive[i].native()) == std::signbit(single_positive);
+					same = same && signed_[i].native() == single_signed && std::signbit(signed_[i].native()) == std::signbit(single_signed);
+					if (!same)
+					{
+						context.fail("%a wraps to %a and %a, expected %a and %a", static_cast<double>(values[i]), static_cast<double>(single_positive), static_cast<double>(single_signed),
+							static_cast<double>(expected_positive), static_cast<double>(expected_signed));
+						return;
+					}
+				}
+
+				const T nan = std::numeric_limits<T>::quiet_NaN();
+				MATH_CHECK(context, std::isnan(wrap_positive(A(nan)).native()) && std::isnan(wrap_signed(A(std::numeric_limits<T>::infinity())).native()));
+			}
+		}
+
+		void register_angle_tests(Registry& registry)
+		{
+			registry.add("goniometric/span/float", &goniometric_span<float>);
+			registry.add("goniometric/span/double", &goniometric_span<double>);
+			registry.add("angle/span/float", &angle_span<float>);
+			registry.add("angle/span/double", &angle_span<double>);
+			registry.add("angle/wrap/degrees/float", &angle_wrap<Degrees<float>>);
+			registry.add("angle/wrap/degrees/double", &angle_wrap<Degrees<double>>);
+			registry.add("angle/wrap/radians/float", &angle_wrap<Radians<float>>);
+			registry.add("angle/wrap/radians/double", &angle_wrap<Radians<double>>);
+			registry.add("angle/wrap/pi/float", &angle_wrap<PiFactor<float>>);
+		}
+	}
+}
@@ -0,0 +1,14 @@
+#include "Test.h"
+
+using namespace math::test;
+
+int main(int argc, char** argv)
+{
+	Registry registry;
+	register_tuple_tests(registry);
+	register_angle_tests(registry);
+	register_spatial_tests(registry);
+	register_storage_tests(registry);
+	register_accuracy_tests(registry);
+	return registry.run(argc, argv);
+}
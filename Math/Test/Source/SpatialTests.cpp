@@ -0,0 +1,296 @@
+#include "Test.h"
+#include "AABB.h"
+#include "KdTree.h"
+#include "Matrix.h"
+#include "Plane.h"
+#include "Quaternion.h"
+#include "Sphere.h"
+#include "Triangle.h"
+#include <algorithm>
+#include <vector>
+
+namespace math
+{
+	namespace test
+	{
+		namespace
+		{
+			template<size_t D, typename T, template<size_t, typename> typename U>
+			std::vector<U<D, T>> random_tuples(size_t count, uint64_t seed, const T& low, const T& high)
+			{
+				Random random(seed);
+				std::vector<U<D, T>> tuples(count);
+				for (U<D, T>& tuple : tuples)
+					[&]<size_t... C>(std::index_sequence<C...>) { ((tuple.template get_component<C>() = random.uniform(low, high)), ...); }(std::make_index_sequence<D>());
+				return tuples;
+			}
+
+			template<Tuple U>
+			bool tuples_near(const U& a, const U& b, const typename U::value_type& tolerance)
+			{
+				return [&]<size_t... C>(std::index_sequence<C...>) { return (near(a.template get_component<C>(), b.template get_component<C>(), tolerance) && ...); }(std::make_index_sequence<U::dimensions>());
+			}
+
+			// The point moved by amount along every axis; points have no arithmetic with vectors of their own.
+			template<size_t D, typename T>
+			Point<D, T> offset(Point<D, T> point, const T& amount)
+			{
+				[&]<size_t... C>(std::index_sequence<C...>) { ((point.template get_component<C>() += amount), ...); }(std::make_index_sequence<D>());
+				return point;
+			}
+
+			template<size_t N, typename T>
+			Matrix<N, N, T> random_matrix(uint64_t seed)
+			{
+				Random random(seed);
+				Matrix<N, N, T> m;
+				for (size_t i = 0; i < N; ++i)
+					for (size_t j = 0; j < N; ++j)
+						m(i, j) = random.uniform(T(-2), T(2));
+				return m;
+			}
+
+			// The packed and blocked products against the plain triple loop.
+			template<size_t N, typename T>
+			void matrix_multiply(Context& context)
+			{
+				const Matrix<N, N, T> a = random_matrix<N, T>(15), b = random_matrix<N, T>(16);
+				const Matrix<N, N, T> product = a * b;
+				bool same = true;
+				for (size_t i = 0; i < N; ++i)
+					for (size_t j = 0; j < N; ++j)
+					{
+						T expected = 0;
+						for (size_t k = 0; k < N; ++k)
+							expected += a(i, k) * b(k, j);
+						same = same && near(product(i, j), expected, T(4 * N) * std::numeric_limits<T>::epsilon());
+					}
+				MATH_CHECK(context, same);
+			}
+
+			// The span and SoA transforms against one operator* per tuple.
+			template<size_t N, typename T>
+			void matrix_transform(Context& context)
+			{
+				const Matrix<N, N, T> m = random_matrix<N, T>(17);
+				const std::vector<Point<N - 1, T>> points = random_tuples<N - 1, T, Point>(1001, 18, T(-10), T(10));
+				const std::vector<Vector<N - 1, T>> vectors = random_tuples<N - 1, T, Vector>(1001, 19, T(-10), T(10));
+				std::vector<Point<N - 1, T>> transformed_points(points.size());
+				std::vector<Vector<N - 1, T>> transformed_vectors(vectors.size());
+				transform(m, std::span<const Point<N - 1, T>>(points), std::span<Point<N - 1, T>>(transformed_points));
+				transform(m, std::span<const Vector<N - 1, T>>(vectors), std::span<Vector<N - 1, T>>(transformed_vectors));
+				CoordinatesSoA<N - 1, T> soa_points(points.begin(), points.end()), soa_vectors(vectors.begin(), vectors.end());
+				transform_points(m, soa_points);
+				transform_vectors(m, soa_vectors);
+
+				const T tolerance = T(64 * N) * std::numeric_limits<T>::epsilon();
+				bool same = true;
+				for (size_t i = 0; i < points.size(); ++i)
+				{
+					const Point<N - 1, T> point = m * points[i];
+					const Vector<N - 1, T> vector = m * vectors[i];
+					same = same && tuples_near(transformed_points[i], point, tolerance) && tuples_near(Vector<N - 1, T>(soa_points[i].load()), Vector<N - 1, T>(point), tolerance);
+					same = same && tuples_near(transformed_vectors[i], vector, tolerance) && tuples_near(Vector<N - 1, T>(soa_vectors[i].load()), vector, tolerance);
+				}
+				MATH_CHECK(context, same);
+			}
+
+			// The batched rotations against one quaternion product per vector.
+			template<typename T>
+			void quaternion_rotate(Context& context)
+			{
+				const std::vector<Vector<3, T>> vectors = random_tuples<3, T, Vector>(1001, 20, T(-10), T(10));
+				const std::vector<Vector<3, T>> axes = random_tuples<3, T, Vector>(1001, 21, T(-1), T(1));
+				std::vector<Quaternion<T>> rotations(axes.size());
+				for (size_t i = 0; i < axes.size(); ++i)
+					rotations[i] = Quaternion<T>(axes[i].normalised(), Radians<T>(static_cast<T>(i) * T(0.01)));
+				const Quaternion<T> q = rotations[100];
+
+				std::vector<Vector<3, T>> rotated(vectors.size()), each(vectors.size());
+				rotate(q, std::span<const Vector<3, T>>(vectors), std::span<Vector<3, T>>(rotated));
+				rotate(std::span<const Quaternion<T>>(rotations), std::span<const Vector<3, T>>(vectors), std::span<Vector<3, T>>(each));
+				CoordinatesSoA<3, T> soa(vectors.begin(), vectors.end());
+				rotate(q, soa);
+
+				const T tolerance = 64 * std::numeric_limits<T>::epsilon();
+				bool same = true;
+				for (size_t i = 0; i < vectors.size(); ++i)
+				{
+					same = same && tuples_near(rotated[i], q * vectors[i], tolerance) && tuples_near(Vector<3, T>(soa[i].load()), q * vectors[i], tolerance);
+					same = same && tuples_near(each[i], rotations[i] * vectors[i], tolerance);
+					same = same && near(rotated[i].length(), vectors[i].length(), tolerance);
+				}
+				MATH_CHECK(context, same);
+			}
+
+			// Every query against a linear scan of the same points.
+			template<size_t D, typename T>
+			void kd_tree(Context& context)
+			{
+				const std::vector<Point<D, T>> points = random_tuples<D, T, Point>(2000, 22, T(-100), T(100));
+				const std::vector<Point<D, T>> queries = random_tuples<D, T, Point>(100, 23, T(-110), T(110));
+				const KdTree<D, T> tree{ std::span<const Point<D, T>>(points), bulk::Parallel() };
+				MATH_CHECK(context, tree.size() == points.size());
+
+				constexpr size_t k = 5;
+				std::vector<typename KdTree<D, T>::Neighbour> neighbours(queries.size() * k);
+				std::vector<size_t> counts(queries.size());
+				tree.nearest(std::span<const Point<D, T>>(queries), std::span<typename KdTree<D, T>::Neighbour>(neighbours), std::span<size_t>(counts));
+
+				for (size_t q = 0; q < queries.size(); ++q)
+				{
+					std::vector<std::pair<T, size_t>> scan(points.size());
+					for (size_t i = 0; i < points.size(); ++i)
+						scan[i] = { distance_sq(points[i], queries[q]), i };
+					std::sort(scan.begin(), scan.end());
+
+					MATH_CHECK(context, counts[q] == k);
+					for (size_t j = 0; j < k; ++j)
+						MATH_CHECK(context, neighbours[q * k + j].distance_sq == scan[j].first);
+					MATH_CHECK(context, tree.nearest(queries[q]).distance_sq == scan[0].first);
+
+					const T radius = T(30);
+					std::vector<size_t> within, expected;
+					tree.radius(queries[q], radius, within);
+					for (const auto& [distance, index] : scan)
+						if (distance <= radius * radius)
+							expected.push_back(index);
+					std::sort(within.begin(), within.end());
+					std::sort(expected.begin(), expected.end());
+					MATH_CHECK(context, within == expected);
+
+					const Point<D, T> minimum = offset(queries[q], T(-20)), maximum = offset(queries[q], T(20));
+					std::vector<size_t> inside;
+					tree.box(minimum, maximum, inside);
+					expected.clear();
+					for (size_t i = 0; i < points.size(); ++i)
+						if ([&]<size_t... C>(std::index_sequence<C...>) { return ((minimum.template get_component<C>() <= points[i].template get_component<C>() && points[i].template get_component<C>() <= maximum.template get_component<C>()) && ...); }(std::make_index_sequence<D>()))
+							expected.push_back(i);
+					std::sort(inside.begin(), inside.end());
+					MATH_CHECK(context, inside == expected);
+				}
+			}
+
+			// The chunked pack kernels against the single-box tests.
+			template<size_t D, typename T>
+			void aabb_batch(Context& context)
+			{
+				const std::vector<Point<D, T>> corners = random_tuples<D, T, Point>(1003, 24, T(-100), T(100));
+				Random sizes(25);
+				std::vector<AABB<D, T>> boxes(corners.size());
+				for (size_t i = 0; i < boxes.size(); ++i)
+					boxes[i] = AABB<D, T>(corners[i], offset(corners[i], sizes.uniform(T(0), T(20))));
+
+				Random random(26);
+				for (size_t query = 0; query < 20; ++query)
+				{
+					const AABB<D, T> box = boxes[random.uniform<size_t>(0, boxes.size())];
+					std::vector<size_t> overlaps, expected;
+					overlapping(std::span<const AABB<D, T>>(boxes), box, overlaps);
+					for (size_t i = 0; i < boxes.size(); ++i)
+						if (boxes[i].overlaps(box))
+							expected.push_back(i);
+					MATH_CHECK(context, overlaps == expected);
+
+					const Point<D, T> origin = random_tuples<D, T, Point>(1, 27 + query, T(-150), T(150))[0];
+					const Vector<D, T> direction = random_tuples<D, T, Vector>(1, 127 + query, T(-1), T(1))[0];
+					Vector<D, T> inverse;
+					[&]<size_t... C>(std::index_sequence<C...>) { ((inverse.template get_component<C>() = T(1) / direction.template get_component<C>()), ...); }(std::make_index_sequence<D>());
+					std::vector<size_t> hits;
+					intersecting(std::span<const AABB<D, T>>(boxes), origin, inverse, T(0), std::numeric_limits<T>::infinity(), hits);
+					expected.clear();
+					for (size_t i = 0; i < boxes.size(); ++i)
+					{
+						T near = 0, far = std::numeric_limits<T>::infinity();
+						if (boxes[i].intersects(origin, inverse, near, far))
+							expected.push_back(i);
+					}
+					MATH_CHECK(context, hits == expected);
+				}
+			}
+
+			// A ray hits the first face of the box in front of its origin, from outside and from inside, like a sphere.
+			template<typename T>
+			void ray_box(Context& context)
+			{
+				const AABB<3, T> box(Point<3, T>(T(-1), T(-1), T(-1)), Point<3, T>(T(1), T(1), T(1)));
+				const Sphere<3, T> sphere(Point<3, T>(T(0), T(0), T(0)), T(1));
+				const Vector<3, T> x(T(1), T(0), T(0));
+				for (const T start : { T(-3), T(-1), T(0), T(0.5) })
+				{
+					const Ray<3, T> ray(Point<3, T>(start, T(0), T(0)), x);
+					T box_distance = std::numeric_limits<T>::infinity(), sphere_distance = std::numeric_limits<T>::infinity();
+					MATH_CHECK(context, intersect(ray, box, box_distance) && intersect(ray, sphere, sphere_distance));
+					MATH_CHECK(context, box_distance == sphere_distance && box_distance == (start < T(-1) ? T(-1) - start : start == T(-1) ? T(0) : T(1) - start));
+				}
+
+				// Behind the origin, and beyond the accepted distance.
+				T distance = std::numeric_limits<T>::infinity();
+				MATH_CHECK(context, !intersect(Ray<3, T>(Point<3, T>(T(3), T(0), T(0)), x), box, distance) && distance == std::numeric_limits<T>::infinity());
+				distance = T(1.5);
+				MATH_CHECK(context, !intersect(Ray<3, T>(Point<3, T>(T(-3), T(0), T(0)), x), box, distance) && distance == T(1.5));
+			}
+
+			// Packets give every lane what the single ray gives, for packet sizes that are and are not pack widths.
+			template<typename T, size_t N>
+			void ray_packet(Context& context)
+			{
+				const std::vector<Point<3, T>> origins = random_tuples<3, T, Point>(N * 16, 28, T(-10), T(10));
+				const std::vector<Vector<3, T>> directions = random_tuples<3, T, Vector>(N * 16, 29, T(-1), T(1));
+				const Sphere<3, T> sphere(Point<3, T>(T(1), T(2), T(0)), T(4));
+				const Triangle<T> triangle(Point<3, T>(T(-5), T(-5), T(0)), Point<3, T>(T(5), T(-5), T(1)), Point<3, T>(T(0), T(5), T(-1)));
+				const Plane<T> plane(Vector<3, T>(T(0), T(1), T(0)), T(1));
+
+				for (size_t first = 0; first < origins.size(); first += N)
+				{
+					std::vector<Ray<3, T>> rays(N);
+					for (size_t lane = 0; lane < N; ++lane)
+						rays[lane] = Ray<3, T>(origins[first + lane], directions[first + lane]);
+					const RayPacket<3, T, N> packet{ std::span<const Ray<3, T>>(rays) };
+
+					T distance[N];
+					std::fill(distance, distance + N, std::numeric_limits<T>::infinity());
+					const uint32_t sphere_hits = intersect(packet, sphere, distance);
+					const uint32_t triangle_hits = intersect(packet, triangle, distance);
+					const uint32_t plane_hits = intersect(packet, plane, distance);
+
+					bool same = true;
+					for (size_t lane = 0; lane < N; ++lane)
+					{
+						T nearest = std::numeric_limits<T>::infinity();
+						const bool sphere_hit = intersect(rays[lane], sphere, nearest);
+						const bool triangle_hit = intersect(rays[lane], triangle, nearest);
+						const bool plane_hit = intersect(rays[lane], plane, nearest);
+						same = same && sphere_hit == ((sphere_hits >> lane) & 1) && triangle_hit == ((triangle_hits >> lane) & 1) && plane_hit == ((plane_hits >> lane) & 1);
+						same = same && (nearest == distance[lane] || near(nearest, distance[lane], 64 * std::numeric_limits<T>::epsilon()));
+					}
+					MATH_CHECK(context, same);
+				}
+			}
+		}
+
+		void register_spatial_tests(Registry& registry)
+		{
+			registry.add("matrix/multiply/4/float", &matrix_multiply<4, float>);
+			registry.add("matrix/multiply/8/double", &matrix_multiply<8, double>);
+			registry.add("matrix/multiply/70/float", &matrix_multiply<70, float>);
+			registry.add("matrix/transform/4/float", &matrix_transform<4, float>);
+			registry.add("matrix/transform/3/double", &matrix_transform<3, double>);
+			registry.add("matrix/transform/5/float", &matrix_transform<5, float>);
+			registry.add("quaternion/rotate/float", &quaternion_rotate<float>);
+			registry.add("quaternion/rotate/double", &quaternion_rotate<double>);
+			registry.add("kd_tree/3/float", &kd_tree<3, float>);
+			registry.add("kd_tree/2/int", &kd_tree<2, int>);
+			registry.add("aabb/batch/3/float", &aabb_batch<3, float>);
+			registry.add("aabb/batch/2/double", &aabb_batch<2, double>);
+			registry.add("ray/box/float", &ray_box<float>);
+			registry.add("ray/box/double", &ray_box<double>);
+			registry.add("ray/packet/float/8", &ray_packet<float, 8>);
+			registry.add("ray/packet/double/4", &ray_packet<double, 4>);
+			registry.add("ray/packet/float/16", &ray_packet<float, 16>);
+			registry.add("ray/packet/float/12", &ray_packet<float, 12>);
+			registry.add("ray/packet/double/7", &ray_packet<double, 7>);
+			registry.add("ray/packet/float/31", &ray_packet<float, 31>);
+		}
+	}
+}
@@ -0,0 +1,275 @@
+#include "Test.h"
+#include "Fixed.h"
+#include "Half.h"
+#include "Octahedral.h"
+#include "Point.h"
+#include "Text.h"
+#include "TupleFile.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+namespace math
+{
+	namespace test
+	{
+		namespace
+		{
+			template<size_t D, typename T, template<size_t, typename> typename U>
+			std::vector<U<D, T>> random_tuples(size_t count, uint64_t seed, const T& low, const T& high)
+			{
+				Random random(seed);
+				std::vector<U<D, T>> tuples(count);
+				for (U<D, T>& tuple : tuples)
+					[&]<size_t... C>(std::index_sequence<C...>) { ((tuple.template get_component<C>() = random.uniform(low, high)), ...); }(std::make_index_sequence<D>());
+				return tuples;
+			}
+
+			// A file in the temporary directory, removed again when the test is done with it.
+			class TemporaryFile
+			{
+			public:
+				explicit TemporaryFile(const char* name) : path(std::filesystem::temp_directory_path() / name) {}
+				~TemporaryFile()
+				{
+					std::error_code error;
+					std::filesystem::remove(path, error);
+				}
+
+				std::filesystem::path path;
+			};
+
+			// Every half converts to float and back to itself, and the bulk kernels round like the scalar conversion.
+			void half_round_trip(Context& context)
+			{
+				bool same = true;
+				std::vector<Half> halves;
+				for (uint32_t bits = 0; bits < 0x10000; ++bits)
+				{
+					const Half half = Half::from_bits(static_cast<uint16_t>(bits));
+					const float value = static_cast<float>(half);
+					if (value == value)
+					{
+						same = same && Half(value).to_bits() == half.to_bits();
+						halves.push_back(half);
+					}
+				}
+				MATH_CHECK(context, same);
+
+				std::vector<float> unpacked(halves.size());
+				std::vector<Half> packed(halves.size());
+				unpack(std::span<const Half>(halves), std::span<float>(unpacked));
+				pack(std::span<const float>(unpacked), std::span<Half>(packed));
+				same = true;
+				for (size_t i = 0; i < halves.size(); ++i)
+					same = same && unpacked[i] == static_cast<float>(halves[i]) && packed[i].to_bits() == halves[i].to_bits();
+				MATH_CHECK(context, same);
+
+				// Random floats, including ones that round to subnormals and overflow: the bulk kernels against Half(float).
+				Random random(30);
+				std::vector<float> values(4099);
+				for (float& value : values)
+					value = std::bit_cast<float>(static_cast<uint32_t>(random.next()) & 0xC7FFFFFFu);
+				packed.resize(values.size());
+				pack(std::span<const float>(values), std::span<Half>(packed));
+				same = true;
+				for (size_t i = 0; i < values.size(); ++i)
+					same = same && (values[i] != values[i] || packed[i].to_bits() == Half(values[i]).to_bits());
+				MATH_CHECK(context, same);
+			}
+
+			// Doubles round to half once: just either side of every tie between neighbouring halves, on the tie itself, and
+			// every float, which must give what Half(float) gives.
+			void half_from_double(Context& context)
+			{
+				MATH_CHECK(context, Half(1 + 0x1p-11 + 0x1p-40).to_bits() == Half(1 + 0x1p-10).to_bits());
+				bool same = true;
+				for (uint32_t bits = 0; bits < 0x7BFF; ++bits)
+				{
+					const double low = static_cast<double>(Half::from_bits(static_cast<uint16_t>(bits)));
+					const double high = static_cast<double>(Half::from_bits(static_cast<uint16_t>(bits + 1)));
+					const double tie = (low + high) / 2, nudge = (high - low) * 0x1p-30;
+					const uint16_t even = static_cast<uint16_t>(bits & 1 ? bits + 1 : bits);
+					same = same && Half(tie - nudge).to_bits() == bits && Half(tie + nudge).to_bits() == bits + 1 && Half(tie).to_bits() == even;
+					same = same && Half(-(tie + nudge)).to_bits() == ((bits + 1) | 0x8000);
+				}
+				MATH_CHECK(context, same);
+				MATH_CHECK(context, Half(65519.99).to_bits() == 0x7BFF && Half(65520.0).to_bits() == 0x7C00 && Half(-1e300).to_bits() == 0xFC00);
+				MATH_CHECK(context, Half(0x1p-25).to_bits() == 0 && Half(0x1p-25 + 0x1p-60).to_bits() == 1 && Half(-0.0).to_bits() == 0x8000);
+				MATH_CHECK(context, Half(std::numeric_limits<double>::quiet_NaN()) != Half(std::numeric_limits<double>::quiet_NaN()));
+
+				Random random(36);
+				same = true;
+				for (size_t i = 0; i < 100000; ++i)
+				{
+					const float value = std::bit_cast<float>(static_cast<uint32_t>(random.next()) & 0xC7FFFFFFu);
+					same = same && (value != value || Half(static_cast<double>(value)).to_bits() == Half(value).to_bits());
+				}
+				MATH_CHECK(context, same);
+			}
+
+			// Fixed point holds every value on its grid exactly and rounds the rest to within half a step.
+			void fixed_round_trip(Context& context)
+			{
+				using F = Fixed<8, 8>;
+				bool same = true;
+				for (int raw = -32768; raw < 32768; ++raw)
+				{
+					const F fixed = F::from_raw(static_cast<int16_t>(raw));
+					same = same && F(static_cast<float>(fixed)).raw() == fixed.raw();
+				}
+				MATH_CHECK(context, same);
+
+				Random random(31);
+				std::vector<float> values(1000), unpacked(values.size());
+				std::vector<F> packed(values.size());
+				for (float& value : values)
+					value = random.uniform(-127.0f, 127.0f);
+				pack(std::span<const float>(values), std::span<F>(packed));
+				unpack(std::span<const F>(packed), std::span<float>(unpacked));
+				same = true;
+				for (size_t i = 0; i < values.size(); ++i)
+					same = same && packed[i].raw() == F(values[i]).raw() && std::fabs(unpacked[i] - values[i]) <= 0.5f / 256;
+				MATH_CHECK(context, same);
+
+				// Numbers too large for a 64-bit intermediate saturate and NaN gives zero, in bulk as one by one.
+				const float extremes[] = { 1e30f, -1e30f, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() };
+				F extremes_packed[4];
+				pack(std::span<const float>(extremes), std::span<F>(extremes_packed));
+				MATH_CHECK(context, extremes_packed[0].raw() == INT16_MAX && extremes_packed[1].raw() == INT16_MIN && extremes_packed[2].raw() == INT16_MAX && extremes_packed[3].raw() == 0);
+				MATH_CHECK(context, F(1e300).raw() == INT16_MAX && F(-std::numeric_limits<double>::infinity()).raw() == INT16_MIN && F(200.0f) == F(-56.0f));
+			}
+
+			// Decoded normals stay within the angle of the code grid, and the batched encoding matches the single one.
+			template<size_t Bits>
+			void octahedral_round_trip(Context& context)
+			{
+				const std::vector<Vector<3, float>> normals = random_tuples<3, float, Vector>(2001, 32, -1.0f, 1.0f);
+				std::vector<Octahedral<Bits>> encoded(normals.size());
+				std::vector<Vector<3, float>> decoded(normals.size());
+				encode(std::span<const Vector<3, float>>(normals), std::span<Octahedral<Bits>>(encoded));
+				decode(std::span<const Octahedral<Bits>>(encoded), std::span<Vector<3, float>>(decoded));
+
+				// The grid step is 2 / scale across a face, which the unfolding stretches by at most about 2.
+				const float tolerance = 4.0f / Octahedral<Bits>::scale;
+				bool same = true;
+				for (size_t i = 0; i < normals.size(); ++i)
+				{
+					const Vector<3, float> normal = normals[i].normalised();
+					// Contraction may differ between the pack and scalar code, which can flip a near tie to the neighbouring grid point.
+					const Octahedral<Bits> single = Octahedral<Bits>::encode(normals[i]);
+					same = same && std::abs(encoded[i].u - single.u) <= 1 && std::abs(encoded[i].v - single.v) <= 1;
+					same = same && (decoded[i] - encoded[i].decode()).length() <= 1e-6f;
+					same = same && (decoded[i] - normal).length() <= tolerance && std::fabs(decoded[i].length() - 1) <= 1e-6f;
+				}
+				MATH_CHECK(context, same);
+			}
+
+			// Tuples written in either layout read back unchanged.
+			template<size_t D, typename T>
+			void tuple_file_round_trip(Context& context)
+			{
+				const std::vector<Point<D, T>> points = random_tuples<D, T, Point>(3001, 33, T(-100), T(100));
+				const TemporaryFile aos("math_tests_aos.mtup"), soa("math_tests_soa.mtup");
+				const TemporaryFile batched("math_tests_batched.mtup");
+				MATH_CHECK(context, write_tuple_file(aos.path, points));
+				MATH_CHECK(context, write_tuple_file(soa.path, CoordinatesSoA<D, T>(points.begin(), points.end())));
+				{
+					TupleFileWriter<D, T> writer(batched.path);
+					const std::vector<Point<D, T>> head(points.begin(), points.begin() + 1000);
+					MATH_CHECK(context, writer.write(head) && writer.write(std::span<const Point<D, T>>(points).subspan(1000)) && writer.close());
+				}
+
+				const TupleFileReader<D, T> aos_reader(aos.path), soa_reader(soa.path), batched_reader(batched.path);
+				MATH_CHECK(context, aos_reader.is_open() && aos_reader.size() == points.size() && aos_reader.layout() == TupleLayout::aos);
+				MATH_CHECK(context, soa_reader.is_open() && soa_reader.size() == points.size() && soa_reader.layout() == TupleLayout::soa);
+				MATH_CHECK(context, batched_reader.is_open() && batched_reader.size() == points.size());
+				if (!aos_reader.is_open() || !soa_reader.is_open() || !batched_reader.is_open())
+					return;
+
+				// AoS records are packed, whatever the padding of the tuple type.
+				MATH_CHECK(context, aos_reader.file_header().stride == D * sizeof(T) && std::filesystem::file_size(aos.path) == TupleFileHeader::size + points.size() * D * sizeof(T));
+				bool same = true;
+				for (size_t i = 0; same && i < points.size(); ++i)
+					same = aos_reader.template tuple<Point<D, T>>(i) == points[i] && batched_reader.template tuple<Point<D, T>>(i) == points[i]
+						&& [&]<size_t... C>(std::index_sequence<C...>) { return ((soa_reader.data(C)[i] == points[i].template get_component<C>()) && ...); }(std::make_index_sequence<D>());
+				if constexpr (sizeof(Point<D, T>) == D * sizeof(T))
+				{
+					const std::span<const Point<D, T>> tuples = aos_reader.template tuples<Point<D, T>>();
+					same = same && tuples.size() == points.size() && std::equal(tuples.begin(), tuples.end(), points.begin());
+				}
+				MATH_CHECK(context, same);
+
+				// A reader for another type does not open the file.
+				MATH_CHECK(context, !TupleFileReader<D, std::conditional_t<std::is_same_v<T, float>, double, float>>(aos.path).is_open());
+
+				// An SoA write past the count fails the file rather than running into the next column.
+				const TemporaryFile overflow("math_tests_overflow.mtup");
+				TupleFileWriter<D, T> writer(overflow.path, TupleLayout::soa, 10);
+				const std::span<const Point<D, T>> span(points);
+				MATH_CHECK(context, writer.write(span.first(8)) && !writer.write(span.subspan(8, 5)) && !writer.write(span.subspan(8, 2)));
+				MATH_CHECK(context, writer.size() == 8 && !writer.close());
+			}
+
+			// Formatted tuples and angles parse back to the same bits.
+			template<typename T>
+			void text_round_trip(Context& context)
+			{
+				const std::vector<Vector<3, T>> vectors = random_tuples<3, T, Vector>(1000, 34, T(-1e6), T(1e6));
+				bool same = true;
+				for (const Vector<3, T>& vector : vectors)
+				{
+					char text[128];
+					const std::to_chars_result written = to_chars(text, text + sizeof(text), vector);
+					Vector<3, T> parsed;
+					const std::from_chars_result read = from_chars(text, written.ptr, parsed);
+					same = same && written.ec == std::errc() && read.ec == std::errc() && read.ptr == written.ptr && parsed == vector;
+
+					const Degrees<T> angle(vector.x);
+					const std::to_chars_result angle_written = to_chars(text, text + sizeof(text), angle);
+					Degrees<T> angle_parsed;
+					const std::from_chars_result angle_read = from_chars(text, angle_written.ptr, angle_parsed);
+					same = same && angle_read.ec == std::errc() && angle_parsed.native() == angle.native();
+				}
+				MATH_CHECK(context, same);
+
+				// The fast path for short decimals must give what std::from_chars gives for each component.
+				Random random(35);
+				same = true;
+				for (size_t i = 0; i < 30000; ++i)
+				{
+					char text[96];
+					int ends[3], length = 0;
+					for (int c = 0; c < 3; ++c)
+					{
+						length += std::snprintf(text + length, sizeof(text) - length, "%s%.*f", c ? " " : "", static_cast<int>(random.next() % 9), random.uniform(-1e5, 1e5));
+						ends[c] = length;
+					}
+					Vector<3, T> parsed;
+					from_chars(text, text + length, parsed);
+					T expected[3];
+					for (int c = 0; c < 3; ++c)
+						std::from_chars(text + (c ? ends[c - 1] + 1 : 0), text + ends[c], expected[c]);
+					same = same && parsed == Vector<3, T>(expected[0], expected[1], expected[2]);
+				}
+				MATH_CHECK(context, same);
+			}
+		}
+
+		void register_storage_tests(Registry& registry)
+		{
+			registry.add("half/round_trip", &half_round_trip);
+			registry.add("half/from_double", &half_from_double);
+			registry.add("fixed/round_trip", &fixed_round_trip);
+			registry.add("octahedral/round_trip/16", &octahedral_round_trip<8>);
+			registry.add("octahedral/round_trip/32", &octahedral_round_trip<16>);
+			registry.add("tuple_file/round_trip/3/float", &tuple_file_round_trip<3, float>);
+			registry.add("tuple_file/round_trip/4/double", &tuple_file_round_trip<4, double>);
+			registry.add("tuple_file/round_trip/2/int", &tuple_file_round_trip<2, int>);
+			registry.add("text/round_trip/float", &text_round_trip<float>);
+			registry.add("text/round_trip/double", &text_round_trip<double>);
+		}
+	}
+}
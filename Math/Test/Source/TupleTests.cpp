@@ -0,0 +1,260 @@
+#include "Test.h"
+#include "Bulk.h"
+#include "CoordinatesSoA.h"
+#include "DynamicVector.h"
+#include "Expression.h"
+#include "Point.h"
+#include "Vector.h"
+#include <vector>
+
+namespace math
+{
+	namespace test
+	{
+		namespace
+		{
+			template<size_t D, typename T, template<size_t, typename> typename U = Vector>
+			std::vector<U<D, T>> random_tuples(size_t count, uint64_t seed, const T& low = T(-10), const T& high = T(10))
+			{
+				Random random(seed);
+				std::vector<U<D, T>> tuples(count);
+				for (U<D, T>& tuple : tuples)
+					[&]<size_t... C>(std::index_sequence<C...>) { ((tuple.template get_component<C>() = random.uniform(low, high)), ...); }(std::make_index_sequence<D>());
+				return tuples;
+			}
+
+			template<Tuple U>
+			bool tuples_near(const U& a, const U& b, const typename U::value_type& tolerance)
+			{
+				return [&]<size_t... C>(std::index_sequence<C...>) { return (near(a.template get_component<C>(), b.template get_component<C>(), tolerance) && ...); }(std::make_index_sequence<U::dimensions>());
+			}
+
+			// The whole-array SoA kernels against the same operations tuple by tuple.
+			template<size_t D, typename T>
+			void soa_operations(Context& context)
+			{
+				const std::vector<Vector<D, T>> a = random_tuples<D, T>(1000, 1);
+				const std::vector<Vector<D, T>> b = random_tuples<D, T>(1000, 2);
+				const CoordinatesSoA<D, T> soa_a(a.begin(), a.end());
+				const CoordinatesSoA<D, T> soa_b(b.begin(), b.end());
+
+				const CoordinatesSoA<D, T> sum = soa_a + soa_b;
+				const CoordinatesSoA<D, T> scaled = soa_a * T(3);
+				std::vector<T> distances(a.size());
+				distance_sq(soa_a, soa_b, std::span<T>(distances));
+				CoordinatesSoA<D, T> normalised = soa_a;
+				normalise(normalised);
+
+				bool same = sum.size() == a.size();
+				for (size_t i = 0; same && i < a.size(); ++i)
+					same = Vector<D, T>(sum[i].load()) == a[i] + b[i] && Vector<D, T>(scaled[i].load()) == a[i] * T(3)
+						&& near(distances[i], distance_sq(a[i], b[i]), 4 * std::numeric_limits<T>::epsilon())
+						&& tuples_near(Vector<D, T>(normalised[i].load()), Vector<D, T>(a[i].normalised()), 4 * std::numeric_limits<T>::epsilon());
+				MATH_CHECK(context, same);
+			}
+
+			// Expressions evaluate in one pass to what the eager operators give.
+			template<typename T>
+			void expressions(Context& context)
+			{
+				const std::vector<Vector<3, T>> positions = random_tuples<3, T>(100, 3);
+				const std::vector<Vector<3, T>> velocities = random_tuples<3, T>(100, 4);
+				const T dt = T(0.25);
+
+				std::vector<Vector<3, T>> lazy_out(positions.size());
+				assign(std::span<Vector<3, T>>(lazy_out), lazy(std::span<const Vector<3, T>>(positions)) + lazy(std::span<const Vector<3, T>>(velocities)) * dt);
+				CoordinatesSoA<3, T> soa(positions.begin(), positions.end());
+				const CoordinatesSoA<3, T> soa_velocities(velocities.begin(), velocities.end());
+				assign(soa, lazy(soa) + lazy(soa_velocities) * dt);
+
+				bool same = true;
+				for (size_t i = 0; i < positions.size(); ++i)
+				{
+					const Vector<3, T> eager = positions[i] + velocities[i] * dt;
+					same = same && lazy_out[i] == eager && Vector<3, T>(soa[i].load()) == eager;
+				}
+				MATH_CHECK(context, same);
+
+				const Vector<3, T> p = positions[0];
+				const Vector<3, T> v = velocities[0];
+				MATH_CHECK(context, evaluate<Vector<3, T>>(lazy(p) - lazy(v) / T(2)) == p - v / T(2));
+
+				// Single tuples are held by value, so the expression outlives its operands and converts to any tuple of its shape.
+				const auto deferred = [&]
+				{
+					const Vector<3, T> position = positions[1], velocity = velocities[1];
+					return lazy(position) + velocity * dt;
+				}();
+				const Vector<3, T> converted = deferred;
+				const Point<3, T> point = deferred;
+				MATH_CHECK(context, converted == positions[1] + velocities[1] * dt && Vector<3, T>(point) == converted);
+			}
+
+			// The span and SoA forms of fma and axpy against the single-tuple forms.
+			template<size_t D, typename T>
+			void fused_operations(Context& context)
+			{
+				const std::vector<Vector<D, T>> a = random_tuples<D, T>(257, 5);
+				const std::vector<Vector<D, T>> b = random_tuples<D, T>(257, 6);
+				std::vector<Vector<D, T>> y = random_tuples<D, T>(257, 7);
+				CoordinatesSoA<D, T> soa_y(y.begin(), y.end());
+				const CoordinatesSoA<D, T> soa_a(a.begin(), a.end());
+
+				axpy(T(1.5), soa_a, soa_y);
+				bool same = true;
+				for (size_t i = 0; i < a.size(); ++i)
+				{
+					const Vector<D, T> expected = fma(a[i], T(1.5), y[i]);
+					same = same && tuples_near(Vector<D, T>(soa_y[i].load()), expected, std::numeric_limits<T>::epsilon());
+					const Vector<D, T> fused = fma(a[i], b[i], y[i]);
+					same = same && [&]<size_t... C>(std::index_sequence<C...>)
+					{
+						return (near(fused.template get_component<C>(), a[i].template get_component<C>() * b[i].template get_component<C>() + y[i].template get_component<C>(), 64 * std::numeric_limits<T>::epsilon()) && ...);
+					}(std::make_index_sequence<D>());
+				}
+				MATH_CHECK(context, same);
+			}
+
+			// The identities that define the Vector<3, T> operations, and the span forms against the single ones.
+			template<typename T>
+			void vector3_operations(Context& context)
+			{
+				const std::vector<Vector<3, T>> a = random_tuples<3, T>(256, 8, T(-1), T(1));
+				const std::vector<Vector<3, T>> b = random_tuples<3, T>(256, 9, T(-1), T(1));
+				std::vector<Vector<3, T>> crosses(a.size()), tangents(a.size()), bitangents(a.size()), reflections(a.size());
+				cross(std::span<const Vector<3, T>>(a), std::span<const Vector<3, T>>(b), std::span<Vector<3, T>>(crosses));
+				std::vector<Vector<3, T>> normals(a.size());
+				for (size_t i = 0; i < a.size(); ++i)
+					normals[i] = b[i].normalised();
+				orthonormal_basis(std::span<const Vector<3, T>>(normals), std::span<Vector<3, T>>(tangents), std::span<Vector<3, T>>(bitangents));
+				reflect(std::span<const Vector<3, T>>(a), std::span<const Vector<3, T>>(normals), std::span<Vector<3, T>>(reflections));
+
+				const T tolerance = 16 * std::numeric_limits<T>::epsilon();
+				bool same = true;
+				for (size_t i = 0; i < a.size(); ++i)
+				{
+					same = same && tuples_near(crosses[i], cross(a[i], b[i]), tolerance);
+					same = same && near(dot(crosses[i], a[i]), T(0), tolerance) && near(dot(crosses[i], b[i]), T(0), tolerance);
+					same = same && tuples_near(project(a[i], b[i]) + reject(a[i], b[i]), a[i], tolerance);
+					same = same && tuples_near(reflect(reflections[i], normals[i]), a[i], tolerance);
+					same = same && near(dot(tangents[i], normals[i]), T(0), tolerance) && near(dot(bitangents[i], normals[i]), T(0), tolerance)
+						&& near(dot(tangents[i], bitangents[i]), T(0), tolerance) && near(tangents[i].length(), T(1), tolerance)
+						&& tuples_near(cross(tangents[i], bitangents[i]), normals[i], tolerance);
+				}
+				MATH_CHECK(context, same);
+			}
+
+			// The fused forms round once per component where the hardware fuses, so they stay within rounding of the plain
+			// ones, and agree with them exactly where every product and sum is representable.
+			template<size_t D, typename T>
+			void fused_dot_products(Context& context)
+			{
+				const std::vector<Vector<D, T>> a = random_tuples<D, T>(256, 15, T(-1), T(1));
+				const std::vector<Vector<D, T>> b = random_tuples<D, T>(256, 16, T(-1), T(1));
+				const T tolerance = 2 * D * std::numeric_limits<T>::epsilon();
+				bool same = true;
+				for (size_t i = 0; i < a.size(); ++i)
+				{
+					same = same && near(fused_dot(a[i], b[i]), dot(a[i], b[i]), tolerance);
+					same = same && near(a[i].fused_magnitude_sq(), a[i].magnitude_sq(), tolerance);
+					Vector<D, T> whole_a, whole_b;
+					[&]<size_t... C>(std::index_sequence<C...>)
+					{
+						((whole_a.template get_component<C>() = std::round(a[i].template get_component<C>() * 64)), ...);
+						((whole_b.template get_component<C>() = std::round(b[i].template get_component<C>() * 64)), ...);
+					}(std::make_index_sequence<D>());
+					same = same && fused_dot(whole_a, whole_b) == dot(whole_a, whole_b) && whole_a.fused_magnitude_sq() == whole_a.magnitude_sq();
+				}
+				MATH_CHECK(context, same);
+			}
+
+			// DynamicVector against the same operations in long double, at sizes around every pack width.
+			template<typename T>
+			void dynamic_vector(Context& context)
+			{
+				Random random(10);
+				for (size_t size : { 1, 3, 4, 7, 8, 15, 16, 17, 33, 100, 1000 })
+				{
+					DynamicVector<T> a(size), b(size);
+					long double dot_exact = 0, distance_exact = 0;
+					for (size_t i = 0; i < size; ++i)
+					{
+						a[i] = random.uniform(T(-1), T(1));
+						b[i] = random.uniform(T(-1), T(1));
+						dot_exact += static_cast<long double>(a[i]) * b[i];
+						distance_exact += (static_cast<long double>(a[i]) - b[i]) * (static_cast<long double>(a[i]) - b[i]);
+					}
+					const T tolerance = static_cast<T>(size) * std::numeric_limits<T>::epsilon();
+					MATH_CHECK(context, std::fabs(dot(a, b) - dot_exact) <= tolerance);
+					MATH_CHECK(context, std::fabs(distance_sq(a, b) - distance_exact) <= tolerance * 4);
+
+					const DynamicVector<T> sum = a + b;
+					bool same = true;
+					for (size_t i = 0; i < size; ++i)
+						same = same && sum[i] == a[i] + b[i];
+					MATH_CHECK(context, same);
+
+					// Rows of size components, queried with b: the row kernels against one dot per row.
+					std::vector<T> rows(size * 5), out(5);
+					for (T& value : rows)
+						value = random.uniform(T(-1), T(1));
+					dot_rows(std::span<const T>(rows), b, std::span<T>(out));
+					for (size_t row = 0; row < 5; ++row)
+						MATH_CHECK(context, std::fabs(out[row] - dot(DynamicVector<T>(std::span<const T>(rows.data() + row * size, size)), b)) <= tolerance);
+				}
+			}
+
+			// Above the unrolled sizes distance_sq accumulates as magnitude_sq does, unfused, whatever the target.
+			template<size_t D, typename T>
+			void large_distance_sq(Context& context)
+			{
+				const std::vector<Point<D, T>> a = random_tuples<D, T, Point>(10000, 12);
+				const std::vector<Point<D, T>> b = random_tuples<D, T, Point>(10000, 13);
+				bool same = true;
+				for (size_t i = 0; same && i < a.size(); ++i)
+					same = distance_sq(a[i], b[i]) == Vector<D, T>(a[i], b[i]).magnitude_sq();
+				MATH_CHECK(context, same);
+			}
+
+			// Bulk reductions give the same result on every executor and agree with a plain loop.
+			void bulk_reductions(Context& context)
+			{
+				const std::vector<Vector<3, double>> vectors = random_tuples<3, double>(100000, 11);
+				Vector<3, double> sum, minimum(std::numeric_limits<double>::max()), maximum(std::numeric_limits<double>::lowest());
+				for (const Vector<3, double>& vector : vectors)
+				{
+					sum += vector;
+					minimum = Vector<3, double>(std::fmin(minimum.x, vector.x), std::fmin(minimum.y, vector.y), std::fmin(minimum.z, vector.z));
+					maximum = Vector<3, double>(std::fmax(maximum.x, vector.x), std::fmax(maximum.y, vector.y), std::fmax(maximum.z, vector.z));
+				}
+				const std::span<const Vector<3, double>> span(vectors);
+				MATH_CHECK(context, bulk::sum(span, bulk::Parallel()) == bulk::sum(span));
+				MATH_CHECK(context, tuples_near(bulk::sum(span), sum, 1e-12));
+				MATH_CHECK(context, tuples_near(bulk::sum<Accumulation::compensated>(span, bulk::Parallel()), sum, 1e-12));
+				MATH_CHECK(context, bulk::min(span, bulk::Parallel()) == minimum);
+				MATH_CHECK(context, bulk::max(span, bulk::Parallel()) == maximum);
+			}
+		}
+
+		void register_tuple_tests(Registry& registry)
+		{
+			registry.add("soa/operations/3/float", &soa_operations<3, float>);
+			registry.add("soa/operations/4/double", &soa_operations<4, double>);
+			registry.add("soa/operations/17/float", &soa_operations<17, float>);
+			registry.add("expression/assign/float", &expressions<float>);
+			registry.add("expression/assign/double", &expressions<double>);
+			registry.add("fma/span/3/float", &fused_operations<3, float>);
+			registry.add("fma/span/8/double", &fused_operations<8, double>);
+			registry.add("vector3/operations/float", &vector3_operations<float>);
+			registry.add("vector3/operations/double", &vector3_operations<double>);
+			registry.add("vector/fused_dot/3/float", &fused_dot_products<3, float>);
+			registry.add("vector/fused_dot/4/double", &fused_dot_products<4, double>);
+			registry.add("vector/fused_dot/19/float", &fused_dot_products<19, float>);
+			registry.add("dynamic_vector/float", &dynamic_vector<float>);
+			registry.add("dynamic_vector/double", &dynamic_vector<double>);
+			registry.add("vector/distance_sq/17/float", &large_distance_sq<17, float>);
+			registry.add("vector/distance_sq/17/double", &large_distance_sq<17, double>);
+			registry.add("bulk/reductions", &bulk_reductions);
+		}
+	}
+}
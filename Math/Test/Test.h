@@ -0,0 +1,167 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Records a failed check with its expression and location; the test carries on with the next check.
+#define MATH_CHECK(context, ...) (context).check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+namespace math
+{
+	namespace test
+	{
+		// What a test function sees: every check goes through it, and the first few failures are reported on stderr.
+		class Context
+		{
+		public:
+			explicit Context(const std::string& name) : name(name), failed(0) {}
+
+			bool check(bool passed, const char* expression, const char* file, int line)
+			{
+				if (!passed && report())
+					std::fprintf(stderr, "%s:%d: %s: check failed: %s\n", file, line, name.c_str(), expression);
+				return passed;
+			}
+			// A failure explained by the test itself, such as the worst input of an accuracy sweep.
+			template<typename... A>
+			void fail(const char* format, const A&... arguments)
+			{
+				if (!report())
+					return;
+				std::fprintf(stderr, "%s: ", name.c_str());
+				if constexpr (sizeof...(A) == 0)
+					std::fputs(format, stderr);
+				else
+					std::fprintf(stderr, format, arguments...);
+				std::fputc('\n', stderr);
+			}
+
+			size_t failures() const { return failed; }
+
+		private:
+			static constexpr size_t reported_failures = 10;
+
+			bool report()
+			{
+				return ++failed <= reported_failures;
+			}
+
+			std::string name;
+			size_t failed;
+		};
+
+		using Function = void (*)(Context&);
+
+		// The error of computed against the exact value in units in the last place of T at exact.
+		// Below the normal range the unit is that of the smallest normal, as for subnormal results.
+		template<typename T>
+		static double ulp_error(const T& computed, long double exact)
+		{
+			int exponent = 0;
+			std::frexp(exact, &exponent);
+			if (exponent < std::numeric_limits<T>::min_exponent)
+				exponent = std::numeric_limits<T>::min_exponent;
+			const long double ulp = std::ldexp(1.0L, exponent - std::numeric_limits<T>::digits);
+			return static_cast<double>(std::fabs(static_cast<long double>(computed) - exact) / ulp);
+		}
+
+		// Equal to within tolerance relative to the larger magnitude, or absolutely below 1.
+		template<typename T>
+		static bool near(const T& a, const T& b, const T& tolerance)
+		{
+			const T scale = std::fabs(a) < std::fabs(b) ? std::fabs(b) : std::fabs(a);
+			return std::fabs(a - b) <= tolerance * (scale < 1 ? T(1) : scale);
+		}
+
+		// A small deterministic generator, so failures reproduce on every platform.
+		class Random
+		{
+		public:
+			explicit Random(uint64_t seed = 0x9E3779B97F4A7C15ull) : state(seed) {}
+
+			uint64_t next()
+			{
+				state += 0x9E3779B97F4A7C15ull;
+				uint64_t z = state;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				return z ^ (z >> 31);
+			}
+			// Uniform in [low, high).
+			template<typename T>
+			T uniform(const T& low, const T& high)
+			{
+				if constexpr (std::is_floating_point_v<T>)
+					return low + (high - low) * static_cast<T>(static_cast<double>(next() >> 11) * 0x1.0p-53);
+				else
+					return static_cast<T>(low + static_cast<T>(next() % static_cast<uint64_t>(high - low)));
+			}
+
+		private:
+			uint64_t state;
+		};
+
+		// Runs every registered test and reports each one on stdout; the exit code is non-zero when any check failed.
+		// --filter=text runs only the tests whose name contains text.
+		class Registry
+		{
+		public:
+			void add(std::string name, Function function) { cases.push_back({ std::move(name), function }); }
+
+			int run(int argc, char** argv) const
+			{
+				std::string_view filter;
+				for (int i = 1; i < argc; ++i)
+				{
+					const std::string_view argument = argv[i];
+					if (argument.starts_with("--filter="))
+						filter = argument.substr(9);
+					else
+					{
+						std::fprintf(stderr, "usage: %s [--filter=text]\n", argv[0]);
+						return 1;
+					}
+				}
+
+				size_t run = 0, failed = 0;
+				for (const Case& test : cases)
+				{
+					if (test.name.find(filter) == std::string::npos)
+						continue;
+					Context context(test.name);
+					test.function(context);
+					++run;
+					if (context.failures() != 0)
+						++failed;
+					std::printf("%-6s %s", context.failures() == 0 ? "ok" : "FAILED", test.name.c_str());
+					if (context.failures() != 0)
+						std::printf(" (%zu failed checks)", context.failures());
+					std::printf("\n");
+					std::fflush(stdout);
+				}
+				std::printf("%zu of %zu tests passed\n", run - failed, run);
+				return failed == 0 ? 0 : 1;
+			}
+
+		private:
+			struct Case
+			{
+				std::string name;
+				Function function;
+			};
+
+			std::vector<Case> cases;
+		};
+
+		void register_tuple_tests(Registry& registry);
+		void register_angle_tests(Registry& registry);
+		void register_spatial_tests(Registry& registry);
+		void register_storage_tests(Registry& registry);
+		void register_accuracy_tests(Registry& registry);
+	}
+}